@@ -0,0 +1,205 @@
+#include "../../main/c/backend/domain-specific/Calculator.h"
+#include "../../main/c/backend/virtual-machine/Bytecode.h"
+#include "../../main/c/backend/virtual-machine/JustInTimeCompiler.h"
+#include "../../main/c/backend/virtual-machine/VirtualMachine.h"
+#include "../../main/c/support/logging/Logger.h"
+#include "../../main/c/support/memory/Arena.h"
+#include "../../main/c/support/type/CompilerState.h"
+#include "../../main/c/support/type/ModuleDestructor.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/**
+ * Compares the execution engines on the same program:
+ *
+ *	Flex-Bison-Engine-Benchmark <shape> <size> [repetitions]
+ *
+ * The shape is "balanced" (the size is the amount of levels) or "left-chain"
+ * (the size is the amount of terms), as in "WorkloadGenerator.c". The AST is
+ * built in memory, without the frontend, so only the engines are measured:
+ * the tree-walking calculator (see "CALCULATOR_ENGINE"), the virtual machine,
+ * and the just-in-time compiler. Every engine must compute the same value.
+ */
+
+/**
+ * The time taken to translate the program for an engine, and the best time
+ * of its executions.
+ */
+typedef struct {
+	double compilationSeconds;
+	double executionSeconds;
+	const char * name;
+	ComputationResult result;
+} EngineMeasurement;
+
+/**
+ * The constant of the k-th term of a program (see "WorkloadGenerator.c").
+ */
+static int _constant(const unsigned long k) {
+	return 1 + k % 9;
+}
+
+/**
+ * Builds the expression of a constant.
+ */
+static Expression * _createConstantExpression(Arena * arena, const int value) {
+	Constant * constant = allocateInArena(arena, sizeof(Constant));
+	constant->value = value;
+	Factor * factor = allocateInArena(arena, sizeof(Factor));
+	factor->constant = constant;
+	factor->type = CONSTANT;
+	Expression * expression = allocateInArena(arena, sizeof(Expression));
+	expression->factor = factor;
+	expression->type = FACTOR;
+	expression->size = 1;
+	return expression;
+}
+
+/**
+ * Builds the expression of a binary operation.
+ */
+static Expression * _createArithmeticExpression(Arena * arena, Expression * leftExpression, Expression * rightExpression, const ExpressionType type) {
+	Expression * expression = allocateInArena(arena, sizeof(Expression));
+	expression->leftExpression = leftExpression;
+	expression->rightExpression = rightExpression;
+	expression->type = type;
+	expression->size = 1 + leftExpression->size + rightExpression->size;
+	return expression;
+}
+
+/**
+ * A balanced tree with 2^levels constants, where each level alternates its
+ * operator between additions and multiplications.
+ */
+static Expression * _createBalancedTree(Arena * arena, const unsigned long levels, unsigned long * leaf) {
+	if (levels == 0) {
+		return _createConstantExpression(arena, _constant((*leaf)++));
+	}
+	Expression * leftExpression = _createBalancedTree(arena, levels - 1, leaf);
+	Expression * rightExpression = _createBalancedTree(arena, levels - 1, leaf);
+	return _createArithmeticExpression(arena, leftExpression, rightExpression, levels % 2 == 0 ? ADDITION : MULTIPLICATION);
+}
+
+/**
+ * A chain of terms, nested to the left (as the parser does), that alternates
+ * additions and subtractions.
+ */
+static Expression * _createLeftChain(Arena * arena, const unsigned long terms) {
+	Expression * expression = _createConstantExpression(arena, _constant(0));
+	for (unsigned long k = 1; k < terms; ++k) {
+		Expression * rightExpression = _createConstantExpression(arena, _constant(k));
+		expression = _createArithmeticExpression(arena, expression, rightExpression, k % 2 == 0 ? ADDITION : SUBTRACTION);
+	}
+	return expression;
+}
+
+/**
+ * The elapsed time since the specified instant, in seconds.
+ */
+static double _elapsedSince(const struct timespec * start) {
+	struct timespec end;
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	return (end.tv_sec - start->tv_sec) + (end.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+/**
+ * Keeps the best time of an execution of an engine.
+ */
+static void _keepBestExecution(EngineMeasurement * measurement, const struct timespec * start, const ComputationResult result) {
+	const double seconds = _elapsedSince(start);
+	if (measurement->executionSeconds < 0 || seconds < measurement->executionSeconds) {
+		measurement->executionSeconds = seconds;
+	}
+	measurement->result = result;
+}
+
+const int main(const int length, const char ** arguments) {
+	if (length < 3) {
+		fprintf(stderr, "Usage: %s <shape> <size> [repetitions]\n", arguments[0]);
+		return EXIT_FAILURE;
+	}
+	const char * shape = arguments[1];
+	const unsigned long size = strtoul(arguments[2], NULL, 10);
+	const unsigned long repetitions = length < 4 ? 5 : strtoul(arguments[3], NULL, 10);
+	ModuleDestructor moduleDestructors[] = {
+		initializeCalculatorModule(),
+		initializeBytecodeModule(),
+		initializeVirtualMachineModule(),
+		initializeJustInTimeCompilerModule()
+	};
+	CompilerState compilerState = {
+		.arena = createArena(1 << 20),
+		.abstractSyntaxtTree = NULL,
+		.constantFolder = NULL,
+		.flatSyntaxTree = NULL,
+		.importCache = NULL,
+		.nodeInterner = NULL,
+		.metrics = { 0 },
+		.output = stdout,
+		.value = 0
+	};
+	Program * program = allocateInArena(compilerState.arena, sizeof(Program));
+	if (strcmp(shape, "balanced") == 0) {
+		unsigned long leaf = 0;
+		program->expression = _createBalancedTree(compilerState.arena, size, &leaf);
+	}
+	else if (strcmp(shape, "left-chain") == 0) {
+		program->expression = _createLeftChain(compilerState.arena, size);
+	}
+	else {
+		fprintf(stderr, "Unknown shape: %s\n", shape);
+		return EXIT_FAILURE;
+	}
+	compilerState.abstractSyntaxtTree = program;
+	const unsigned int nodes = program->expression->size;
+
+	EngineMeasurement measurements[] = {
+		{ .compilationSeconds = 0, .executionSeconds = -1, .name = "calculator" },
+		{ .compilationSeconds = 0, .executionSeconds = -1, .name = "virtual-machine" },
+		{ .compilationSeconds = 0, .executionSeconds = -1, .name = "just-in-time" }
+	};
+	struct timespec start;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	Bytecode * bytecode = compileBytecode(&compilerState);
+	measurements[1].compilationSeconds = _elapsedSince(&start);
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	NativeCode * nativeCode = compileNativeCode(bytecode);
+	measurements[2].compilationSeconds = _elapsedSince(&start);
+	for (unsigned long k = 0; k < repetitions; ++k) {
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		_keepBestExecution(&measurements[0], &start, executeCalculator(&compilerState));
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		_keepBestExecution(&measurements[1], &start, executeVirtualMachine(bytecode));
+		if (nativeCode != NULL) {
+			clock_gettime(CLOCK_MONOTONIC, &start);
+			_keepBestExecution(&measurements[2], &start, executeNativeCode(nativeCode));
+		}
+	}
+
+	int status = EXIT_SUCCESS;
+	const unsigned int engines = nativeCode == NULL ? 2 : 3;
+	printf("engine\tnodes\tvalue\tcompilation-ms\texecution-ms\texecution-ns-per-node\n");
+	for (unsigned int k = 0; k < engines; ++k) {
+		const EngineMeasurement * measurement = &measurements[k];
+		printf("%s\t%u\t%d\t%.3f\t%.3f\t%.3f\n",
+			measurement->name,
+			nodes,
+			measurement->result.value,
+			1e3 * measurement->compilationSeconds,
+			1e3 * measurement->executionSeconds,
+			1e9 * measurement->executionSeconds / nodes);
+		if (measurement->result.succeeded != measurements[0].result.succeeded || measurement->result.value != measurements[0].result.value) {
+			fprintf(stderr, "The %s computes a different value.\n", measurement->name);
+			status = EXIT_FAILURE;
+		}
+	}
+	destroyNativeCode(nativeCode);
+	destroyBytecode(bytecode);
+	destroyArena(compilerState.arena);
+	for (int k = (sizeof(moduleDestructors)/sizeof(ModuleDestructor)) - 1; 0 <= k; --k) {
+		moduleDestructors[k]();
+	}
+	return status;
+}
@@ -0,0 +1,197 @@
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+/**
+ * Generates the synthetic programs of the benchmark (see "benchmark.sh"):
+ *
+ *	Flex-Bison-Workload-Generator <shape> <size> <output>
+ *
+ * Every shape stresses a different part of the compiler, and the size scales
+ * it (terms, levels, KiB or files, depending on the shape). The constants are
+ * never zero, and the operators alternate, so the values stay small and every
+ * program is accepted.
+ */
+
+/**
+ * The constant of the k-th term of a program.
+ */
+static int _constant(const unsigned long k) {
+	return 1 + k % 9;
+}
+
+/**
+ * The operator between the k-th term of a chain and the next one.
+ */
+static const char * _operator(const unsigned long k) {
+	return k % 2 == 0 ? " + " : " - ";
+}
+
+/**
+ * A balanced tree with 2^levels constants, where each level alternates its
+ * operator.
+ */
+static void _generateBalancedTree(FILE * output, const unsigned long levels, unsigned long * leaf) {
+	if (levels == 0) {
+		fprintf(output, "%d", _constant((*leaf)++));
+		return;
+	}
+	fputc('(', output);
+	_generateBalancedTree(output, levels - 1, leaf);
+	fputs(_operator(levels), output);
+	_generateBalancedTree(output, levels - 1, leaf);
+	fputc(')', output);
+}
+
+/**
+ * A comment of the specified amount of KiB, followed by a single constant.
+ */
+static void _generateHugeComment(FILE * output, const unsigned long kibibytes) {
+	char line[1024];
+	memset(line, 'x', sizeof(line) - 1);
+	line[sizeof(line) - 1] = '\n';
+	fputs("/*\n", output);
+	for (unsigned long k = 0; k < kibibytes; ++k) {
+		fwrite(line, sizeof(char), sizeof(line), output);
+	}
+	fputs("*/\n1\n", output);
+}
+
+/**
+ * A sum of imports of different files, stored in a sibling directory of the
+ * output (with the ".imports" suffix). The paths are absolute, so the program
+ * compiles from any working directory.
+ */
+static int _generateImports(FILE * output, const char * outputPath, const unsigned long files) {
+	char directory[PATH_MAX];
+	char absoluteDirectory[PATH_MAX];
+	char path[PATH_MAX + 32];
+	snprintf(directory, sizeof(directory), "%s.imports", outputPath);
+	mkdir(directory, 0755);
+	if (realpath(directory, absoluteDirectory) == NULL) {
+		perror(directory);
+		return EXIT_FAILURE;
+	}
+	for (unsigned long k = 0; k < files; ++k) {
+		snprintf(path, sizeof(path), "%s/%lu", absoluteDirectory, k);
+		FILE * file = fopen(path, "w");
+		if (file == NULL) {
+			perror(path);
+			return EXIT_FAILURE;
+		}
+		fprintf(file, "(%d * %d - %d)\n", _constant(k), _constant(k + 1), _constant(k + 2));
+		fclose(file);
+		fprintf(output, "%s{%s}", k == 0 ? "" : _operator(k), path);
+	}
+	fputc('\n', output);
+	return EXIT_SUCCESS;
+}
+
+/**
+ * A chain that Bison reduces into a left spine ("1 + 2 - 3 + ..."), as deep as
+ * its amount of terms.
+ */
+static void _generateLeftChain(FILE * output, const unsigned long terms) {
+	for (unsigned long k = 0; k < terms; ++k) {
+		fprintf(output, "%s%d", k == 0 ? "" : _operator(k), _constant(k));
+	}
+	fputc('\n', output);
+}
+
+/**
+ * A constant nested in the specified amount of parentheses.
+ */
+static void _generateNestedParentheses(FILE * output, const unsigned long levels) {
+	for (unsigned long k = 0; k < levels; ++k) {
+		fputc('(', output);
+	}
+	fputc('1', output);
+	for (unsigned long k = 0; k < levels; ++k) {
+		fputc(')', output);
+	}
+	fputc('\n', output);
+}
+
+/**
+ * A chain whose terms are padded with long runs of whitespace (of every kind),
+ * and with comments that hold lone asterisks and slashes. The constants have
+ * 9 digits, but they cancel each other in pairs.
+ */
+static void _generatePaddedChain(FILE * output, const unsigned long terms) {
+	static const char whitespace[] = " \t\r\n\v\f";
+	for (unsigned long k = 0; k < terms; ++k) {
+		if (0 < k) {
+			fputs(_operator(k), output);
+		}
+		for (unsigned long j = 0; j < 64 + k % 61; ++j) {
+			fputc(whitespace[(7 * j + k) % (sizeof(whitespace) - 1)], output);
+		}
+		if (k % 3 == 0) {
+			fprintf(output, "/* %lu * / ** /\n*/", k);
+		}
+		fprintf(output, "%d", 100000000 + _constant(k));
+	}
+	fputc('\n', output);
+}
+
+/**
+ * A chain nested to the right ("1 + (2 - (3 + ...))"), as deep as its amount
+ * of terms.
+ */
+static void _generateRightChain(FILE * output, const unsigned long terms) {
+	for (unsigned long k = 0; k + 1 < terms; ++k) {
+		fprintf(output, "%d%s(", _constant(k), _operator(k));
+	}
+	fprintf(output, "%d", _constant(terms - 1));
+	for (unsigned long k = 0; k + 1 < terms; ++k) {
+		fputc(')', output);
+	}
+	fputc('\n', output);
+}
+
+const int main(const int length, const char ** arguments) {
+	if (length != 4) {
+		fprintf(stderr, "Usage: %s (balanced|comment|imports|left-chain|padding|parentheses|right-chain) <size> <output>\n", arguments[0]);
+		return EXIT_FAILURE;
+	}
+	const char * shape = arguments[1];
+	const unsigned long size = strtoul(arguments[2], NULL, 10);
+	const char * outputPath = arguments[3];
+	FILE * output = fopen(outputPath, "w");
+	if (output == NULL || size == 0) {
+		perror(outputPath);
+		return EXIT_FAILURE;
+	}
+	int status = EXIT_SUCCESS;
+	unsigned long leaf = 0;
+	if (strcmp(shape, "balanced") == 0) {
+		_generateBalancedTree(output, size, &leaf);
+		fputc('\n', output);
+	}
+	else if (strcmp(shape, "comment") == 0) {
+		_generateHugeComment(output, size);
+	}
+	else if (strcmp(shape, "imports") == 0) {
+		status = _generateImports(output, outputPath, size);
+	}
+	else if (strcmp(shape, "left-chain") == 0) {
+		_generateLeftChain(output, size);
+	}
+	else if (strcmp(shape, "padding") == 0) {
+		_generatePaddedChain(output, size);
+	}
+	else if (strcmp(shape, "parentheses") == 0) {
+		_generateNestedParentheses(output, size);
+	}
+	else if (strcmp(shape, "right-chain") == 0) {
+		_generateRightChain(output, size);
+	}
+	else {
+		fprintf(stderr, "Unknown shape: %s\n", shape);
+		status = EXIT_FAILURE;
+	}
+	fclose(output);
+	return status;
+}
@@ -0,0 +1,50 @@
+#! /bin/bash
+
+set -euo pipefail
+
+BASE_PATH="$(dirname "$0")/../../.."
+cd "$BASE_PATH"
+
+GREEN='\033[0;32m'
+OFF='\033[0m'
+
+# Measures the cost of disabled logs: the regular build with every log
+# disabled at runtime, against a build where they're compiled out. Both
+# times should be the same, within noise.
+DEPTH="${1:-16}"
+REPETITIONS="${2:-5}"
+PROGRAM="$(mktemp)"
+trap 'rm --force "$PROGRAM"' EXIT
+
+# A balanced program with 2^DEPTH constants.
+awk -v depth="$DEPTH" '
+	function expression(level) {
+		if (level == 0) return int(1 + rand() * 9);
+		return "(" expression(level - 1) (level % 2 ? " + " : " - ") expression(level - 1) ")";
+	}
+	BEGIN { srand(1); print expression(depth); }' > "$PROGRAM"
+
+if [ ! -x ".build-elided/Flex-Bison-Compiler" ]; then
+	cmake -S . -B .build-elided -DMINIMUM_LOGGING_LEVEL=CRITICAL
+	cmake --build .build-elided --target Flex-Bison-Compiler
+fi
+
+TIMEFORMAT="%R"
+measure() {
+	local compiler="$1"
+	local level="$2"
+	local best=""
+	for repetition in $(seq "$REPETITIONS"); do
+		local elapsed
+		elapsed="$( { time LOGGING_LEVEL="$level" "$compiler" < "$PROGRAM" >/dev/null 2>&1; } 2>&1 )"
+		if [ -z "$best" ] || awk -v a="$elapsed" -v b="$best" 'BEGIN { exit !(a < b) }'; then
+			best="$elapsed"
+		fi
+	done
+	echo "$best"
+}
+
+echo "Logs disabled at runtime:      $(measure .build/Flex-Bison-Compiler CRITICAL)s"
+echo "Logs compiled out:             $(measure .build-elided/Flex-Bison-Compiler CRITICAL)s"
+echo "Logs enabled (to /dev/null):   $(measure .build/Flex-Bison-Compiler ALL)s"
+echo -e "${GREEN}All done.${OFF}"
@@ -0,0 +1,126 @@
+#! /bin/bash
+
+set -euo pipefail
+
+BASE_PATH="$(dirname "$0")/../../.."
+cd "$BASE_PATH"
+
+GREEN='\033[0;32m'
+RED='\033[0;31m'
+OFF='\033[0m'
+
+# Compiles a set of synthetic programs, and compares the throughput and the
+# peak memory of every phase against a baseline. Any metric worse than the
+# baseline by more than the tolerance (in %) fails the run. With
+# "--update-baseline", the results replace the baseline instead. The baseline
+# depends on the host, so it's kept in the build directory, and the first run
+# on a host only records it.
+BASELINE="${BENCHMARK_BASELINE:-.build/benchmark-baseline.tsv}"
+REPETITIONS="${BENCHMARK_REPETITIONS:-3}"
+TOLERANCE="${BENCHMARK_TOLERANCE:-10}"
+COMPILER=".build/Flex-Bison-Compiler"
+GENERATOR=".build/Flex-Bison-Workload-Generator"
+WORKSPACE=".build/benchmark"
+RESULTS="$WORKSPACE/results.tsv"
+
+# The shape and size of every workload (see "WorkloadGenerator.c").
+WORKLOADS=(
+	"balanced 16"
+	"comment 65536"
+	"imports 1024"
+	"left-chain 2000"
+	"padding 65536"
+	"parentheses 2000"
+	"right-chain 2000"
+)
+
+# Extracts the numeric value of a property from a JSON line of metrics. With a
+# phase, it only looks inside that phase.
+property() {
+	local json="$1"
+	local phase="$2"
+	local name="$3"
+	awk -v phase="$phase" -v name="$name" '{
+		text = $0;
+		if (phase != "") text = substr(text, index(text, "\"" phase "\""));
+		text = substr(text, index(text, "\"" name "\":") + length(name) + 3);
+		match(text, /^[-0-9.eE+]+/);
+		print substr(text, 1, RLENGTH);
+	}' <<< "$json"
+}
+
+rm --force --recursive "$WORKSPACE"
+mkdir --parents "$WORKSPACE"
+printf "workload\tmetric\tvalue\n" > "$RESULTS"
+
+for workload in "${WORKLOADS[@]}"; do
+	read -r shape size <<< "$workload"
+	program="$WORKSPACE/$shape.program"
+	"$GENERATOR" "$shape" "$size" "$program"
+	inputBytes="$(wc --bytes < "$program")"
+	best=""
+	for repetition in $(seq "$REPETITIONS"); do
+		rm --force "$WORKSPACE/$shape.json"
+		LOGGING_LEVEL=ERROR METRICS_OUTPUT="$WORKSPACE/$shape.json" "$COMPILER" < "$program" > /dev/null
+		json="$(cat "$WORKSPACE/$shape.json")"
+		wall="$(property "$json" syntacticAnalysis wallTimeInSeconds)"
+		if [ -z "$best" ] || awk -v a="$wall" -v b="$(property "$best" syntacticAnalysis wallTimeInSeconds)" 'BEGIN { exit !(a < b) }'; then
+			best="$json"
+		fi
+	done
+	awk -v workload="$shape" -v inputBytes="$inputBytes" \
+		-v tokens="$(property "$best" "" tokens)" \
+		-v nodes="$(property "$best" "" nodes)" \
+		-v outputBytes="$(property "$best" "" outputBytes)" \
+		-v parsing="$(property "$best" syntacticAnalysis wallTimeInSeconds)" \
+		-v generation="$(property "$best" generation wallTimeInSeconds)" \
+		-v teardown="$(property "$best" teardown wallTimeInSeconds)" \
+		-v parsingMemory="$(property "$best" syntacticAnalysis peakResidentSetSizeInKilobytes)" \
+		-v computationMemory="$(property "$best" computation peakResidentSetSizeInKilobytes)" \
+		-v generationMemory="$(property "$best" generation peakResidentSetSizeInKilobytes)" \
+		'function rate(amount, seconds) { return seconds <= 0 ? 0 : amount / seconds; }
+		BEGIN {
+			printf "%s\ttokensPerSecond\t%.0f\n", workload, rate(tokens, parsing);
+			printf "%s\tnodesPerSecond\t%.0f\n", workload, rate(nodes, parsing);
+			printf "%s\tinputMegabytesPerSecond\t%.3f\n", workload, rate(inputBytes / 1e6, parsing);
+			printf "%s\toutputMegabytesPerSecond\t%.3f\n", workload, rate(outputBytes / 1e6, generation);
+			printf "%s\tteardownNodesPerSecond\t%.0f\n", workload, rate(nodes, teardown);
+			printf "%s\tsyntacticAnalysisPeakKilobytes\t%d\n", workload, parsingMemory;
+			printf "%s\tcomputationPeakKilobytes\t%d\n", workload, computationMemory;
+			printf "%s\tgenerationPeakKilobytes\t%d\n", workload, generationMemory;
+		}' >> "$RESULTS"
+done
+
+awk -F '\t' '{ printf "    %-12s %-32s %s\n", $1, $2, $3; }' "$RESULTS"
+echo ""
+
+if [ "${1:-}" == "--update-baseline" ]; then
+	cp "$RESULTS" "$BASELINE"
+	echo -e "${GREEN}The baseline is stored in \"$BASELINE\".${OFF}"
+	exit 0
+fi
+if [ ! -f "$BASELINE" ]; then
+	cp "$RESULTS" "$BASELINE"
+	echo -e "There is no baseline yet, so nothing was compared: these results are stored as the baseline in \"$BASELINE\"."
+	exit 0
+fi
+
+# Throughputs regress when they drop, and memory when it grows. Metrics that
+# are zero in the baseline (e.g., the output of a failed phase) are skipped.
+awk -F '\t' -v tolerance="$TOLERANCE" -v red="$RED" -v green="$GREEN" -v off="$OFF" '
+	FNR == 1 { next; }
+	FNR == NR { baseline[$1 "\t" $2] = $3; next; }
+	{
+		key = $1 "\t" $2;
+		if (!(key in baseline) || baseline[key] <= 0) next;
+		change = 100 * ($3 - baseline[key]) / baseline[key];
+		worse = $2 ~ /Kilobytes$/ ? change > tolerance : -change > tolerance;
+		if (worse) {
+			failed = 1;
+			printf "    %s %s: %s (baseline %s, %+.1f%%), %sregression%s\n", $1, $2, $3, baseline[key], change, red, off;
+		}
+	}
+	END {
+		if (failed) exit 1;
+		printf "    %sNo regressions%s (tolerance %s%%).\n", green, off, tolerance;
+	}' "$BASELINE" "$RESULTS"
@@ -0,0 +1,78 @@
+#! /bin/bash
+
+set -euo pipefail
+
+BASE_PATH="$(dirname "$0")/../../.."
+cd "$BASE_PATH"
+
+GREEN='\033[0;32m'
+RED='\033[0;31m'
+OFF='\033[0m'
+STATUS=0
+
+# Compiles every program of the benchmark (see "benchmark.sh") and every test,
+# with the fast scanner and with Flex alone, from a stream and from a mapped
+# input, and compares the tokens pushed to the parser (with their lines), the
+# output, and the exit status.
+COMPILER=".build/Flex-Bison-Compiler"
+GENERATOR=".build/Flex-Bison-Workload-Generator"
+WORKSPACE=".build/scanner-test"
+
+# The shape and size of every workload (as in "benchmark.sh").
+WORKLOADS=(
+	"balanced 16"
+	"comment 65536"
+	"imports 1024"
+	"left-chain 2000"
+	"padding 65536"
+	"parentheses 2000"
+	"right-chain 2000"
+)
+
+# A digest of a compilation. The lexeme actions log every token but the
+# ignored ones, whose text the fast scanner skips. The address of the
+# semantic value changes between executions, so it's removed.
+fingerprint() {
+	local program="$1"
+	shift
+	local status=0
+	env "$@" LOGGING_LEVEL=DEBUGGING LOG_IGNORED_LEXEMES=false "$COMPILER" < "$program" > "$WORKSPACE/output" 2> "$WORKSPACE/log" || status="$?"
+	{
+		echo "$status"
+		cat "$WORKSPACE/output"
+		grep "LexemeAction" "$WORKSPACE/log" | sed 's/semanticValue=0x[0-9a-f]*//' || true
+	} | md5sum
+}
+
+rm --force --recursive "$WORKSPACE"
+mkdir --parents "$WORKSPACE"
+
+PROGRAMS=()
+for workload in "${WORKLOADS[@]}"; do
+	read -r shape size <<< "$workload"
+	"$GENERATOR" "$shape" "$size" "$WORKSPACE/$shape.program"
+	PROGRAMS+=("$WORKSPACE/$shape.program")
+done
+for test in src/test/c/accept/* src/test/c/reject/*; do
+	PROGRAMS+=("$test")
+done
+
+echo "The fast scanner should produce the same tokens..."
+echo ""
+
+for program in "${PROGRAMS[@]}"; do
+	for mode in STREAM MAPPED; do
+		expected="$(fingerprint "$program" FAST_SCANNER=false INPUT_MODE="$mode")"
+		actual="$(fingerprint "$program" FAST_SCANNER=true INPUT_MODE="$mode")"
+		if [ "$expected" == "$actual" ]; then
+			echo -e "    $program ($mode), ${GREEN}and it does${OFF}"
+		else
+			STATUS=1
+			echo -e "    $program ($mode), ${RED}but it doesn't${OFF}"
+		fi
+	done
+done
+echo ""
+
+echo "All done."
+exit $STATUS
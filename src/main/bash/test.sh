@@ -10,6 +10,45 @@ RED='\033[0;31m'
 OFF='\033[0m'
 STATUS=0
 
+WORKSPACE="$(mktemp --directory)"
+trap 'rm --force --recursive "$WORKSPACE"' EXIT
+
+# The variables of every engine and layout that should produce the same output
+# and the same divisions by zero as the iterative calculator.
+DOCUMENT_MODES=(
+	"CALCULATOR_ENGINE=JIT"
+	"CALCULATOR_ENGINE=PARALLEL CALCULATOR_PARALLEL_THRESHOLD=0"
+	"HASH_CONSING=true"
+	"SYNTAX_TREE_LAYOUT=FLAT"
+)
+
+# The ones that change the output, but not the value of the program.
+VALUE_MODES=(
+	"EVALUATE_ONLY=true"
+	"REBALANCE_TREES=true"
+)
+
+# A digest of a compilation: its exit status, its output (or only the value of
+# the program, if the second argument is "value"), and the divisions by zero
+# that it logs.
+fingerprint() {
+	local program="$1"
+	local content="$2"
+	shift 2
+	local status=0
+	env "$@" ".build/Flex-Bison-Compiler" < "$program" > "$WORKSPACE/output" 2> "$WORKSPACE/log" || status="$?"
+	{
+		echo "$status"
+		if [ "$content" == "value" ]; then
+			# The output is the value, or a document that closes with it:
+			sed --quiet '/^-\?[0-9]\+$/p; s/^ *\[ \$\(.*\)\$, circle, draw, blue \]$/\1/p' "$WORKSPACE/output"
+		else
+			cat "$WORKSPACE/output"
+		fi
+		grep --only-matching "The divisor cannot be zero.*" "$WORKSPACE/log" || true
+	} | md5sum
+}
+
 echo "Compiler should accept..."
 echo ""
 
@@ -40,5 +79,91 @@ for test in $(ls src/test/c/reject/); do
 done
 echo ""
 
+echo "Every engine and layout should compute the same value..."
+echo ""
+
+for test in src/test/c/accept/* src/test/c/reject/*; do
+	for content in document value; do
+		if [ "$content" == "document" ]; then
+			MODES=("${DOCUMENT_MODES[@]}")
+		else
+			MODES=("${VALUE_MODES[@]}")
+		fi
+		expected="$(fingerprint "$test" "$content" CALCULATOR_ENGINE=ITERATIVE)"
+		for mode in "${MODES[@]}"; do
+			actual="$(fingerprint "$test" "$content" $mode)"
+			if [ "$expected" == "$actual" ]; then
+				echo -e "    $test ($mode), ${GREEN}and it does${OFF}"
+			else
+				STATUS=1
+				echo -e "    $test ($mode), ${RED}but it doesn't${OFF}"
+			fi
+		done
+	done
+done
+echo ""
+
+echo "Stored bytecode should compute the same value..."
+echo ""
+
+for test in $(ls src/test/c/accept/); do
+	EXPECTED="$(cat "src/test/c/accept/$test" | EVALUATE_ONLY=true ".build/Flex-Bison-Compiler" 2>/dev/null)"
+	cat "src/test/c/accept/$test" | BYTECODE_OUTPUT="$WORKSPACE/$test.bytecode" ".build/Flex-Bison-Compiler" >/dev/null 2>&1
+	for engine in THREADED JIT; do
+		ACTUAL="$(BYTECODE_ENGINE="$engine" BYTECODE_INPUT="$WORKSPACE/$test.bytecode" ".build/Flex-Bison-Compiler" </dev/null 2>/dev/null)"
+		RESULT="$?"
+		if [ "$RESULT" == "0" ] && [ "$ACTUAL" == "$EXPECTED" ]; then
+			echo -e "    $test ($engine), ${GREEN}and it does${OFF} ($ACTUAL)"
+		else
+			STATUS=1
+			echo -e "    $test ($engine), ${RED}but it doesn't${OFF} (expected \"$EXPECTED\", got \"$ACTUAL\")"
+		fi
+	done
+done
+echo ""
+
+echo "Corrupted bytecode should be rejected..."
+echo ""
+
+BYTECODE="$WORKSPACE/$(ls src/test/c/accept/ | head --lines=1).bytecode"
+# Without its last word, and with a length (the fourth word of the header)
+# far larger than the file:
+head --bytes=-4 "$BYTECODE" >"$WORKSPACE/truncated.bytecode"
+cp "$BYTECODE" "$WORKSPACE/oversized.bytecode"
+printf '\xff\xff\xff\x3f' | dd of="$WORKSPACE/oversized.bytecode" bs=1 seek=12 conv=notrunc status=none
+for corruption in truncated oversized; do
+	BYTECODE_INPUT="$WORKSPACE/$corruption.bytecode" ".build/Flex-Bison-Compiler" </dev/null >/dev/null 2>&1
+	RESULT="$?"
+	if [ "$RESULT" != "0" ]; then
+		echo -e "    $corruption, ${GREEN}and it does${OFF} (status $RESULT)"
+	else
+		STATUS=1
+		echo -e "    $corruption, ${RED}but it accepts${OFF} (status $RESULT)"
+	fi
+done
+echo ""
+
+echo "Generated C code should compute the same value..."
+echo ""
+
+if command -v cc >/dev/null 2>&1; then
+	for test in $(ls src/test/c/accept/); do
+		EXPECTED="$(cat "src/test/c/accept/$test" | EVALUATE_ONLY=true ".build/Flex-Bison-Compiler" 2>/dev/null)"
+		cat "src/test/c/accept/$test" | GENERATOR_TARGET=C ".build/Flex-Bison-Compiler" >"$WORKSPACE/$test.c" 2>/dev/null \
+			&& cc -O1 -o "$WORKSPACE/$test" "$WORKSPACE/$test.c" 2>/dev/null
+		RESULT="$?"
+		ACTUAL="$("$WORKSPACE/$test" 2>/dev/null)"
+		if [ "$RESULT" == "0" ] && [ "$ACTUAL" == "$EXPECTED" ]; then
+			echo -e "    $test, ${GREEN}and it does${OFF} ($ACTUAL)"
+		else
+			STATUS=1
+			echo -e "    $test, ${RED}but it doesn't${OFF} (expected \"$EXPECTED\", got \"$ACTUAL\")"
+		fi
+	done
+else
+	echo "    Skipped, because there is no C compiler (\"cc\")."
+fi
+echo ""
+
 echo "All done."
 exit $STATUS
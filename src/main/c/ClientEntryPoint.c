@@ -0,0 +1,101 @@
+#include "support/configuration/Environment.h"
+#include "support/logging/Logger.h"
+#include "support/network/CompilationProtocol.h"
+#include "support/network/Socket.h"
+#include "support/type/CompilationStatus.h"
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/**
+ * Reads the whole standard input into memory.
+ */
+static char * _readStandardInput(size_t * length) {
+	size_t capacity = 4096;
+	char * text = malloc(capacity);
+	*length = 0;
+	size_t read = 0;
+	while (0 < (read = fread(text + *length, sizeof(char), capacity - *length, stdin))) {
+		*length += read;
+		if (*length == capacity) {
+			capacity *= 2;
+			text = realloc(text, capacity);
+		}
+	}
+	return text;
+}
+
+/**
+ * Sends the request for the program in the specified path (or in the
+ * standard input, if there is no path) to the compile server.
+ */
+static bool _sendRequest(Logger * logger, const int socket, const char * inputPath) {
+	char header[MAXIMUM_HEADER_LENGTH];
+	if (inputPath != NULL) {
+		// The server may run in another working directory:
+		char * absolutePath = realpath(inputPath, NULL);
+		if (absolutePath == NULL) {
+			LOG_ERROR(logger, "The input program \"%s\" cannot be found.", inputPath);
+			return false;
+		}
+		const int headerLength = snprintf(header, sizeof(header), FILE_REQUEST " %s\n", absolutePath);
+		free(absolutePath);
+		return headerLength < (int) sizeof(header) && writeToSocket(socket, header, headerLength);
+	}
+	size_t textLength = 0;
+	char * text = _readStandardInput(&textLength);
+	const int headerLength = snprintf(header, sizeof(header), TEXT_REQUEST " %zu\n", textLength);
+	const bool sent = writeToSocket(socket, header, headerLength) && writeToSocket(socket, text, textLength);
+	free(text);
+	return sent;
+}
+
+/**
+ * The entry-point of the client of the compile server. It sends a program to
+ * the server listening on the path in "SERVER_SOCKET", and outputs the reply.
+ * The program is the one in the path of the first argument, or the standard
+ * input if there are no arguments.
+ */
+const int main(const int length, const char ** arguments) {
+	Logger * logger = createLogger("ClientEntryPoint");
+	const char * socketPath = getNonEmptyStringOrDefault("SERVER_SOCKET", NULL);
+	if (socketPath == NULL) {
+		LOG_ERROR(logger, "The path of the server socket is undefined (see \"SERVER_SOCKET\").");
+		destroyLogger(logger);
+		return FAILED;
+	}
+	const int socket = connectToUnixSocket(socketPath);
+	if (socket < 0) {
+		LOG_ERROR(logger, "The server on \"%s\" is unreachable: %s.", socketPath, strerror(errno));
+		destroyLogger(logger);
+		return FAILED;
+	}
+	CompilationStatus compilationStatus = FAILED;
+	char header[MAXIMUM_HEADER_LENGTH];
+	char status[MAXIMUM_HEADER_LENGTH] = "";
+	size_t outputLength = 0;
+	if (!_sendRequest(logger, socket, 1 < length ? arguments[1] : NULL)) {
+		LOG_ERROR(logger, "The request cannot be sent.");
+	}
+	else if (!readLineFromSocket(socket, header, sizeof(header))
+		|| sscanf(header, "%s %zu", status, &outputLength) != 2) {
+		LOG_ERROR(logger, "The response of the server is malformed.");
+	}
+	else {
+		char * output = malloc(outputLength + 1);
+		if (readFromSocket(socket, output, outputLength)) {
+			fwrite(output, sizeof(char), outputLength, stdout);
+			compilationStatus = strcmp(status, SUCCEEDED_RESPONSE) == 0 ? SUCCEEDED : FAILED;
+		}
+		else {
+			LOG_ERROR(logger, "The output of the server is truncated.");
+		}
+		free(output);
+	}
+	close(socket);
+	LOG_DEBUGGING(logger, "The server replied: %s.", status);
+	destroyLogger(logger);
+	return compilationStatus;
+}
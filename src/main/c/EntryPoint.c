@@ -1,65 +1,900 @@
 #include "backend/code-generation/Generator.h"
+#include "backend/code-generation/NativeGenerator.h"
 #include "backend/domain-specific/Calculator.h"
+#include "backend/optimization/Rebalancer.h"
+#include "backend/virtual-machine/Bytecode.h"
+#include "backend/virtual-machine/JustInTimeCompiler.h"
+#include "backend/virtual-machine/NativeCodeCache.h"
+#include "backend/virtual-machine/VirtualMachine.h"
 #include "frontend/Frontend.h"
 #include "frontend/lexical-analysis/FlexActions.h"
+#include "frontend/lexical-analysis/ImportCache.h"
 #include "frontend/syntactic-analysis/BisonActions.h"
+#include "frontend/syntactic-analysis/NodeInterner.h"
+#include "frontend/syntactic-analysis/SyntaxTreeImage.h"
+#include "support/cache/CompilationCache.h"
+#include "support/concurrency/ThreadPool.h"
+#include "support/configuration/Environment.h"
 #include "support/logging/Logger.h"
+#include "support/memory/Arena.h"
+#include "support/metrics/Metrics.h"
+#include "support/network/CompilationProtocol.h"
+#include "support/network/Socket.h"
 #include "support/type/CompilationStatus.h"
 #include "support/type/CompilerState.h"
 #include "support/type/ModuleDestructor.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/select.h>
+#include <unistd.h>
 
 /**
- * The main entry-point of the entire application. If you use "strtok" to
- * parse anything inside this project instead of using Flex and Bison, I will
- * find you, and I will kill you (Bryan Mills; "Taken", 2008).
+ * The size of every chunk of memory requested by the AST arena.
  */
-const int main(const int length, const char ** arguments) {
+static const size_t _abstractSyntaxTreeArenaChunkSizeInBytes = 1 << 20;
+
+/**
+ * The suffix appended to the path of every input program in batch mode, to
+ * build the path of its output.
+ */
+static const char * _batchOutputSuffix = ".out";
+
+/**
+ * The initial amount of nodes of the flat table, if that layout is selected.
+ */
+static const NodeIndex _flatSyntaxTreeInitialCapacity = 1 << 10;
+
+/**
+ * The amount of programs whose native code is cached in server or batch mode,
+ * with the just-in-time compiler as the calculator engine.
+ */
+static const size_t _nativeCodeCacheCapacity = 1 << 8;
+
+/**
+ * The maximum amount of threads of a pool that the configuration can request.
+ */
+static const long _maximumThreadCount = 1 << 10;
+
+/**
+ * The compilation cache (if any), and the options that change the output of
+ * a program, which are part of every key of the cache.
+ */
+static CompilationCache * _compilationCache = NULL;
+static char _compilationConfiguration[128] = "";
+
+/**
+ * The options shared by every compilation. They are read once, before any
+ * compilation starts.
+ */
+static bool _evaluateOnly = false;
+static bool _exitWithoutTeardown = false;
+static bool _flatLayout = false;
+static bool _hashConsing = false;
+static bool _importCache = true;
+static bool _justInTimeCalculation = false;
+static bool _justInTimeCompilation = false;
+static const char * _metricsOutput = NULL;
+static bool _nativeGeneration = false;
+static bool _rebalanceTrees = false;
+
+/**
+ * The native code of the programs already computed (if any), shared by every
+ * compilation of the server or the batch.
+ */
+static NativeCodeCache * _nativeCodeCache = NULL;
+
+/**
+ * Whether the compile server keeps accepting connections. A signal (SIGINT or
+ * SIGTERM) clears it.
+ */
+static volatile sig_atomic_t _serverRunning = 0;
+
+/**
+ * A compilation of the batch mode, executed by a thread of the pool.
+ */
+typedef struct {
+	CompilationStatus compilationStatus;
+	const char * inputPath;
+	Logger * logger;
+} BatchCompilation;
+
+/**
+ * The state of the compile server. The lexical-analyzers (each one with its
+ * own scanner and parser) are created once, and reused by every connection.
+ */
+typedef struct {
+	LexicalAnalyzer ** lexicalAnalyzers;
+	unsigned int lexicalAnalyzerCount;
+	Logger * logger;
+	pthread_mutex_t mutex;
+} CompileServer;
+
+/**
+ * A connection accepted by the compile server, served by a thread of the
+ * pool.
+ */
+typedef struct {
+	int connection;
+	CompileServer * compileServer;
+} ServerConnection;
+
+static LexicalAnalyzer * _acquireLexicalAnalyzer(CompileServer * compileServer);
+static CompilationStatus _compile(Logger * logger, LexicalAnalyzer * lexicalAnalyzer, const char * inputPath, const char * program, const size_t programLength, FILE * output, const char * bytecodeOutputPath, const char * syntaxTreeOutputPath, const bool teardown);
+static void _compileInBatch(void * argument);
+static CompilationStatus _compileStandardInput(Logger * logger, const char * bytecodeOutputPath, const char * syntaxTreeOutputPath);
+static ComputationResult _computeNatively(CompilerState * compilerState, const CompilationKey * nativeCodeKey);
+static InputBuffer * _createProgramInputBuffer(LexicalAnalyzer * lexicalAnalyzer, const char * path, char ** program, size_t * programLength);
+static CompilationStatus _executeBackend(Logger * logger, CompilerState * compilerState, const char * bytecodeOutputPath, const CompilationKey * nativeCodeKey);
+static CompilationStatus _executeBatch(Logger * logger, const int length, const char ** inputPaths);
+static CompilationStatus _executeBytecode(Logger * logger, const char * path);
+static CompilationStatus _executeServer(Logger * logger, const char * socketPath);
+static CompilationStatus _executeSyntaxTreeImage(Logger * logger, const char * path, const char * bytecodeOutputPath);
+static unsigned int _getThreadCount(Logger * logger, const char * name);
+static bool _isTimeout(const int error);
+static size_t _measureDepth(const CompilerState * compilerState);
+static bool _parseTextLength(const char * text, size_t * length);
+static char * _readProgram(FILE * stream, size_t * length);
+static void _releaseLexicalAnalyzer(CompileServer * compileServer, LexicalAnalyzer * lexicalAnalyzer);
+static void _serveConnection(void * argument);
+static void _stopServer(const int signal);
+
+/**
+ * Takes an idle lexical-analyzer of the server. There is one for each thread
+ * of the pool, so there is always one available.
+ */
+static LexicalAnalyzer * _acquireLexicalAnalyzer(CompileServer * compileServer) {
+	pthread_mutex_lock(&compileServer->mutex);
+	LexicalAnalyzer * lexicalAnalyzer = compileServer->lexicalAnalyzers[--compileServer->lexicalAnalyzerCount];
+	pthread_mutex_unlock(&compileServer->mutex);
+	return lexicalAnalyzer;
+}
+
+/**
+ * Compiles the program in the input buffer pushed into the lexical-analyzer,
+ * and writes its output to the specified stream. Every compilation owns its
+ * state, and uses a lexical-analyzer (and parser) of its own, so many of them
+ * can run at the same time. The input path is only used to report metrics
+ * (NULL stands for a program without a file). Without teardown, the AST is
+ * left behind for the process exit to reclaim.
+ *
+ * If the program is also in memory, and the compilation cache is active, the
+ * output stored for the same program (and imports) is written instead, with
+ * no compilation at all. Otherwise, the output is stored once the
+ * compilation succeeds. A compilation that stores its bytecode (or its syntax
+ * tree image) isn't cached, since it needs the AST.
+ */
+static CompilationStatus _compile(Logger * logger, LexicalAnalyzer * lexicalAnalyzer, const char * inputPath, const char * program, const size_t programLength, FILE * output, const char * bytecodeOutputPath, const char * syntaxTreeOutputPath, const bool teardown) {
+	const bool cached = _compilationCache != NULL && program != NULL && bytecodeOutputPath == NULL && syntaxTreeOutputPath == NULL;
+	CompilationKey compilationKey;
+	char * cachedOutput = NULL;
+	size_t cachedOutputLength = 0;
+	if (cached) {
+		compilationKey = computeCompilationKey(_compilationConfiguration, program, programLength);
+		ComputationResult cachedResult;
+		if (loadCompilation(_compilationCache, &compilationKey, &cachedResult, &cachedOutput, &cachedOutputLength)) {
+			LOG_DEBUGGING(logger, "The compilation cache has the output of the program (value=%d).", cachedResult.value);
+			Metrics metrics = { 0 };
+			metrics.outputBytes = fwrite(cachedOutput, sizeof(char), cachedOutputLength, output);
+			free(cachedOutput);
+			if (_metricsOutput != NULL && !writeMetrics(&metrics, inputPath, true, _metricsOutput)) {
+				LOG_WARNING(logger, "The metrics cannot be written to \"%s\".", _metricsOutput);
+			}
+			return SUCCEEDED;
+		}
+	}
+	CompilerState compilerState = {
+		.arena = createArena(_abstractSyntaxTreeArenaChunkSizeInBytes),
+		.abstractSyntaxtTree = NULL,
+		.constantFolder = NULL,
+		.flatSyntaxTree = NULL,
+		.importCache = _importCache ? createImportCache() : NULL,
+		.nodeInterner = NULL,
+		.metrics = { 0 },
+		.output = output,
+		.value = 0
+	};
+	if (cached) {
+		compilerState.output = open_memstream(&cachedOutput, &cachedOutputLength);
+	}
+	CompilationKey nativeCodeKeyStorage;
+	const CompilationKey * nativeCodeKey = NULL;
+	if (_nativeCodeCache != NULL && program != NULL) {
+		// The value only depends on the program and its imports:
+		nativeCodeKeyStorage = computeCompilationKey("", program, programLength);
+		nativeCodeKey = &nativeCodeKeyStorage;
+	}
+	if (_evaluateOnly) {
+		compilerState.constantFolder = createConstantFolder();
+	}
+	else if (_flatLayout) {
+		compilerState.flatSyntaxTree = createFlatSyntaxTree(_flatSyntaxTreeInitialCapacity);
+	}
+	else if (_hashConsing) {
+		compilerState.nodeInterner = createNodeInterner();
+	}
+	lexicalAnalyzer->compilerState = &compilerState;
+	ArenaMark arenaMark = markArena(compilerState.arena);
+	CompilationStatus compilationStatus = SUCCEEDED;
+	startPhase(&compilerState.metrics, SYNTACTIC_ANALYSIS_PHASE);
+	compilationStatus = executeSyntacticAnalysis(lexicalAnalyzer);
+	stopPhase(&compilerState.metrics, SYNTACTIC_ANALYSIS_PHASE);
+	if (compilationStatus == SUCCEEDED) {
+		if (syntaxTreeOutputPath != NULL) {
+			saveSyntaxTreeImage(&compilerState, syntaxTreeOutputPath);
+		}
+		compilationStatus = _executeBackend(logger, &compilerState, bytecodeOutputPath, nativeCodeKey);
+	}
+	else {
+		LOG_ERROR(logger, "The syntactic-analysis phase rejects the input program.");
+		LOG_DEBUGGING(logger, "Dropping partial AST resources...");
+		rollbackArena(compilerState.arena, arenaMark);
+		compilationStatus = FAILED;
+	}
+	if (cached) {
+		fclose(compilerState.output);
+		compilerState.output = output;
+		fwrite(cachedOutput, sizeof(char), cachedOutputLength, output);
+		const ComputationResult computationResult = {
+			.succeeded = true,
+			.value = compilerState.value
+		};
+		if (compilationStatus == SUCCEEDED && !storeCompilation(_compilationCache, &compilationKey, computationResult, cachedOutput, cachedOutputLength)) {
+			LOG_WARNING(logger, "The output cannot be stored in the compilation cache.");
+		}
+		free(cachedOutput);
+	}
+	compilerState.metrics.allocatedBytes = compilerState.arena->allocatedBytes;
+	if (compilerState.flatSyntaxTree != NULL) {
+		compilerState.metrics.allocatedBytes += ((FlatSyntaxTree *) compilerState.flatSyntaxTree)->capacity * sizeof(FlatNode);
+	}
+	if (teardown) {
+		LOG_DEBUGGING(logger, "Releasing AST resources...");
+		startPhase(&compilerState.metrics, TEARDOWN_PHASE);
+		destroyArena(compilerState.arena);
+		destroyConstantFolder(compilerState.constantFolder);
+		destroyFlatSyntaxTree(compilerState.flatSyntaxTree);
+		destroyImportCache(compilerState.importCache);
+		destroyNodeInterner(compilerState.nodeInterner);
+		stopPhase(&compilerState.metrics, TEARDOWN_PHASE);
+	}
+	lexicalAnalyzer->compilerState = NULL;
+	if (_metricsOutput != NULL && !writeMetrics(&compilerState.metrics, inputPath, compilationStatus == SUCCEEDED, _metricsOutput)) {
+		LOG_WARNING(logger, "The metrics cannot be written to \"%s\".", _metricsOutput);
+	}
+	return compilationStatus;
+}
+
+/**
+ * The task of the thread pool in batch mode: compiles one program, and stores
+ * its output next to it.
+ */
+static void _compileInBatch(void * argument) {
+	BatchCompilation * compilation = argument;
 	LexicalAnalyzer * lexicalAnalyzer = createLexicalAnalyzer();
-	Logger * logger = createLogger("EntryPoint");
+	char * program = NULL;
+	size_t programLength = 0;
+	InputBuffer * inputBuffer = _createProgramInputBuffer(lexicalAnalyzer, compilation->inputPath, &program, &programLength);
+	char * outputPath = concatenate(2, compilation->inputPath, _batchOutputSuffix);
+	FILE * output = NULL;
+	compilation->compilationStatus = FAILED;
+	if (inputBuffer == NULL) {
+		LOG_ERROR(compilation->logger, "The input program cannot be read.");
+	}
+	else if ((output = fopen(outputPath, "w")) == NULL) {
+		LOG_ERROR(compilation->logger, "The output \"%s\" cannot be created.", outputPath);
+	}
+	else {
+		pushInputBuffer(inputBuffer);
+		compilation->compilationStatus = _compile(compilation->logger, lexicalAnalyzer, compilation->inputPath, program, programLength, output, NULL, NULL, true);
+		fclose(output);
+	}
+	destroyLexicalAnalyzer(lexicalAnalyzer);
+	destroyInputBuffer(inputBuffer);
+	free(program);
+	free(outputPath);
+}
+
+/**
+ * Compiles the program in the standard input, and writes its output to the
+ * standard output.
+ */
+static CompilationStatus _compileStandardInput(Logger * logger, const char * bytecodeOutputPath, const char * syntaxTreeOutputPath) {
+	LexicalAnalyzer * lexicalAnalyzer = createLexicalAnalyzer();
+	InputBuffer * inputBuffer = NULL;
+	char * program = NULL;
+	size_t programLength = 0;
+	if (_compilationCache != NULL && bytecodeOutputPath == NULL && syntaxTreeOutputPath == NULL && (program = _readProgram(stdin, &programLength)) != NULL) {
+		inputBuffer = createMemoryInputBuffer(lexicalAnalyzer, program, programLength + 2);
+		pushInputBuffer(inputBuffer);
+	}
+	else {
+		inputBuffer = createStandardInputBuffer(lexicalAnalyzer);
+	}
+	CompilationStatus compilationStatus = _compile(logger, lexicalAnalyzer, NULL, program, programLength, stdout, bytecodeOutputPath, syntaxTreeOutputPath, !_exitWithoutTeardown);
+	if (!_exitWithoutTeardown) {
+		destroyLexicalAnalyzer(lexicalAnalyzer);
+		destroyInputBuffer(inputBuffer);
+		free(program);
+	}
+	return compilationStatus;
+}
+
+/**
+ * Computes the value of a program with the just-in-time compiler (see
+ * "CALCULATOR_ENGINE"): lowers the AST into bytecode, translates it into
+ * machine code, and executes it. With a key (in server or batch mode), the
+ * machine code is cached, so the same program computed again only executes
+ * it. On a host without the just-in-time compiler, the calculator computes
+ * the value instead.
+ */
+static ComputationResult _computeNatively(CompilerState * compilerState, const CompilationKey * nativeCodeKey) {
+	NativeCodeEntry * nativeCodeEntry = acquireNativeCode(_nativeCodeCache, nativeCodeKey);
+	if (nativeCodeEntry == NULL) {
+		Bytecode * bytecode = compileBytecode(compilerState);
+		NativeCode * nativeCode = compileNativeCode(bytecode);
+		if (nativeCode == NULL) {
+			destroyBytecode(bytecode);
+			return executeCalculator(compilerState);
+		}
+		nativeCodeEntry = storeNativeCode(_nativeCodeCache, nativeCodeKey, bytecode, nativeCode);
+	}
+	const ComputationResult computationResult = executeNativeCode(nativeCodeEntry->nativeCode);
+	releaseNativeCode(_nativeCodeCache, nativeCodeEntry);
+	return computationResult;
+}
+
+/**
+ * Creates the input buffer of a program file. If the compilation cache (or
+ * the native code cache) is active, the program is read into memory first,
+ * since its key needs the text (which must be freed once the buffer is
+ * destroyed). Returns NULL if the file cannot be read.
+ */
+static InputBuffer * _createProgramInputBuffer(LexicalAnalyzer * lexicalAnalyzer, const char * path, char ** program, size_t * programLength) {
+	if (_compilationCache == NULL && _nativeCodeCache == NULL) {
+		return createInputBuffer(lexicalAnalyzer, path);
+	}
+	FILE * stream = fopen(path, "r");
+	if (stream == NULL) {
+		return NULL;
+	}
+	*program = _readProgram(stream, programLength);
+	fclose(stream);
+	if (*program == NULL) {
+		return NULL;
+	}
+	return createMemoryInputBuffer(lexicalAnalyzer, *program, *programLength + 2);
+}
+
+/**
+ * Executes the phases of the backend over the AST of a compilation (in any
+ * layout), and writes its output: rebalancing, computation and generation.
+ * It fails if the computation rejects the program.
+ */
+static CompilationStatus _executeBackend(Logger * logger, CompilerState * compilerState, const char * bytecodeOutputPath, const CompilationKey * nativeCodeKey) {
+	// ----------------------------------------------------------------------------------------
+	// Beginning of the Backend... ------------------------------------------------------------
+	const bool measureDepth = _metricsOutput != NULL || (_rebalanceTrees && IS_LOGGING_ENABLED(logger, INFORMATION));
+	if (measureDepth) {
+		compilerState->metrics.maximumDepth = _measureDepth(compilerState);
+	}
+	if (_rebalanceTrees) {
+		startPhase(&compilerState->metrics, REBALANCING_PHASE);
+		executeRebalancer(compilerState);
+		stopPhase(&compilerState->metrics, REBALANCING_PHASE);
+		if (measureDepth) {
+			compilerState->metrics.rebalancedDepth = _measureDepth(compilerState);
+			LOG_INFORMATION(logger, "The depth of the AST is %zu after rebalancing (it was %zu).",
+				compilerState->metrics.rebalancedDepth,
+				compilerState->metrics.maximumDepth);
+		}
+	}
+	LOG_DEBUGGING(logger, "Computing expression value...");
+	startPhase(&compilerState->metrics, COMPUTATION_PHASE);
+	// Without an AST (in evaluate-only mode), only the calculator has the value:
+	ComputationResult computationResult = _justInTimeCalculation && !_evaluateOnly
+		? _computeNatively(compilerState, nativeCodeKey)
+		: executeCalculator(compilerState);
+	stopPhase(&compilerState->metrics, COMPUTATION_PHASE);
+	if (computationResult.succeeded && _evaluateOnly) {
+		compilerState->value = computationResult.value;
+		const int outputBytes = fprintf(compilerState->output, "%d\n", computationResult.value);
+		compilerState->metrics.outputBytes = outputBytes < 0 ? 0 : outputBytes;
+	}
+	else if (computationResult.succeeded) {
+		compilerState->value = computationResult.value;
+		startPhase(&compilerState->metrics, GENERATION_PHASE);
+		if (bytecodeOutputPath != NULL) {
+			Bytecode * bytecode = compileBytecode(compilerState);
+			saveBytecode(bytecode, bytecodeOutputPath);
+			destroyBytecode(bytecode);
+		}
+		if (_nativeGeneration) {
+			executeNativeGenerator(compilerState);
+		}
+		else {
+			executeGenerator(compilerState);
+		}
+		stopPhase(&compilerState->metrics, GENERATION_PHASE);
+	}
+	else {
+		LOG_ERROR(logger, "The computation phase rejects the input program.");
+		return FAILED;
+	}
+	// ...end of the Backend. -----------------------------------------------------------------
+	// ----------------------------------------------------------------------------------------
+	return SUCCEEDED;
+}
+
+/**
+ * Compiles many programs concurrently, on a pool of threads. It only succeeds
+ * if every program is accepted.
+ */
+static CompilationStatus _executeBatch(Logger * logger, const int length, const char ** inputPaths) {
+	LOG_DEBUGGING(logger, "Compiling %d programs in batch mode...", length);
+	BatchCompilation * compilations = calloc(length, sizeof(BatchCompilation));
+	ThreadPool * threadPool = createThreadPool(_getThreadCount(logger, "BATCH_THREADS"));
+	_nativeCodeCache = _justInTimeCalculation ? createNativeCodeCache(_nativeCodeCacheCapacity) : NULL;
+	for (int k = 0; k < length; ++k) {
+		compilations[k].compilationStatus = IN_PROGRESS;
+		compilations[k].inputPath = inputPaths[k];
+		compilations[k].logger = logger;
+		submitToThreadPool(threadPool, _compileInBatch, &compilations[k]);
+	}
+	waitForThreadPool(threadPool);
+	destroyThreadPool(threadPool);
+	destroyNativeCodeCache(_nativeCodeCache);
+	_nativeCodeCache = NULL;
+	CompilationStatus compilationStatus = SUCCEEDED;
 	for (int k = 0; k < length; ++k) {
-		logDebugging(logger, "Argument %d: \"%s\"", k, arguments[k]);
+		if (compilations[k].compilationStatus != SUCCEEDED) {
+			LOG_ERROR(logger, "The program \"%s\" is rejected.", compilations[k].inputPath);
+			compilationStatus = FAILED;
+		}
+	}
+	free(compilations);
+	return compilationStatus;
+}
+
+/**
+ * Executes a bytecode stored by a previous compilation, and outputs the value
+ * of the program, without running the frontend at all. With the just-in-time
+ * compiler, the virtual machine is only a fallback.
+ */
+static CompilationStatus _executeBytecode(Logger * logger, const char * path) {
+	LOG_DEBUGGING(logger, "Executing the bytecode stored in \"%s\"...", path);
+	Bytecode * bytecode = loadBytecode(path);
+	if (bytecode == NULL) {
+		LOG_ERROR(logger, "The bytecode cannot be loaded.");
+		return FAILED;
+	}
+	NativeCode * nativeCode = _justInTimeCompilation ? compileNativeCode(bytecode) : NULL;
+	ComputationResult computationResult;
+	if (nativeCode != NULL) {
+		computationResult = executeNativeCode(nativeCode);
+		destroyNativeCode(nativeCode);
+	}
+	else {
+		computationResult = executeVirtualMachine(bytecode);
+	}
+	destroyBytecode(bytecode);
+	if (computationResult.succeeded) {
+		fprintf(stdout, "%d\n", computationResult.value);
+		return SUCCEEDED;
+	}
+	else {
+		LOG_ERROR(logger, "The computation phase rejects the input program.");
+		return FAILED;
+	}
+}
+
+/**
+ * Runs the compile server: accepts connections on a local socket until it
+ * receives SIGINT or SIGTERM, and serves each one on a pool of threads (see
+ * "CompilationProtocol.h"). The modules are initialized only once, and the
+ * lexical-analyzers and parsers are reused across connections.
+ */
+static CompilationStatus _executeServer(Logger * logger, const char * socketPath) {
+	const int serverSocket = listenOnUnixSocket(socketPath, SOMAXCONN);
+	if (serverSocket < 0) {
+		LOG_ERROR(logger, "The server cannot listen on \"%s\": %s.", socketPath, strerror(errno));
+		return FAILED;
+	}
+	// Only the main thread must receive the signals that stop the server, and
+	// only while it waits for a connection (see below):
+	sigset_t signals;
+	sigset_t waitingSignals;
+	sigemptyset(&signals);
+	sigaddset(&signals, SIGINT);
+	sigaddset(&signals, SIGTERM);
+	pthread_sigmask(SIG_BLOCK, &signals, &waitingSignals);
+	ThreadPool * threadPool = createThreadPool(_getThreadCount(logger, "SERVER_THREADS"));
+	_nativeCodeCache = _justInTimeCalculation ? createNativeCodeCache(_nativeCodeCacheCapacity) : NULL;
+	CompileServer compileServer = {
+		.lexicalAnalyzers = calloc(threadPool->threadCount, sizeof(LexicalAnalyzer *)),
+		.lexicalAnalyzerCount = threadPool->threadCount,
+		.logger = logger
+	};
+	pthread_mutex_init(&compileServer.mutex, NULL);
+	for (unsigned int k = 0; k < compileServer.lexicalAnalyzerCount; ++k) {
+		compileServer.lexicalAnalyzers[k] = createLexicalAnalyzer();
+	}
+	struct sigaction action;
+	memset(&action, 0, sizeof(action));
+	action.sa_handler = _stopServer;
+	sigaction(SIGINT, &action, NULL);
+	sigaction(SIGTERM, &action, NULL);
+	_serverRunning = 1;
+	LOG_INFORMATION(logger, "Listening on \"%s\" (threads=%u)...", socketPath, threadPool->threadCount);
+	// The signals are unblocked atomically while "pselect" waits, so a signal
+	// that arrives right after the check of "_serverRunning" interrupts the
+	// wait, instead of being lost until the next connection. The socket is
+	// non-blocking, in case a connection is reset before it's accepted:
+	fcntl(serverSocket, F_SETFL, fcntl(serverSocket, F_GETFL) | O_NONBLOCK);
+	while (_serverRunning) {
+		fd_set readableSockets;
+		FD_ZERO(&readableSockets);
+		FD_SET(serverSocket, &readableSockets);
+		if (pselect(serverSocket + 1, &readableSockets, NULL, NULL, NULL, &waitingSignals) < 0) {
+			if (errno != EINTR) {
+				LOG_ERROR(logger, "The server cannot wait for a connection: %s.", strerror(errno));
+			}
+			continue;
+		}
+		const int connection = accept(serverSocket, NULL, NULL);
+		if (connection < 0) {
+			if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+				LOG_ERROR(logger, "A connection cannot be accepted: %s.", strerror(errno));
+			}
+			continue;
+		}
+		if (!setSocketTimeout(connection, TRANSFER_TIMEOUT)) {
+			LOG_WARNING(logger, "The timeout of a connection cannot be set: %s.", strerror(errno));
+		}
+		ServerConnection * serverConnection = calloc(1, sizeof(ServerConnection));
+		serverConnection->connection = connection;
+		serverConnection->compileServer = &compileServer;
+		submitToThreadPool(threadPool, _serveConnection, serverConnection);
+	}
+	pthread_sigmask(SIG_SETMASK, &waitingSignals, NULL);
+	LOG_INFORMATION(logger, "Stopping the server...");
+	waitForThreadPool(threadPool);
+	for (unsigned int k = 0; k < threadPool->threadCount; ++k) {
+		destroyLexicalAnalyzer(compileServer.lexicalAnalyzers[k]);
+	}
+	destroyThreadPool(threadPool);
+	destroyNativeCodeCache(_nativeCodeCache);
+	_nativeCodeCache = NULL;
+	free(compileServer.lexicalAnalyzers);
+	pthread_mutex_destroy(&compileServer.mutex);
+	close(serverSocket);
+	unlink(socketPath);
+	return SUCCEEDED;
+}
+
+/**
+ * Reads the amount of threads of a pool from the configuration. A negative
+ * amount, or one above the maximum, is ignored (i.e., the pool uses one
+ * thread per online processor).
+ */
+static unsigned int _getThreadCount(Logger * logger, const char * name) {
+	const long threadCount = getIntegerOrDefault(name, 0);
+	if (0 <= threadCount && threadCount <= _maximumThreadCount) {
+		return threadCount;
+	}
+	LOG_WARNING(logger, "The amount of threads %s=%ld is ignored (it must be between 0 and %ld).", name, threadCount, _maximumThreadCount);
+	return 0;
+}
+
+/**
+ * Whether a transfer of a connection failed because its timeout expired (see
+ * "setSocketTimeout").
+ */
+static bool _isTimeout(const int error) {
+	return error == EAGAIN || error == EWOULDBLOCK;
+}
+
+/**
+ * Measures the depth of the AST, in whatever layout the parser built it. The
+ * evaluate-only mode builds no tree, so its depth is zero.
+ */
+static size_t _measureDepth(const CompilerState * compilerState) {
+	if (compilerState->flatSyntaxTree != NULL) {
+		return measureFlatSyntaxTreeDepth(compilerState->flatSyntaxTree);
+	}
+	else if (compilerState->abstractSyntaxtTree != NULL) {
+		return measureAbstractSyntaxTreeDepth(compilerState->abstractSyntaxtTree);
+	}
+	return 0;
+}
+
+/**
+ * Parses the length of a TEXT request: only decimal digits, and no more than
+ * MAXIMUM_TEXT_LENGTH, so the text and its two null sentinels can always be
+ * allocated. Returns false if the length is malformed or too large.
+ */
+static bool _parseTextLength(const char * text, size_t * length) {
+	if (text[0] < '0' || '9' < text[0]) {
+		return false;
+	}
+	char * end = NULL;
+	errno = 0;
+	const unsigned long long value = strtoull(text, &end, 10);
+	if (errno != 0 || *end != '\0' || MAXIMUM_TEXT_LENGTH < value || SIZE_MAX - 2 < value) {
+		return false;
+	}
+	*length = (size_t) value;
+	return true;
+}
+
+/**
+ * Reads an entire stream into heap-memory, followed by the two null sentinels
+ * that Flex requires (not included in the length). Returns NULL if the stream
+ * cannot be read.
+ */
+static char * _readProgram(FILE * stream, size_t * length) {
+	size_t capacity = 1 << 12;
+	char * program = malloc(capacity);
+	*length = 0;
+	while (program != NULL) {
+		*length += fread(program + *length, sizeof(char), capacity - *length - 2, stream);
+		if (*length + 2 < capacity) {
+			break;
+		}
+		capacity *= 2;
+		char * grownProgram = realloc(program, capacity);
+		if (grownProgram == NULL) {
+			free(program);
+		}
+		program = grownProgram;
+	}
+	if (program == NULL || ferror(stream)) {
+		free(program);
+		return NULL;
+	}
+	program[*length] = '\0';
+	program[*length + 1] = '\0';
+	return program;
+}
+
+/**
+ * Returns a lexical-analyzer to the server, once its compilation is done.
+ */
+static void _releaseLexicalAnalyzer(CompileServer * compileServer, LexicalAnalyzer * lexicalAnalyzer) {
+	pthread_mutex_lock(&compileServer->mutex);
+	compileServer->lexicalAnalyzers[compileServer->lexicalAnalyzerCount++] = lexicalAnalyzer;
+	pthread_mutex_unlock(&compileServer->mutex);
+}
+
+/**
+ * The task of the thread pool in server mode: reads a request, compiles its
+ * program into memory, and replies with the status and the output.
+ */
+static void _serveConnection(void * argument) {
+	ServerConnection * serverConnection = argument;
+	CompileServer * compileServer = serverConnection->compileServer;
+	const int connection = serverConnection->connection;
+	free(serverConnection);
+	const size_t fileRequestLength = strlen(FILE_REQUEST " ");
+	const size_t textRequestLength = strlen(TEXT_REQUEST " ");
+	char header[MAXIMUM_HEADER_LENGTH];
+	char * output = NULL;
+	size_t outputLength = 0;
+	FILE * stream = open_memstream(&output, &outputLength);
+	char * text = NULL;
+	size_t textLength = 0;
+	LexicalAnalyzer * lexicalAnalyzer = _acquireLexicalAnalyzer(compileServer);
+	InputBuffer * inputBuffer = NULL;
+	const char * inputPath = NULL;
+	CompilationStatus compilationStatus = FAILED;
+	errno = 0;
+	if (!readLineFromSocket(connection, header, sizeof(header))) {
+		LOG_ERROR(compileServer->logger, "The request cannot be read%s.", _isTimeout(errno) ? " (the client timed out)" : "");
+	}
+	else if (strncmp(header, FILE_REQUEST " ", fileRequestLength) == 0) {
+		inputPath = header + fileRequestLength;
+		inputBuffer = _createProgramInputBuffer(lexicalAnalyzer, inputPath, &text, &textLength);
+	}
+	else if (strncmp(header, TEXT_REQUEST " ", textRequestLength) == 0) {
+		if (!_parseTextLength(header + textRequestLength, &textLength)) {
+			LOG_ERROR(compileServer->logger, "The length of the program text is invalid (the maximum is %d bytes): \"%s\".",
+				MAXIMUM_TEXT_LENGTH, header + textRequestLength);
+		}
+		else {
+			// Flex requires two null sentinels after the text:
+			text = calloc(textLength + 2, sizeof(char));
+			errno = 0;
+			if (text != NULL && readFromSocket(connection, text, textLength)) {
+				inputBuffer = createMemoryInputBuffer(lexicalAnalyzer, text, textLength + 2);
+			}
+			else {
+				LOG_ERROR(compileServer->logger, "The program text cannot be read%s.", _isTimeout(errno) ? " (the client timed out)" : "");
+			}
+		}
+	}
+	else {
+		LOG_ERROR(compileServer->logger, "The request is unknown: \"%s\".", header);
+	}
+	if (inputBuffer != NULL) {
+		pushInputBuffer(inputBuffer);
+		compilationStatus = _compile(compileServer->logger, lexicalAnalyzer, inputPath, text, textLength, stream, NULL, NULL, true);
+	}
+	resetLexicalAnalyzer(lexicalAnalyzer);
+	_releaseLexicalAnalyzer(compileServer, lexicalAnalyzer);
+	destroyInputBuffer(inputBuffer);
+	free(text);
+	fclose(stream);
+	char response[64];
+	const int responseLength = snprintf(response, sizeof(response), "%s %zu\n",
+		compilationStatus == SUCCEEDED ? SUCCEEDED_RESPONSE : FAILED_RESPONSE,
+		outputLength);
+	if (!writeToSocket(connection, response, responseLength) || !writeToSocket(connection, output, outputLength)) {
+		LOG_WARNING(compileServer->logger, "The response cannot be sent: %s.", strerror(errno));
+	}
+	free(output);
+	close(connection);
+}
+
+/**
+ * Computes and generates a program from a syntax tree image stored by a
+ * previous compilation (see "SyntaxTreeImage.h"). The image is mapped in
+ * memory, and the backend runs on it with the flat layout, so the frontend is
+ * skipped entirely.
+ */
+static CompilationStatus _executeSyntaxTreeImage(Logger * logger, const char * path, const char * bytecodeOutputPath) {
+	LOG_DEBUGGING(logger, "Mapping the syntax tree image stored in \"%s\"...", path);
+	FlatSyntaxTree * flatSyntaxTree = mapSyntaxTreeImage(path);
+	if (flatSyntaxTree == NULL) {
+		LOG_ERROR(logger, "The syntax tree image cannot be mapped.");
+		return FAILED;
 	}
 	CompilerState compilerState = {
+		.arena = createArena(_abstractSyntaxTreeArenaChunkSizeInBytes),
 		.abstractSyntaxtTree = NULL,
+		.constantFolder = NULL,
+		.flatSyntaxTree = flatSyntaxTree,
+		.importCache = NULL,
+		.nodeInterner = NULL,
+		.metrics = { 0 },
+		.output = stdout,
 		.value = 0
 	};
+	compilerState.metrics.nodes = flatSyntaxTree->count;
+	const CompilationStatus compilationStatus = _executeBackend(logger, &compilerState, bytecodeOutputPath, NULL);
+	compilerState.metrics.allocatedBytes = compilerState.arena->allocatedBytes;
+	destroyArena(compilerState.arena);
+	destroyFlatSyntaxTree(compilerState.flatSyntaxTree);
+	if (_metricsOutput != NULL && !writeMetrics(&compilerState.metrics, path, compilationStatus == SUCCEEDED, _metricsOutput)) {
+		LOG_WARNING(logger, "The metrics cannot be written to \"%s\".", _metricsOutput);
+	}
+	return compilationStatus;
+}
+
+/**
+ * The signal handler that stops the compile server.
+ */
+static void _stopServer(const int signal) {
+	_serverRunning = 0;
+}
+
+/**
+ * The main entry-point of the entire application. If you use "strtok" to
+ * parse anything inside this project instead of using Flex and Bison, I will
+ * find you, and I will kill you (Bryan Mills; "Taken", 2008).
+ */
+const int main(const int length, const char ** arguments) {
+	Logger * logger = createLogger("EntryPoint");
+	for (int k = 0; k < length; ++k) {
+		LOG_DEBUGGING(logger, "Argument %d: \"%s\"", k, arguments[k]);
+	}
+	_evaluateOnly = getBooleanOrDefault("EVALUATE_ONLY", false);
+	_exitWithoutTeardown = getBooleanOrDefault("EXIT_WITHOUT_TEARDOWN", false);
+	_flatLayout = strcmp(getStringOrDefault("SYNTAX_TREE_LAYOUT", "POINTER"), "FLAT") == 0;
+	_hashConsing = getBooleanOrDefault("HASH_CONSING", false);
+	_importCache = getBooleanOrDefault("IMPORT_CACHE", true);
+	_justInTimeCalculation = strcmp(getStringOrDefault("CALCULATOR_ENGINE", "ITERATIVE"), "JIT") == 0;
+	_justInTimeCompilation = strcmp(getStringOrDefault("BYTECODE_ENGINE", "THREADED"), "JIT") == 0;
+	_metricsOutput = getNonEmptyStringOrDefault("METRICS_OUTPUT", NULL);
+	_nativeGeneration = strcmp(getStringOrDefault("GENERATOR_TARGET", "LATEX"), "C") == 0;
+	_rebalanceTrees = getBooleanOrDefault("REBALANCE_TREES", false);
+	const char * compilationCacheDirectory = getNonEmptyStringOrDefault("COMPILATION_CACHE_DIRECTORY", NULL);
+	if (compilationCacheDirectory != NULL) {
+		_compilationCache = createCompilationCache(compilationCacheDirectory);
+		if (_compilationCache == NULL) {
+			LOG_WARNING(logger, "The compilation cache cannot be created in \"%s\".", compilationCacheDirectory);
+		}
+		snprintf(_compilationConfiguration, sizeof(_compilationConfiguration), "EVALUATE_ONLY=%d;GENERATOR_TARGET=%s;REBALANCE_TREES=%d",
+			_evaluateOnly,
+			_nativeGeneration ? "C" : "LATEX",
+			_rebalanceTrees);
+	}
+	if (_hashConsing && _rebalanceTrees) {
+		LOG_WARNING(logger, "The hash-consing is ignored, because the rebalancer rewrites the nodes in place.");
+		_hashConsing = false;
+	}
+	if (_evaluateOnly) {
+		LOG_DEBUGGING(logger, "Folding the value of the program while parsing (no AST).");
+	}
+	else if (_flatLayout) {
+		LOG_DEBUGGING(logger, "Using the flat layout for the AST.");
+	}
 	ModuleDestructor moduleDestructors[] = {
 		initializeAbstractSyntaxTreeModule(),
-		initializeFlexActionsModule(lexicalAnalyzer),
-		initializeBisonActionsModule(&compilerState),
-		initializeFrontendModule(lexicalAnalyzer),
+		initializeImportCacheModule(),
+		initializeImportPrefetcherModule(),
+		initializeFastScannerModule(),
+		initializeFlexActionsModule(),
+		initializeBisonActionsModule(),
+		initializeNodeInternerModule(),
+		initializeFrontendModule(),
+		initializeRebalancerModule(),
 		initializeCalculatorModule(),
-		initializeGeneratorModule()
+		initializeGeneratorModule(),
+		initializeNativeGeneratorModule(),
+		initializeBytecodeModule(),
+		initializeVirtualMachineModule(),
+		initializeJustInTimeCompilerModule(),
+		initializeNativeCodeCacheModule(),
+		initializeSyntaxTreeImageModule()
 	};
-	CompilationStatus compilationStatus = executeSyntacticAnalysis();
-	Program * program = compilerState.abstractSyntaxtTree;
-	if (compilationStatus == SUCCEEDED) {
-		// ----------------------------------------------------------------------------------------
-		// Beginning of the Backend... ------------------------------------------------------------
-		logDebugging(logger, "Computing expression value...");
-		ComputationResult computationResult = executeCalculator(&compilerState);
-		if (computationResult.succeeded) {
-			compilerState.value = computationResult.value;
-			executeGenerator(&compilerState);
+	const char * bytecodeInputPath = getNonEmptyStringOrDefault("BYTECODE_INPUT", NULL);
+	const char * bytecodeOutputPath = getNonEmptyStringOrDefault("BYTECODE_OUTPUT", NULL);
+	const char * serverSocketPath = getNonEmptyStringOrDefault("SERVER_SOCKET", NULL);
+	const char * syntaxTreeInputPath = getNonEmptyStringOrDefault("SYNTAX_TREE_INPUT", NULL);
+	const char * syntaxTreeOutputPath = getNonEmptyStringOrDefault("SYNTAX_TREE_OUTPUT", NULL);
+	CompilationStatus compilationStatus = SUCCEEDED;
+	if (bytecodeInputPath != NULL) {
+		compilationStatus = _executeBytecode(logger, bytecodeInputPath);
+	}
+	else if (syntaxTreeInputPath != NULL) {
+		if (syntaxTreeOutputPath != NULL) {
+			LOG_WARNING(logger, "The syntax tree output is ignored with a syntax tree input.");
 		}
-		else {
-			logError(logger, "The computation phase rejects the input program.");
-			compilationStatus = FAILED;
+		compilationStatus = _executeSyntaxTreeImage(logger, syntaxTreeInputPath, bytecodeOutputPath);
+	}
+	else if (serverSocketPath != NULL) {
+		if (bytecodeOutputPath != NULL) {
+			LOG_WARNING(logger, "The bytecode output is ignored in server mode.");
+		}
+		if (syntaxTreeOutputPath != NULL) {
+			LOG_WARNING(logger, "The syntax tree output is ignored in server mode.");
 		}
-		// ...end of the Backend. -----------------------------------------------------------------
-		// ----------------------------------------------------------------------------------------
+		compilationStatus = _executeServer(logger, serverSocketPath);
+	}
+	else if (1 < length) {
+		if (bytecodeOutputPath != NULL) {
+			LOG_WARNING(logger, "The bytecode output is ignored in batch mode.");
+		}
+		if (syntaxTreeOutputPath != NULL) {
+			LOG_WARNING(logger, "The syntax tree output is ignored in batch mode.");
+		}
+		compilationStatus = _executeBatch(logger, length - 1, arguments + 1);
 	}
 	else {
-		logError(logger, "The syntactic-analysis phase rejects the input program.");
-		compilationStatus = FAILED;
+		if (_evaluateOnly && syntaxTreeOutputPath != NULL) {
+			LOG_WARNING(logger, "The syntax tree output is ignored in evaluate-only mode (there is no AST).");
+			syntaxTreeOutputPath = NULL;
+		}
+		compilationStatus = _compileStandardInput(logger, bytecodeOutputPath, syntaxTreeOutputPath);
+	}
+	if (_exitWithoutTeardown) {
+		// Skips every destructor, and the leak checks of the sanitizers, but
+		// not the pending output nor the pending logs:
+		LOG_DEBUGGING(logger, "Exiting without teardown.");
+		fflush(stdout);
+		destroyLogger(logger);
+		fflush(stderr);
+		_exit(compilationStatus);
 	}
-	logDebugging(logger, "Releasing AST resources...");
-	destroyProgram(program);
 	for (int k = (sizeof(moduleDestructors)/sizeof(ModuleDestructor)) - 1; 0 <= k; --k) {
 		moduleDestructors[k]();
 	}
-	logDebugging(logger, "Compilation is done.");
+	destroyCompilationCache(_compilationCache);
+	LOG_DEBUGGING(logger, "Compilation is done.");
 	destroyLogger(logger);
-	destroyLexicalAnalyzer(lexicalAnalyzer);
 	return compilationStatus;
 }
@@ -4,12 +4,15 @@
 
 const char _indentationCharacter = ' ';
 const char _indentationSize = 4;
+static bool _flushEveryLine = false;
+static size_t _flushThreshold = 65536;
+static char _indentationBlock[256];
 static Logger * _logger = NULL;
 
 /** Shutdown module's internal state. */
 void _shutdownGeneratorModule() {
 	if (_logger != NULL) {
-		logDebugging(_logger, "Destroying module: Generator...");
+		LOG_DEBUGGING(_logger, "Destroying module: Generator...");
 		destroyLogger(_logger);
 		_logger = NULL;
 	}
@@ -17,20 +20,29 @@ void _shutdownGeneratorModule() {
 
 ModuleDestructor initializeGeneratorModule() {
 	_logger = createLogger("Generator");
+	_flushEveryLine = getBooleanOrDefault("OUTPUT_FLUSH_EVERY_LINE", false);
+	const long flushThreshold = getIntegerOrDefault("OUTPUT_FLUSH_THRESHOLD", _flushThreshold);
+	if (0 <= flushThreshold) {
+		_flushThreshold = flushThreshold;
+	}
+	memset(_indentationBlock, _indentationCharacter, sizeof(_indentationBlock));
 	return _shutdownGeneratorModule;
 }
 
 /** PRIVATE FUNCTIONS */
 
-static char * _indentation(const unsigned int indentationLevel);
 static const char _expressionTypeToCharacter(const ExpressionType type);
-static void _generateConstant(const unsigned int indentationLevel, Constant * constant);
-static void _generateEpilogue(const int value);
-static void _generateExpression(const unsigned int indentationLevel, Expression * expression);
-static void _generateFactor(const unsigned int indentationLevel, Factor * factor);
-static void _generateProgram(Program * program);
-static void _generatePrologue(void);
-static void _output(const unsigned int indentationLevel, const char * const format, ...);
+static const char _flatNodeTypeToCharacter(const FlatNodeType type);
+static void _generateConstant(OutputSink * outputSink, const unsigned int indentationLevel, const int value);
+static void _generateEpilogue(OutputSink * outputSink, const int value);
+static void _generateExpression(OutputSink * outputSink, const unsigned int indentationLevel, Expression * expression);
+static void _generateFactor(OutputSink * outputSink, const unsigned int indentationLevel, Factor * factor);
+static void _generateFlatExpression(OutputSink * outputSink, const unsigned int indentationLevel, const FlatSyntaxTree * flatSyntaxTree, const NodeIndex index);
+static void _generateFlatFactor(OutputSink * outputSink, const unsigned int indentationLevel, const FlatSyntaxTree * flatSyntaxTree, const NodeIndex index);
+static void _generateProgram(OutputSink * outputSink, Program * program);
+static void _generatePrologue(OutputSink * outputSink);
+static void _indent(OutputSink * outputSink, const unsigned int indentationLevel);
+static void _output(OutputSink * outputSink, const unsigned int indentationLevel, const char * const format, ...);
 
 /**
  * Converts and expression type to the proper character of the operation
@@ -43,7 +55,22 @@ static const char _expressionTypeToCharacter(const ExpressionType type) {
 		case MULTIPLICATION: return '*';
 		case SUBTRACTION: return '-';
 		default:
-			logError(_logger, "The specified expression type cannot be converted into character: %d", type);
+			LOG_ERROR(_logger, "The specified expression type cannot be converted into character: %d", type);
+			return '\0';
+	}
+}
+
+/**
+ * Analog to "_expressionTypeToCharacter", but for the type of a flat node.
+ */
+static const char _flatNodeTypeToCharacter(const FlatNodeType type) {
+	switch (type) {
+		case ADDITION_NODE: return '+';
+		case DIVISION_NODE: return '/';
+		case MULTIPLICATION_NODE: return '*';
+		case SUBTRACTION_NODE: return '-';
+		default:
+			LOG_ERROR(_logger, "The specified flat node type cannot be converted into character: %d", type);
 			return '\0';
 	}
 }
@@ -51,18 +78,18 @@ static const char _expressionTypeToCharacter(const ExpressionType type) {
 /**
  * Generates the output of a constant.
  */
-static void _generateConstant(const unsigned int indentationLevel, Constant * constant) {
-	_output(indentationLevel, "%s", "[ $C$, circle, draw, black!20\n");
-	_output(1 + indentationLevel, "%s%d%s", "[ $", constant->value, "$, circle, draw ]\n");
-	_output(indentationLevel, "%s", "]\n");
+static void _generateConstant(OutputSink * outputSink, const unsigned int indentationLevel, const int value) {
+	_output(outputSink, indentationLevel, "%s", "[ $C$, circle, draw, black!20\n");
+	_output(outputSink, 1 + indentationLevel, "%s%d%s", "[ $", value, "$, circle, draw ]\n");
+	_output(outputSink, indentationLevel, "%s", "]\n");
 }
 
 /**
  * Creates the epilogue of the generated output, that is, the final lines that
  * completes a valid Latex document.
  */
-static void _generateEpilogue(const int value) {
-	_output(0, "%s%d%s",
+static void _generateEpilogue(OutputSink * outputSink, const int value) {
+	_output(outputSink, 0, "%s%d%s",
 		"            [ $", value, "$, circle, draw, blue ]\n"
 		"        ]\n"
 		"    \\end{forest}\n"
@@ -73,53 +100,103 @@ static void _generateEpilogue(const int value) {
 /**
  * Generates the output of an expression.
  */
-static void _generateExpression(const unsigned int indentationLevel, Expression * expression) {
-	_output(indentationLevel, "%s", "[ $E$, circle, draw, black!20\n");
+static void _generateExpression(OutputSink * outputSink, const unsigned int indentationLevel, Expression * expression) {
+	_output(outputSink, indentationLevel, "%s", "[ $E$, circle, draw, black!20\n");
 	switch (expression->type) {
 		case ADDITION:
 		case DIVISION:
 		case MULTIPLICATION:
 		case SUBTRACTION:
-			_generateExpression(1 + indentationLevel, expression->leftExpression);
-			_output(1 + indentationLevel, "%s%c%s", "[ $", _expressionTypeToCharacter(expression->type), "$, circle, draw, purple ]\n");
-			_generateExpression(1 + indentationLevel, expression->rightExpression);
+			_generateExpression(outputSink, 1 + indentationLevel, expression->leftExpression);
+			_output(outputSink, 1 + indentationLevel, "%s%c%s", "[ $", _expressionTypeToCharacter(expression->type), "$, circle, draw, purple ]\n");
+			_generateExpression(outputSink, 1 + indentationLevel, expression->rightExpression);
 			break;
 		case FACTOR:
-			_generateFactor(1 + indentationLevel, expression->factor);
+			_generateFactor(outputSink, 1 + indentationLevel, expression->factor);
 			break;
 		default:
-			logError(_logger, "The specified expression type is unknown: %d", expression->type);
+			LOG_ERROR(_logger, "The specified expression type is unknown: %d", expression->type);
 			break;
 	}
-	_output(indentationLevel, "%s", "]\n");
+	_output(outputSink, indentationLevel, "%s", "]\n");
 }
 
 /**
  * Generates the output of a factor.
  */
-static void _generateFactor(const unsigned int indentationLevel, Factor * factor) {
-	_output(indentationLevel, "%s", "[ $F$, circle, draw, black!20\n");
+static void _generateFactor(OutputSink * outputSink, const unsigned int indentationLevel, Factor * factor) {
+	_output(outputSink, indentationLevel, "%s", "[ $F$, circle, draw, black!20\n");
 	switch (factor->type) {
 		case CONSTANT:
-			_generateConstant(1 + indentationLevel, factor->constant);
+			_generateConstant(outputSink, 1 + indentationLevel, factor->constant->value);
 			break;
 		case EXPRESSION:
-			_output(1 + indentationLevel, "%s", "[ $($, circle, draw, purple ]\n");
-			_generateExpression(1 + indentationLevel, factor->expression);
-			_output(1 + indentationLevel, "%s", "[ $)$, circle, draw, purple ]\n");
+		case IMPORTED_EXPRESSION:
+			_output(outputSink, 1 + indentationLevel, "%s", "[ $($, circle, draw, purple ]\n");
+			_generateExpression(outputSink, 1 + indentationLevel, innerExpression(factor));
+			_output(outputSink, 1 + indentationLevel, "%s", "[ $)$, circle, draw, purple ]\n");
+			break;
+		default:
+			LOG_ERROR(_logger, "The specified factor type is unknown: %d", factor->type);
+			break;
+	}
+	_output(outputSink, indentationLevel, "%s", "]\n");
+}
+
+/**
+ * Generates the output of a flat node as an expression. The output is the
+ * same as the one of the equivalent pointer-based tree.
+ */
+static void _generateFlatExpression(OutputSink * outputSink, const unsigned int indentationLevel, const FlatSyntaxTree * flatSyntaxTree, const NodeIndex index) {
+	const FlatNode * node = &flatSyntaxTree->nodes[index];
+	_output(outputSink, indentationLevel, "%s", "[ $E$, circle, draw, black!20\n");
+	switch (node->type) {
+		case ADDITION_NODE:
+		case DIVISION_NODE:
+		case MULTIPLICATION_NODE:
+		case SUBTRACTION_NODE:
+			_generateFlatExpression(outputSink, 1 + indentationLevel, flatSyntaxTree, node->leftExpression);
+			_output(outputSink, 1 + indentationLevel, "%s%c%s", "[ $", _flatNodeTypeToCharacter(node->type), "$, circle, draw, purple ]\n");
+			_generateFlatExpression(outputSink, 1 + indentationLevel, flatSyntaxTree, node->rightExpression);
+			break;
+		case CONSTANT_NODE:
+		case PARENTHESIS_NODE:
+			_generateFlatFactor(outputSink, 1 + indentationLevel, flatSyntaxTree, index);
 			break;
 		default:
-			logError(_logger, "The specified factor type is unknown: %d", factor->type);
+			LOG_ERROR(_logger, "The specified flat node type is unknown: %d", node->type);
 			break;
 	}
-	_output(indentationLevel, "%s", "]\n");
+	_output(outputSink, indentationLevel, "%s", "]\n");
+}
+
+/**
+ * Generates the output of a flat node as a factor.
+ */
+static void _generateFlatFactor(OutputSink * outputSink, const unsigned int indentationLevel, const FlatSyntaxTree * flatSyntaxTree, const NodeIndex index) {
+	const FlatNode * node = &flatSyntaxTree->nodes[index];
+	_output(outputSink, indentationLevel, "%s", "[ $F$, circle, draw, black!20\n");
+	switch (node->type) {
+		case CONSTANT_NODE:
+			_generateConstant(outputSink, 1 + indentationLevel, node->value);
+			break;
+		case PARENTHESIS_NODE:
+			_output(outputSink, 1 + indentationLevel, "%s", "[ $($, circle, draw, purple ]\n");
+			_generateFlatExpression(outputSink, 1 + indentationLevel, flatSyntaxTree, node->expression);
+			_output(outputSink, 1 + indentationLevel, "%s", "[ $)$, circle, draw, purple ]\n");
+			break;
+		default:
+			LOG_ERROR(_logger, "The specified flat node type is not a factor: %d", node->type);
+			break;
+	}
+	_output(outputSink, indentationLevel, "%s", "]\n");
 }
 
 /**
  * Generates the output of the program.
  */
-static void _generateProgram(Program * program) {
-	_generateExpression(3, program->expression);
+static void _generateProgram(OutputSink * outputSink, Program * program) {
+	_generateExpression(outputSink, 3, program->expression);
 }
 
 /**
@@ -128,8 +205,8 @@ static void _generateProgram(Program * program) {
  *
  * @see https://ctan.dcc.uchile.cl/graphics/pgf/contrib/forest/forest-doc.pdf
  */
-static void _generatePrologue(void) {
-	_output(0, "%s",
+static void _generatePrologue(OutputSink * outputSink) {
+	_output(outputSink, 0, "%s",
 		"\\documentclass{standalone}\n\n"
 		"\\usepackage[utf8]{inputenc}\n"
 		"\\usepackage[T1]{fontenc}\n"
@@ -144,35 +221,47 @@ static void _generatePrologue(void) {
 }
 
 /**
- * Generates an indentation string for the specified level.
+ * Writes the indentation for the specified level, copying it from a block of
+ * blanks prepared beforehand, so no string is built per line.
  */
-static char * _indentation(const unsigned int level) {
-	return indentation(_indentationCharacter, level, _indentationSize);
+static void _indent(OutputSink * outputSink, const unsigned int indentationLevel) {
+	size_t length = indentationLevel * _indentationSize;
+	while (sizeof(_indentationBlock) < length) {
+		writeToOutputSink(outputSink, _indentationBlock, sizeof(_indentationBlock));
+		length -= sizeof(_indentationBlock);
+	}
+	writeToOutputSink(outputSink, _indentationBlock, length);
 }
 
 /**
- * Outputs a formatted string to standard output. The "fflush" instruction
- * allows to see the output even close to a failure, because it drops the
- * buffering.
+ * Outputs a formatted string to the output sink, which buffers the generated
+ * document and writes it to the output of the compilation in large blocks. To see every
+ * line as soon as it's generated (e.g., close to a failure), enable the
+ * "OUTPUT_FLUSH_EVERY_LINE" option.
  */
-static void _output(const unsigned int indentationLevel, const char * const format, ...) {
+static void _output(OutputSink * outputSink, const unsigned int indentationLevel, const char * const format, ...) {
 	va_list arguments;
 	va_start(arguments, format);
-	char * indentation = _indentation(indentationLevel);
-	char * effectiveFormat = concatenate(2, indentation, format);
-	vfprintf(stdout, effectiveFormat, arguments);
-	fflush(stdout);
-	free(effectiveFormat);
-	free(indentation);
+	_indent(outputSink, indentationLevel);
+	formatToOutputSink(outputSink, format, arguments);
 	va_end(arguments);
 }
 
 /** PUBLIC FUNCTIONS */
 
 void executeGenerator(CompilerState * compilerState) {
-	logDebugging(_logger, "Generating final output...");
-	_generatePrologue();
-	_generateProgram(compilerState->abstractSyntaxtTree);
-	_generateEpilogue(compilerState->value);
-	logDebugging(_logger, "Generation is done.");
+	LOG_DEBUGGING(_logger, "Generating final output...");
+	OutputSink * outputSink = createOutputSink(compilerState->output, _flushThreshold, _flushEveryLine);
+	_generatePrologue(outputSink);
+	FlatSyntaxTree * flatSyntaxTree = compilerState->flatSyntaxTree;
+	if (flatSyntaxTree != NULL) {
+		_generateFlatExpression(outputSink, 3, flatSyntaxTree, flatSyntaxTree->root);
+	}
+	else {
+		_generateProgram(outputSink, compilerState->abstractSyntaxtTree);
+	}
+	_generateEpilogue(outputSink, compilerState->value);
+	compilerState->metrics.outputBytes += outputSink->writtenBytes;
+	destroyOutputSink(outputSink);
+	LOG_DEBUGGING(_logger, "Generation is done.");
 }
@@ -2,12 +2,16 @@
 #define GENERATOR_HEADER
 
 #include "../../frontend/syntactic-analysis/AbstractSyntaxTree.h"
-#include "../../support/language/String.h"
+#include "../../frontend/syntactic-analysis/FlatSyntaxTree.h"
+#include "../../support/configuration/Environment.h"
 #include "../../support/logging/Logger.h"
+#include "../../support/output/OutputSink.h"
 #include "../../support/type/CompilerState.h"
 #include "../../support/type/ModuleDestructor.h"
 #include <stdarg.h>
+#include <stdbool.h>
 #include <stdio.h>
+#include <string.h>
 
 /** Initialize module's internal state. */
 ModuleDestructor initializeGeneratorModule();
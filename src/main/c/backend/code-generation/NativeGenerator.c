@@ -0,0 +1,301 @@
+#include "NativeGenerator.h"
+
+/* MODULE INTERNAL STATE */
+
+static bool _flushEveryLine = false;
+static size_t _flushThreshold = 65536;
+static Logger * _logger = NULL;
+
+/**
+ * The amount of statements of every block (i.e., a function of the generated
+ * code). Small functions keep the time and the memory of the C compiler
+ * linear in the size of the program.
+ */
+static const size_t _statementsPerBlock = 1024;
+
+/**
+ * The state of an emission: the blocks emitted so far, and the height of the
+ * stack of the generated code, after the last statement.
+ */
+typedef struct {
+	size_t blockCount;
+	size_t blockStatements;
+	size_t height;
+	size_t maximumHeight;
+	OutputSink * outputSink;
+} NativeEmission;
+
+/**
+ * A pending step of the post-order traversal of the pointer-based tree:
+ * either visit an expression, or emit its operation.
+ */
+typedef struct {
+	Expression * expression;
+	bool combine;
+} EmissionStep;
+
+/** Shutdown module's internal state. */
+void _shutdownNativeGeneratorModule() {
+	if (_logger != NULL) {
+		LOG_DEBUGGING(_logger, "Destroying module: NativeGenerator...");
+		destroyLogger(_logger);
+		_logger = NULL;
+	}
+}
+
+ModuleDestructor initializeNativeGeneratorModule() {
+	_logger = createLogger("NativeGenerator");
+	_flushEveryLine = getBooleanOrDefault("OUTPUT_FLUSH_EVERY_LINE", false);
+	const long flushThreshold = getIntegerOrDefault("OUTPUT_FLUSH_THRESHOLD", _flushThreshold);
+	if (0 <= flushThreshold) {
+		_flushThreshold = flushThreshold;
+	}
+	return _shutdownNativeGeneratorModule;
+}
+
+/** PRIVATE FUNCTIONS */
+
+static void _emitAbstractSyntaxTree(NativeEmission * emission, Program * program);
+static void _emitConstant(NativeEmission * emission, const int value);
+static void _emitFlatSyntaxTree(NativeEmission * emission, const FlatSyntaxTree * flatSyntaxTree);
+static void _emitOperation(NativeEmission * emission, const char operator);
+static void _emitStatement(NativeEmission * emission, const char * const format, ...);
+static const char _expressionTypeToOperator(const ExpressionType type);
+static const char _flatNodeTypeToOperator(const FlatNodeType type);
+static void _generateEpilogue(NativeEmission * emission);
+static void _generatePrologue(OutputSink * outputSink);
+static void _output(OutputSink * outputSink, const char * const format, ...);
+
+/**
+ * Emits the operations of a pointer-based tree in post-order, with an
+ * explicit stack in heap-memory. The parenthesized expressions are traversed
+ * in place, because a factor doesn't change the result of its inner
+ * expression.
+ */
+static void _emitAbstractSyntaxTree(NativeEmission * emission, Program * program) {
+	size_t capacity = 64;
+	size_t count = 0;
+	EmissionStep * steps = malloc(capacity * sizeof(EmissionStep));
+	steps[count++] = (EmissionStep) { .expression = program->expression, .combine = false };
+	while (0 < count) {
+		const EmissionStep step = steps[--count];
+		Expression * expression = step.expression;
+		if (step.combine) {
+			_emitOperation(emission, _expressionTypeToOperator(expression->type));
+			continue;
+		}
+		while (expression->type == FACTOR && expression->factor->type != CONSTANT) {
+			expression = innerExpression(expression->factor);
+		}
+		if (expression->type == FACTOR) {
+			_emitConstant(emission, expression->factor->constant->value);
+			continue;
+		}
+		if (capacity < count + 3) {
+			capacity *= 2;
+			steps = realloc(steps, capacity * sizeof(EmissionStep));
+		}
+		steps[count++] = (EmissionStep) { .expression = expression, .combine = true };
+		steps[count++] = (EmissionStep) { .expression = expression->rightExpression, .combine = false };
+		steps[count++] = (EmissionStep) { .expression = expression->leftExpression, .combine = false };
+	}
+	free(steps);
+}
+
+/**
+ * Emits a statement that pushes a constant.
+ */
+static void _emitConstant(NativeEmission * emission, const int value) {
+	_emitStatement(emission, "\tvalues[%zu] = %du;\n\tfailures[%zu] = false;\n", emission->height, value, emission->height);
+	if (emission->maximumHeight < ++emission->height) {
+		emission->maximumHeight = emission->height;
+	}
+}
+
+/**
+ * Emits the operations of a flat table. The parser appends the nodes in
+ * post-order, so the subtree of the root is a contiguous range of the table,
+ * emitted with a single linear scan.
+ */
+static void _emitFlatSyntaxTree(NativeEmission * emission, const FlatSyntaxTree * flatSyntaxTree) {
+	const FlatNode * nodes = flatSyntaxTree->nodes;
+	const NodeIndex root = flatSyntaxTree->root;
+	for (NodeIndex k = 1 + root - nodes[root].size; k <= root; ++k) {
+		switch (nodes[k].type) {
+			case CONSTANT_NODE:
+				_emitConstant(emission, nodes[k].value);
+				break;
+			case PARENTHESIS_NODE:
+				break;
+			default:
+				_emitOperation(emission, _flatNodeTypeToOperator(nodes[k].type));
+				break;
+		}
+	}
+}
+
+/**
+ * Emits a statement that combines the two results on top of the stack. The
+ * division is a function of the generated code; the other operations are
+ * inlined, and propagate the failure of their operands.
+ */
+static void _emitOperation(NativeEmission * emission, const char operator) {
+	emission->height -= 2;
+	const size_t left = emission->height;
+	const size_t right = 1 + emission->height;
+	if (operator == '/') {
+		_emitStatement(emission, "\tdivide(%zu);\n", left);
+	}
+	else {
+		_emitStatement(emission, "\tvalues[%zu] %c= values[%zu];\n\tfailures[%zu] |= failures[%zu];\n", left, operator, right, left, right);
+	}
+	++emission->height;
+}
+
+/**
+ * Emits a statement in the current block, opening a new block before the
+ * first statement, and closing it after the last one.
+ */
+static void _emitStatement(NativeEmission * emission, const char * const format, ...) {
+	if (emission->blockStatements == 0) {
+		_output(emission->outputSink, "static void block%zu(void) {\n", emission->blockCount);
+	}
+	va_list arguments;
+	va_start(arguments, format);
+	formatToOutputSink(emission->outputSink, format, arguments);
+	va_end(arguments);
+	if (++emission->blockStatements == _statementsPerBlock) {
+		_output(emission->outputSink, "%s", "}\n\n");
+		emission->blockStatements = 0;
+		++emission->blockCount;
+	}
+}
+
+/**
+ * Converts an expression type to the operator of the generated code, or
+ * returns '\0' if that's not possible.
+ */
+static const char _expressionTypeToOperator(const ExpressionType type) {
+	switch (type) {
+		case ADDITION: return '+';
+		case DIVISION: return '/';
+		case MULTIPLICATION: return '*';
+		case SUBTRACTION: return '-';
+		default:
+			LOG_ERROR(_logger, "The specified expression type cannot be converted into an operator: %d", type);
+			return '\0';
+	}
+}
+
+/**
+ * Analog to "_expressionTypeToOperator", but for the type of a flat node.
+ */
+static const char _flatNodeTypeToOperator(const FlatNodeType type) {
+	switch (type) {
+		case ADDITION_NODE: return '+';
+		case DIVISION_NODE: return '/';
+		case MULTIPLICATION_NODE: return '*';
+		case SUBTRACTION_NODE: return '-';
+		default:
+			LOG_ERROR(_logger, "The specified flat node type cannot be converted into an operator: %d", type);
+			return '\0';
+	}
+}
+
+/**
+ * Closes the last block, and creates the entry-point of the generated code,
+ * that executes every block in order, and prints the result.
+ */
+static void _generateEpilogue(NativeEmission * emission) {
+	OutputSink * outputSink = emission->outputSink;
+	if (0 < emission->blockStatements) {
+		_output(outputSink, "%s", "}\n\n");
+		++emission->blockCount;
+	}
+	_output(outputSink, "%s", "int main(void) {\n");
+	_output(outputSink, "\tstatic unsigned int valueSlots[%zu];\n", emission->maximumHeight);
+	_output(outputSink, "\tstatic bool failureSlots[%zu];\n", emission->maximumHeight);
+	_output(outputSink, "%s",
+		"\tvalues = valueSlots;\n"
+		"\tfailures = failureSlots;\n"
+	);
+	for (size_t k = 0; k < emission->blockCount; ++k) {
+		_output(outputSink, "\tblock%zu();\n", k);
+	}
+	_output(outputSink, "%s",
+		"\tif (failures[0]) {\n"
+		"\t\treturn 1;\n"
+		"\t}\n"
+		"\tprintf(\"%d\\n\", wrap(values[0]));\n"
+		"\treturn 0;\n"
+		"}\n"
+	);
+}
+
+/**
+ * Creates the prologue of the generated code. The stack holds unsigned
+ * integers, whose arithmetic wraps around without undefined behavior, and a
+ * failure flag for each one, set by a division by zero (see "Calculator.c").
+ */
+static void _generatePrologue(OutputSink * outputSink) {
+	_output(outputSink, "%s",
+		"#include <limits.h>\n"
+		"#include <stdbool.h>\n"
+		"#include <stdio.h>\n\n"
+		"static bool * failures = NULL;\n"
+		"static unsigned int * values = NULL;\n\n"
+		"static int wrap(const unsigned int value) {\n"
+		"\treturn value <= INT_MAX ? (int) value : -(int) (UINT_MAX - value) - 1;\n"
+		"}\n\n"
+		"static inline void divide(const unsigned int k) {\n"
+		"\tconst int dividend = wrap(values[k]);\n"
+		"\tconst int divisor = wrap(values[k + 1]);\n"
+		"\tif (failures[k] || failures[k + 1]) {\n"
+		"\t\tfailures[k] = true;\n"
+		"\t}\n"
+		"\telse if (divisor == 0) {\n"
+		"\t\tfprintf(stderr, \"The divisor cannot be zero (the computation was %d/%d).\\n\", dividend, divisor);\n"
+		"\t\tfailures[k] = true;\n"
+		"\t\tvalues[k] = dividend < 0 ? -INT_MAX : INT_MAX;\n"
+		"\t}\n"
+		"\telse if (dividend != INT_MIN || divisor != -1) {\n"
+		"\t\tvalues[k] = dividend / divisor;\n"
+		"\t}\n"
+		"}\n\n"
+	);
+}
+
+/**
+ * Outputs a formatted string to the output sink (see "Generator.c").
+ */
+static void _output(OutputSink * outputSink, const char * const format, ...) {
+	va_list arguments;
+	va_start(arguments, format);
+	formatToOutputSink(outputSink, format, arguments);
+	va_end(arguments);
+}
+
+/** PUBLIC FUNCTIONS */
+
+void executeNativeGenerator(CompilerState * compilerState) {
+	LOG_DEBUGGING(_logger, "Generating C code...");
+	NativeEmission emission = {
+		.blockCount = 0,
+		.blockStatements = 0,
+		.height = 0,
+		.maximumHeight = 0,
+		.outputSink = createOutputSink(compilerState->output, _flushThreshold, _flushEveryLine)
+	};
+	_generatePrologue(emission.outputSink);
+	FlatSyntaxTree * flatSyntaxTree = compilerState->flatSyntaxTree;
+	if (flatSyntaxTree != NULL) {
+		_emitFlatSyntaxTree(&emission, flatSyntaxTree);
+	}
+	else {
+		_emitAbstractSyntaxTree(&emission, compilerState->abstractSyntaxtTree);
+	}
+	_generateEpilogue(&emission);
+	compilerState->metrics.outputBytes += emission.outputSink->writtenBytes;
+	destroyOutputSink(emission.outputSink);
+	LOG_DEBUGGING(_logger, "Generation is done.");
+}
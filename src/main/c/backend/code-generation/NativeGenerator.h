@@ -0,0 +1,29 @@
+#ifndef NATIVE_GENERATOR_HEADER
+#define NATIVE_GENERATOR_HEADER
+
+#include "../../frontend/syntactic-analysis/AbstractSyntaxTree.h"
+#include "../../frontend/syntactic-analysis/FlatSyntaxTree.h"
+#include "../../support/configuration/Environment.h"
+#include "../../support/logging/Logger.h"
+#include "../../support/output/OutputSink.h"
+#include "../../support/type/CompilerState.h"
+#include "../../support/type/ModuleDestructor.h"
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+/** Initialize module's internal state. */
+ModuleDestructor initializeNativeGeneratorModule();
+
+/**
+ * Generates a standalone C translation unit that computes the program, and
+ * prints its value (see "GENERATOR_TARGET"). The generated code keeps the
+ * semantics of the calculator: integers wrap around on overflow, and a
+ * division by zero fails the entire computation (then, the program exits
+ * with status 1). The operations are emitted as straight-line code over an
+ * explicit stack, split in blocks, so any tree compiles regardless of its
+ * depth.
+ */
+void executeNativeGenerator(CompilerState * compilerState);
+
+#endif
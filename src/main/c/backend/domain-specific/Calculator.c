@@ -2,12 +2,129 @@
 
 /* MODULE INTERNAL STATE */
 
+/**
+ * The strategies to evaluate a tree (see "CALCULATOR_ENGINE").
+ */
+typedef enum {
+	ITERATIVE_ENGINE,
+	PARALLEL_ENGINE,
+	RECURSIVE_ENGINE
+} CalculatorEngine;
+
+static CalculatorEngine _engine = ITERATIVE_ENGINE;
 static Logger * _logger = NULL;
+static const long _maximumThreadCount = 1 << 10;
+static uint32_t _parallelThreshold = 4096;
+static WorkStealingPool * _workStealingPool = NULL;
+
+/**
+ * A pending step of the iterative evaluation: either visit an expression, or
+ * combine the results of its children, which are on top of the result stack.
+ */
+typedef struct {
+	Expression * expression;
+	bool combine;
+} EvaluationStep;
+
+/**
+ * The explicit stacks of the iterative evaluation, that live in heap-memory.
+ */
+typedef struct {
+	ComputationResult * results;
+	unsigned int resultCapacity;
+	unsigned int resultCount;
+	EvaluationStep * steps;
+	unsigned int stepCapacity;
+	unsigned int stepCount;
+} EvaluationStacks;
+
+struct ConstantFolder {
+	EvaluationStacks stacks;
+};
+
+/**
+ * A division by zero found by a parallel evaluation. Its position is the
+ * post-order index of the node in the tree (or of the first node of the
+ * segment evaluated serially), and its sequence orders the divisions found
+ * inside the same segment.
+ */
+typedef struct {
+	int dividend;
+	uint32_t position;
+	uint32_t sequence;
+} DivisionByZero;
+
+/**
+ * The shared state of a parallel evaluation. Every thread evaluates a
+ * different segment of the tree, so the divisions by zero are collected here
+ * and logged at the end, in the same order the serial engines log them.
+ */
+typedef struct {
+	DivisionByZero * divisionsByZero;
+	size_t divisionByZeroCapacity;
+	size_t divisionByZeroCount;
+	const FlatSyntaxTree * flatSyntaxTree;
+	pthread_mutex_t mutex;
+	const NodeInterner * nodeInterner;
+} ParallelEvaluation;
+
+/**
+ * Where the current thread defers the divisions by zero, if it's evaluating a
+ * segment of a parallel evaluation.
+ */
+typedef struct {
+	ParallelEvaluation * evaluation;
+	uint32_t position;
+	uint32_t sequence;
+} DivisionByZeroDeferral;
+
+static __thread DivisionByZeroDeferral _deferral = { 0 };
+
+/**
+ * The interner of the compilation the current thread is computing (if any),
+ * where the values of the shared expressions are memoized.
+ */
+static __thread const NodeInterner * _nodeInterner = NULL;
+
+/**
+ * A subtree in any layout: a pointer-based expression, or the index of a flat
+ * node if the evaluation has a flat table.
+ */
+typedef struct {
+	Expression * expression;
+	NodeIndex index;
+} Subtree;
+
+/**
+ * The argument of a parallel task: the subtree to evaluate, the post-order
+ * index of its first node, and the result.
+ */
+typedef struct {
+	ParallelEvaluation * evaluation;
+	uint32_t position;
+	ComputationResult result;
+	Subtree subtree;
+} SubtreeEvaluation;
+
+/**
+ * An ancestor along the spine of a parallel task, whose other child is small
+ * enough to be already computed.
+ */
+typedef struct {
+	ComputationResult operand;
+	bool operandIsLeft;
+	uint32_t position;
+	ExpressionType type;
+} PendingCombination;
 
 /** Shutdown module's internal state. */
 void _shutdownCalculatorModule() {
+	if (_workStealingPool != NULL) {
+		destroyWorkStealingPool(_workStealingPool);
+		_workStealingPool = NULL;
+	}
 	if (_logger != NULL) {
-		logDebugging(_logger, "Destroying module: Calculator...");
+		LOG_DEBUGGING(_logger, "Destroying module: Calculator...");
 		destroyLogger(_logger);
 		_logger = NULL;
 	}
@@ -15,14 +132,234 @@ void _shutdownCalculatorModule() {
 
 ModuleDestructor initializeCalculatorModule() {
 	_logger = createLogger("Calculator");
+	const char * engine = getStringOrDefault("CALCULATOR_ENGINE", "ITERATIVE");
+	if (strcmp(engine, "PARALLEL") == 0) {
+		_engine = PARALLEL_ENGINE;
+		const long parallelThreshold = getIntegerOrDefault("CALCULATOR_PARALLEL_THRESHOLD", _parallelThreshold);
+		if (0 <= parallelThreshold && parallelThreshold <= UINT32_MAX) {
+			_parallelThreshold = parallelThreshold;
+		}
+		else {
+			LOG_WARNING(_logger, "The threshold CALCULATOR_PARALLEL_THRESHOLD=%ld is ignored (it must be between 0 and %u).", parallelThreshold, UINT32_MAX);
+		}
+		long threadCount = getIntegerOrDefault("CALCULATOR_THREADS", 0);
+		if (threadCount < 0 || _maximumThreadCount < threadCount) {
+			LOG_WARNING(_logger, "The amount of threads CALCULATOR_THREADS=%ld is ignored (it must be between 0 and %ld).", threadCount, _maximumThreadCount);
+			threadCount = 0;
+		}
+		_workStealingPool = createWorkStealingPool(threadCount);
+		LOG_DEBUGGING(_logger, "Evaluating in parallel with %u threads.", _workStealingPool->workerCount);
+	}
+	else {
+		_engine = strcmp(engine, "RECURSIVE") == 0 ? RECURSIVE_ENGINE : ITERATIVE_ENGINE;
+	}
 	return _shutdownCalculatorModule;
 }
 
 /** PRIVATE FUNCTIONS */
 
+static ComputationResult _combine(const ExpressionType type, const ComputationResult leftResult, const ComputationResult rightResult);
+static ComputationResult _combineDeferred(ParallelEvaluation * evaluation, const uint32_t position, const ExpressionType type, const ComputationResult leftResult, const ComputationResult rightResult);
+static int _compareDivisionsByZero(const void * left, const void * right);
+static ComputationResult _computeSegment(ParallelEvaluation * evaluation, const Subtree subtree, const uint32_t position);
+static void _computeSubtreeInParallel(void * argument);
+static void _deferDivisionByZero(const int dividend);
+static void _destroyEvaluationStacks(EvaluationStacks * stacks);
 static BinaryOperator _expressionTypeToBinaryOperator(const ExpressionType type);
+static ExpressionType _flatNodeTypeToExpressionType(const FlatNodeType type);
+static BinaryOperator _flatNodeTypeToBinaryOperator(const FlatNodeType type);
 static ComputationResult _invalidBinaryOperator(const int x, const int y);
 static ComputationResult _invalidComputation();
+static bool _isMemoized(const Import * import);
+static bool _isMemoizedExpression(const SharedExpression * sharedExpression);
+static ComputationResult _iterativeComputeExpression(Expression * expression);
+static ComputationResult _iterativeComputeFlatNode(const FlatSyntaxTree * flatSyntaxTree, const NodeIndex index);
+static Subtree _leftSubtree(const ParallelEvaluation * evaluation, const Subtree subtree);
+static void _memoize(Import * import, const ComputationResult computationResult);
+static ComputationResult _memoizedExpressionResult(const SharedExpression * sharedExpression);
+static ComputationResult _memoizedResult(const Import * import);
+static void _memoizeExpression(SharedExpression * sharedExpression, const ComputationResult computationResult);
+static ComputationResult _parallelCompute(const FlatSyntaxTree * flatSyntaxTree, Expression * expression);
+static ComputationResult _popResult(EvaluationStacks * stacks);
+static void _pushResult(EvaluationStacks * stacks, const ComputationResult result);
+static void _pushStep(EvaluationStacks * stacks, Expression * expression, const bool combine);
+static Subtree _rightSubtree(const ParallelEvaluation * evaluation, const Subtree subtree);
+static uint32_t _subtreeSize(const ParallelEvaluation * evaluation, const Subtree subtree);
+static ExpressionType _subtreeType(const ParallelEvaluation * evaluation, const Subtree subtree);
+static Subtree _unwrapSubtree(const ParallelEvaluation * evaluation, const Subtree subtree);
+
+/**
+ * Combines the results of the children of an arithmetic expression, exactly
+ * as "computeExpression" does, but without an indirect call.
+ */
+static ComputationResult _combine(const ExpressionType type, const ComputationResult leftResult, const ComputationResult rightResult) {
+	if (leftResult.succeeded && rightResult.succeeded) {
+		switch (type) {
+			case ADDITION: return add(leftResult.value, rightResult.value);
+			case DIVISION: return divide(leftResult.value, rightResult.value);
+			case MULTIPLICATION: return multiply(leftResult.value, rightResult.value);
+			case SUBTRACTION: return subtract(leftResult.value, rightResult.value);
+			default:
+				return _invalidBinaryOperator(leftResult.value, rightResult.value);
+		}
+	}
+	else {
+		return _invalidComputation();
+	}
+}
+
+/**
+ * Analog to "_combine", but the division by zero (if any) is deferred to the
+ * parallel evaluation, at the position of the combined node.
+ */
+static ComputationResult _combineDeferred(ParallelEvaluation * evaluation, const uint32_t position, const ExpressionType type, const ComputationResult leftResult, const ComputationResult rightResult) {
+	_deferral.evaluation = evaluation;
+	_deferral.position = position;
+	_deferral.sequence = 0;
+	ComputationResult computationResult = _combine(type, leftResult, rightResult);
+	_deferral.evaluation = NULL;
+	return computationResult;
+}
+
+/**
+ * Orders the divisions by zero of a parallel evaluation as the serial engines
+ * find them (i.e., in post-order).
+ */
+static int _compareDivisionsByZero(const void * left, const void * right) {
+	const DivisionByZero * leftDivision = left;
+	const DivisionByZero * rightDivision = right;
+	if (leftDivision->position != rightDivision->position) {
+		return leftDivision->position < rightDivision->position ? -1 : 1;
+	}
+	return leftDivision->sequence < rightDivision->sequence ? -1 : leftDivision->sequence > rightDivision->sequence;
+}
+
+/**
+ * Evaluates a small subtree serially, with the iterative engine, deferring
+ * its divisions by zero to the parallel evaluation.
+ */
+static ComputationResult _computeSegment(ParallelEvaluation * evaluation, const Subtree subtree, const uint32_t position) {
+	// A worker can steal segments of other compilations while it joins:
+	const NodeInterner * nodeInterner = _nodeInterner;
+	_nodeInterner = evaluation->nodeInterner;
+	_deferral.evaluation = evaluation;
+	_deferral.position = position;
+	_deferral.sequence = 0;
+	ComputationResult computationResult = evaluation->flatSyntaxTree != NULL
+		? _iterativeComputeFlatNode(evaluation->flatSyntaxTree, subtree.index)
+		: _iterativeComputeExpression(subtree.expression);
+	_deferral.evaluation = NULL;
+	_nodeInterner = nodeInterner;
+	return computationResult;
+}
+
+/**
+ * The task of a parallel evaluation. It walks down the tree while one of the
+ * children is small, computing that child serially; when both children are
+ * larger than the threshold, it forks the left one, computes the right one
+ * itself, and joins. So, a degenerate tree (e.g., a long chain) is walked
+ * without recursion, and forks only happen where there is real parallelism.
+ */
+static void _computeSubtreeInParallel(void * argument) {
+	SubtreeEvaluation * subtreeEvaluation = argument;
+	ParallelEvaluation * evaluation = subtreeEvaluation->evaluation;
+	Subtree subtree = subtreeEvaluation->subtree;
+	uint32_t position = subtreeEvaluation->position;
+	PendingCombination * pending = NULL;
+	size_t pendingCapacity = 0;
+	size_t pendingCount = 0;
+	ComputationResult computationResult;
+	while (true) {
+		subtree = _unwrapSubtree(evaluation, subtree);
+		const uint32_t size = _subtreeSize(evaluation, subtree);
+		const ExpressionType type = _subtreeType(evaluation, subtree);
+		if (type == FACTOR || size <= _parallelThreshold) {
+			computationResult = _computeSegment(evaluation, subtree, position);
+			break;
+		}
+		const Subtree leftSubtree = _leftSubtree(evaluation, subtree);
+		const Subtree rightSubtree = _rightSubtree(evaluation, subtree);
+		const uint32_t leftSize = _subtreeSize(evaluation, leftSubtree);
+		const uint32_t rightSize = _subtreeSize(evaluation, rightSubtree);
+		if (_parallelThreshold < leftSize && _parallelThreshold < rightSize) {
+			SubtreeEvaluation leftEvaluation = {
+				.evaluation = evaluation,
+				.position = position,
+				.subtree = leftSubtree
+			};
+			SubtreeEvaluation rightEvaluation = {
+				.evaluation = evaluation,
+				.position = position + leftSize,
+				.subtree = rightSubtree
+			};
+			ForkJoinTask leftTask = {
+				.task = _computeSubtreeInParallel,
+				.argument = &leftEvaluation
+			};
+			forkInWorkStealingPool(_workStealingPool, &leftTask);
+			_computeSubtreeInParallel(&rightEvaluation);
+			joinInWorkStealingPool(_workStealingPool, &leftTask);
+			computationResult = _combineDeferred(evaluation, position + size - 1, type, leftEvaluation.result, rightEvaluation.result);
+			break;
+		}
+		if (pendingCount == pendingCapacity) {
+			pendingCapacity = pendingCapacity == 0 ? 64 : 2 * pendingCapacity;
+			pending = realloc(pending, pendingCapacity * sizeof(PendingCombination));
+		}
+		PendingCombination * combination = &pending[pendingCount++];
+		combination->position = position + size - 1;
+		combination->type = type;
+		if (_parallelThreshold < leftSize) {
+			combination->operand = _computeSegment(evaluation, rightSubtree, position + leftSize);
+			combination->operandIsLeft = false;
+			subtree = leftSubtree;
+		}
+		else {
+			combination->operand = _computeSegment(evaluation, leftSubtree, position);
+			combination->operandIsLeft = true;
+			subtree = rightSubtree;
+			position += leftSize;
+		}
+	}
+	while (0 < pendingCount) {
+		const PendingCombination combination = pending[--pendingCount];
+		computationResult = combination.operandIsLeft
+			? _combineDeferred(evaluation, combination.position, combination.type, combination.operand, computationResult)
+			: _combineDeferred(evaluation, combination.position, combination.type, computationResult, combination.operand);
+	}
+	free(pending);
+	subtreeEvaluation->result = computationResult;
+}
+
+/**
+ * Stores a division by zero of the current thread in its parallel evaluation,
+ * instead of logging it.
+ */
+static void _deferDivisionByZero(const int dividend) {
+	ParallelEvaluation * evaluation = _deferral.evaluation;
+	pthread_mutex_lock(&evaluation->mutex);
+	if (evaluation->divisionByZeroCount == evaluation->divisionByZeroCapacity) {
+		evaluation->divisionByZeroCapacity = evaluation->divisionByZeroCapacity == 0 ? 16 : 2 * evaluation->divisionByZeroCapacity;
+		evaluation->divisionsByZero = realloc(evaluation->divisionsByZero, evaluation->divisionByZeroCapacity * sizeof(DivisionByZero));
+	}
+	DivisionByZero divisionByZero = {
+		.dividend = dividend,
+		.position = _deferral.position,
+		.sequence = _deferral.sequence++
+	};
+	evaluation->divisionsByZero[evaluation->divisionByZeroCount++] = divisionByZero;
+	pthread_mutex_unlock(&evaluation->mutex);
+}
+
+/**
+ * Releases the explicit stacks of an iterative evaluation.
+ */
+static void _destroyEvaluationStacks(EvaluationStacks * stacks) {
+	free(stacks->results);
+	free(stacks->steps);
+	stacks->results = NULL;
+	stacks->steps = NULL;
+}
 
 /**
  * Converts and expression type to the proper binary operator. If that's not
@@ -36,7 +373,37 @@ static BinaryOperator _expressionTypeToBinaryOperator(const ExpressionType type)
 		case MULTIPLICATION: return multiply;
 		case SUBTRACTION: return subtract;
 		default:
-			logError(_logger, "The specified expression type cannot be converted into character: %d", type);
+			LOG_ERROR(_logger, "The specified expression type cannot be converted into character: %d", type);
+			return _invalidBinaryOperator;
+	}
+}
+
+/**
+ * Converts the type of a binary flat node into the equivalent expression
+ * type, or FACTOR if the node is not a binary one.
+ */
+static ExpressionType _flatNodeTypeToExpressionType(const FlatNodeType type) {
+	switch (type) {
+		case ADDITION_NODE: return ADDITION;
+		case DIVISION_NODE: return DIVISION;
+		case MULTIPLICATION_NODE: return MULTIPLICATION;
+		case SUBTRACTION_NODE: return SUBTRACTION;
+		default: return FACTOR;
+	}
+}
+
+/**
+ * Analog to "_expressionTypeToBinaryOperator", but for the type of a flat
+ * node.
+ */
+static BinaryOperator _flatNodeTypeToBinaryOperator(const FlatNodeType type) {
+	switch (type) {
+		case ADDITION_NODE: return add;
+		case DIVISION_NODE: return divide;
+		case MULTIPLICATION_NODE: return multiply;
+		case SUBTRACTION_NODE: return subtract;
+		default:
+			LOG_ERROR(_logger, "The specified flat node type cannot be converted into character: %d", type);
 			return _invalidBinaryOperator;
 	}
 }
@@ -59,6 +426,297 @@ static ComputationResult _invalidComputation() {
 	return computationResult;
 }
 
+/**
+ * Whether the value of a shared import is already computed.
+ */
+static bool _isMemoized(const Import * import) {
+	return __atomic_load_n(&import->memoized, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * Whether the value of a shared expression is already computed.
+ */
+static bool _isMemoizedExpression(const SharedExpression * sharedExpression) {
+	return sharedExpression != NULL && __atomic_load_n(&sharedExpression->memoized, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * Computes an expression in post-order, using explicit stacks in heap-memory
+ * instead of the native one, so the depth of the tree is unbounded. The
+ * parenthesized expressions are traversed in place, because a factor doesn't
+ * change the result of its inner expression. The imported ones too, but
+ * their value is memoized afterwards (with a combination step, over the
+ * factor), so any other import of the same file is computed once. The same
+ * goes for the shared expressions (see "NodeInterner.h"), whatever their
+ * type.
+ */
+static ComputationResult _iterativeComputeExpression(Expression * expression) {
+	EvaluationStacks stacks = { 0 };
+	_pushStep(&stacks, expression, false);
+	while (0 < stacks.stepCount) {
+		EvaluationStep step = stacks.steps[--stacks.stepCount];
+		Expression * current = step.expression;
+		if (step.combine) {
+			if (current->type != FACTOR) {
+				ComputationResult rightResult = _popResult(&stacks);
+				ComputationResult leftResult = _popResult(&stacks);
+				_pushResult(&stacks, _combine(current->type, leftResult, rightResult));
+			}
+			else if (current->factor->type == IMPORTED_EXPRESSION) {
+				_memoize(current->factor->import, stacks.results[stacks.resultCount - 1]);
+			}
+			_memoizeExpression(findSharedExpression(_nodeInterner, current), stacks.results[stacks.resultCount - 1]);
+			continue;
+		}
+		SharedExpression * sharedExpression = NULL;
+		bool memoized = false;
+		while (!(memoized = _isMemoizedExpression(sharedExpression = findSharedExpression(_nodeInterner, current))) && current->type == FACTOR && current->factor->type != CONSTANT) {
+			if (current->factor->type == IMPORTED_EXPRESSION && _isMemoized(current->factor->import)) {
+				break;
+			}
+			if (current->factor->type == IMPORTED_EXPRESSION || sharedExpression != NULL) {
+				_pushStep(&stacks, current, true);
+			}
+			current = innerExpression(current->factor);
+		}
+		if (memoized) {
+			_pushResult(&stacks, _memoizedExpressionResult(sharedExpression));
+		}
+		else if (current->type == FACTOR) {
+			_pushResult(&stacks, current->factor->type == IMPORTED_EXPRESSION
+				? _memoizedResult(current->factor->import)
+				: computeConstant(current->factor->constant));
+		}
+		else {
+			_pushStep(&stacks, current, true);
+			_pushStep(&stacks, current->rightExpression, false);
+			_pushStep(&stacks, current->leftExpression, false);
+		}
+	}
+	ComputationResult computationResult = _popResult(&stacks);
+	_destroyEvaluationStacks(&stacks);
+	return computationResult;
+}
+
+/**
+ * Computes the subtree of a flat table rooted at the specified node. The
+ * parser appends the nodes in post-order, so the subtree is the contiguous
+ * range that ends at its root, and a single linear scan evaluates it.
+ */
+static ComputationResult _iterativeComputeFlatNode(const FlatSyntaxTree * flatSyntaxTree, const NodeIndex index) {
+	EvaluationStacks stacks = { 0 };
+	const FlatNode * nodes = flatSyntaxTree->nodes;
+	for (NodeIndex k = 1 + index - nodes[index].size; k <= index; ++k) {
+		switch (nodes[k].type) {
+			case CONSTANT_NODE: {
+				ComputationResult computationResult = {
+					.succeeded = true,
+					.value = nodes[k].value
+				};
+				_pushResult(&stacks, computationResult);
+				break;
+			}
+			case PARENTHESIS_NODE:
+				break;
+			default: {
+				ComputationResult rightResult = _popResult(&stacks);
+				ComputationResult leftResult = _popResult(&stacks);
+				_pushResult(&stacks, _combine(_flatNodeTypeToExpressionType(nodes[k].type), leftResult, rightResult));
+				break;
+			}
+		}
+	}
+	ComputationResult computationResult = _popResult(&stacks);
+	_destroyEvaluationStacks(&stacks);
+	return computationResult;
+}
+
+/**
+ * The left child of an arithmetic subtree.
+ */
+static Subtree _leftSubtree(const ParallelEvaluation * evaluation, const Subtree subtree) {
+	Subtree leftSubtree = { 0 };
+	if (evaluation->flatSyntaxTree != NULL) {
+		leftSubtree.index = evaluation->flatSyntaxTree->nodes[subtree.index].leftExpression;
+	}
+	else {
+		leftSubtree.expression = subtree.expression->leftExpression;
+	}
+	return leftSubtree;
+}
+
+/**
+ * Stores the value of a shared import, if it succeeded. A failed one is
+ * computed again by every import, so its errors are logged every time.
+ */
+static void _memoize(Import * import, const ComputationResult computationResult) {
+	if (computationResult.succeeded) {
+		__atomic_store_n(&import->value, computationResult.value, __ATOMIC_RELAXED);
+		__atomic_store_n(&import->memoized, true, __ATOMIC_RELEASE);
+	}
+}
+
+/**
+ * The memoized value of a shared expression.
+ */
+static ComputationResult _memoizedExpressionResult(const SharedExpression * sharedExpression) {
+	ComputationResult computationResult = {
+		.succeeded = true,
+		.value = __atomic_load_n(&sharedExpression->value, __ATOMIC_RELAXED)
+	};
+	return computationResult;
+}
+
+/**
+ * The memoized value of a shared import.
+ */
+static ComputationResult _memoizedResult(const Import * import) {
+	ComputationResult computationResult = {
+		.succeeded = true,
+		.value = __atomic_load_n(&import->value, __ATOMIC_RELAXED)
+	};
+	return computationResult;
+}
+
+/**
+ * Stores the value of a shared expression, if it succeeded (as "_memoize").
+ * An expression that isn't shared (i.e., NULL) is not memoized.
+ */
+static void _memoizeExpression(SharedExpression * sharedExpression, const ComputationResult computationResult) {
+	if (sharedExpression != NULL && computationResult.succeeded) {
+		__atomic_store_n(&sharedExpression->value, computationResult.value, __ATOMIC_RELAXED);
+		__atomic_store_n(&sharedExpression->memoized, true, __ATOMIC_RELEASE);
+	}
+}
+
+/**
+ * Computes a tree on the work-stealing pool (see "_computeSubtreeInParallel"),
+ * and then logs the divisions by zero found. A tree below the threshold is
+ * computed serially by the calling thread.
+ */
+static ComputationResult _parallelCompute(const FlatSyntaxTree * flatSyntaxTree, Expression * expression) {
+	ParallelEvaluation evaluation = {
+		.divisionsByZero = NULL,
+		.divisionByZeroCapacity = 0,
+		.divisionByZeroCount = 0,
+		.flatSyntaxTree = flatSyntaxTree,
+		.nodeInterner = _nodeInterner
+	};
+	SubtreeEvaluation rootEvaluation = {
+		.evaluation = &evaluation,
+		.position = 0,
+		.subtree = {
+			.expression = expression,
+			.index = flatSyntaxTree != NULL ? flatSyntaxTree->root : 0
+		}
+	};
+	if (_subtreeSize(&evaluation, rootEvaluation.subtree) <= _parallelThreshold) {
+		return flatSyntaxTree != NULL
+			? _iterativeComputeFlatNode(flatSyntaxTree, flatSyntaxTree->root)
+			: _iterativeComputeExpression(expression);
+	}
+	pthread_mutex_init(&evaluation.mutex, NULL);
+	ForkJoinTask rootTask = {
+		.task = _computeSubtreeInParallel,
+		.argument = &rootEvaluation
+	};
+	invokeInWorkStealingPool(_workStealingPool, &rootTask);
+	pthread_mutex_destroy(&evaluation.mutex);
+	qsort(evaluation.divisionsByZero, evaluation.divisionByZeroCount, sizeof(DivisionByZero), _compareDivisionsByZero);
+	for (size_t k = 0; k < evaluation.divisionByZeroCount; ++k) {
+		LOG_ERROR(_logger, "The divisor cannot be zero (the computation was %d/%d).", evaluation.divisionsByZero[k].dividend, 0);
+	}
+	free(evaluation.divisionsByZero);
+	return rootEvaluation.result;
+}
+
+/**
+ * Pops the result on top of the result stack.
+ */
+static ComputationResult _popResult(EvaluationStacks * stacks) {
+	return stacks->results[--stacks->resultCount];
+}
+
+/**
+ * Pushes a result to the result stack, growing it if needed.
+ */
+static void _pushResult(EvaluationStacks * stacks, const ComputationResult result) {
+	if (stacks->resultCount == stacks->resultCapacity) {
+		stacks->resultCapacity = stacks->resultCapacity == 0 ? 64 : 2 * stacks->resultCapacity;
+		stacks->results = realloc(stacks->results, stacks->resultCapacity * sizeof(ComputationResult));
+	}
+	stacks->results[stacks->resultCount++] = result;
+}
+
+/**
+ * Pushes a step to the step stack, growing it if needed.
+ */
+static void _pushStep(EvaluationStacks * stacks, Expression * expression, const bool combine) {
+	if (stacks->stepCount == stacks->stepCapacity) {
+		stacks->stepCapacity = stacks->stepCapacity == 0 ? 64 : 2 * stacks->stepCapacity;
+		stacks->steps = realloc(stacks->steps, stacks->stepCapacity * sizeof(EvaluationStep));
+	}
+	EvaluationStep step = {
+		.expression = expression,
+		.combine = combine
+	};
+	stacks->steps[stacks->stepCount++] = step;
+}
+
+/**
+ * The right child of an arithmetic subtree.
+ */
+static Subtree _rightSubtree(const ParallelEvaluation * evaluation, const Subtree subtree) {
+	Subtree rightSubtree = { 0 };
+	if (evaluation->flatSyntaxTree != NULL) {
+		rightSubtree.index = evaluation->flatSyntaxTree->nodes[subtree.index].rightExpression;
+	}
+	else {
+		rightSubtree.expression = subtree.expression->rightExpression;
+	}
+	return rightSubtree;
+}
+
+/**
+ * The amount of nodes of a subtree, counted by the parser.
+ */
+static uint32_t _subtreeSize(const ParallelEvaluation * evaluation, const Subtree subtree) {
+	return evaluation->flatSyntaxTree != NULL
+		? evaluation->flatSyntaxTree->nodes[subtree.index].size
+		: subtree.expression->size;
+}
+
+/**
+ * The type of the root of an unwrapped subtree, where FACTOR means a
+ * constant (or a shared import).
+ */
+static ExpressionType _subtreeType(const ParallelEvaluation * evaluation, const Subtree subtree) {
+	return evaluation->flatSyntaxTree != NULL
+		? _flatNodeTypeToExpressionType(evaluation->flatSyntaxTree->nodes[subtree.index].type)
+		: subtree.expression->type;
+}
+
+/**
+ * Skips the parentheses around a subtree. They are the last nodes of the
+ * subtree in post-order, so its first node doesn't change. A shared import
+ * is kept as a factor, so it's computed serially (and only once).
+ */
+static Subtree _unwrapSubtree(const ParallelEvaluation * evaluation, const Subtree subtree) {
+	Subtree innerSubtree = subtree;
+	if (evaluation->flatSyntaxTree != NULL) {
+		const FlatNode * nodes = evaluation->flatSyntaxTree->nodes;
+		while (nodes[innerSubtree.index].type == PARENTHESIS_NODE) {
+			innerSubtree.index = nodes[innerSubtree.index].expression;
+		}
+	}
+	else {
+		while (innerSubtree.expression->type == FACTOR && innerSubtree.expression->factor->type == EXPRESSION) {
+			innerSubtree.expression = innerSubtree.expression->factor->expression;
+		}
+	}
+	return innerSubtree;
+}
+
 /** PUBLIC FUNCTIONS */
 
 ComputationResult add(const int leftAddend, const int rightAddend) {
@@ -72,8 +730,11 @@ ComputationResult add(const int leftAddend, const int rightAddend) {
 ComputationResult divide(const int dividend, const int divisor) {
 	const int sign = dividend < 0 ? -1 : +1;
 	const bool divisionByZero = divisor == 0 ? true : false;
-	if (divisionByZero) {
-		logError(_logger, "The divisor cannot be zero (the computation was %d/%d).", dividend, divisor);
+	if (divisionByZero && _deferral.evaluation != NULL) {
+		_deferDivisionByZero(dividend);
+	}
+	else if (divisionByZero) {
+		LOG_ERROR(_logger, "The divisor cannot be zero (the computation was %d/%d).", dividend, divisor);
 	}
 	ComputationResult computationResult = {
 		.succeeded = divisionByZero ? false : true,
@@ -98,6 +759,35 @@ ComputationResult subtract(const int minuend, const int subtract) {
 	return computationResult;
 }
 
+ConstantFolder * createConstantFolder() {
+	return calloc(1, sizeof(ConstantFolder));
+}
+
+void destroyConstantFolder(ConstantFolder * constantFolder) {
+	if (constantFolder != NULL) {
+		_destroyEvaluationStacks(&constantFolder->stacks);
+		free(constantFolder);
+	}
+}
+
+void foldArithmeticExpression(ConstantFolder * constantFolder, const ExpressionType type) {
+	ComputationResult rightResult = _popResult(&constantFolder->stacks);
+	ComputationResult leftResult = _popResult(&constantFolder->stacks);
+	_pushResult(&constantFolder->stacks, _combine(type, leftResult, rightResult));
+}
+
+void foldConstant(ConstantFolder * constantFolder, const int value) {
+	ComputationResult computationResult = {
+		.succeeded = true,
+		.value = value
+	};
+	_pushResult(&constantFolder->stacks, computationResult);
+}
+
+ComputationResult peekConstantFolder(const ConstantFolder * constantFolder) {
+	return constantFolder->stacks.results[constantFolder->stacks.resultCount - 1];
+}
+
 ComputationResult computeConstant(Constant * constant) {
 	ComputationResult computationResult = {
 		.succeeded = true,
@@ -107,25 +797,36 @@ ComputationResult computeConstant(Constant * constant) {
 }
 
 ComputationResult computeExpression(Expression * expression) {
+	SharedExpression * sharedExpression = findSharedExpression(_nodeInterner, expression);
+	if (_isMemoizedExpression(sharedExpression)) {
+		return _memoizedExpressionResult(sharedExpression);
+	}
+	ComputationResult computationResult;
 	switch (expression->type) {
 		case ADDITION:
 		case DIVISION:
 		case MULTIPLICATION:
-		case SUBTRACTION:
+		case SUBTRACTION: {
 			ComputationResult leftResult = computeExpression(expression->leftExpression);
 			ComputationResult rightResult = computeExpression(expression->rightExpression);
 			if (leftResult.succeeded && rightResult.succeeded) {
 				BinaryOperator binaryOperator = _expressionTypeToBinaryOperator(expression->type);
-				return binaryOperator(leftResult.value, rightResult.value);
+				computationResult = binaryOperator(leftResult.value, rightResult.value);
 			}
 			else {
-				return _invalidComputation();
+				computationResult = _invalidComputation();
 			}
+			break;
+		}
 		case FACTOR:
-			return computeFactor(expression->factor);
+			computationResult = computeFactor(expression->factor);
+			break;
 		default:
-			return _invalidComputation();
+			computationResult = _invalidComputation();
+			break;
 	}
+	_memoizeExpression(sharedExpression, computationResult);
+	return computationResult;
 }
 
 ComputationResult computeFactor(Factor * factor) {
@@ -134,12 +835,75 @@ ComputationResult computeFactor(Factor * factor) {
 			return computeConstant(factor->constant);
 		case EXPRESSION:
 			return computeExpression(factor->expression);
+		case IMPORTED_EXPRESSION:
+			return computeImport(factor->import);
+		default:
+			return _invalidComputation();
+	}
+}
+
+ComputationResult computeImport(Import * import) {
+	if (_isMemoized(import)) {
+		return _memoizedResult(import);
+	}
+	ComputationResult computationResult = computeExpression(import->expression);
+	_memoize(import, computationResult);
+	return computationResult;
+}
+
+ComputationResult computeFlatNode(const FlatSyntaxTree * flatSyntaxTree, const NodeIndex index) {
+	const FlatNode * node = &flatSyntaxTree->nodes[index];
+	switch (node->type) {
+		case ADDITION_NODE:
+		case DIVISION_NODE:
+		case MULTIPLICATION_NODE:
+		case SUBTRACTION_NODE: {
+			ComputationResult leftResult = computeFlatNode(flatSyntaxTree, node->leftExpression);
+			ComputationResult rightResult = computeFlatNode(flatSyntaxTree, node->rightExpression);
+			if (leftResult.succeeded && rightResult.succeeded) {
+				BinaryOperator binaryOperator = _flatNodeTypeToBinaryOperator(node->type);
+				return binaryOperator(leftResult.value, rightResult.value);
+			}
+			else {
+				return _invalidComputation();
+			}
+		}
+		case CONSTANT_NODE: {
+			ComputationResult computationResult = {
+				.succeeded = true,
+				.value = node->value
+			};
+			return computationResult;
+		}
+		case PARENTHESIS_NODE:
+			return computeFlatNode(flatSyntaxTree, node->expression);
 		default:
 			return _invalidComputation();
 	}
 }
 
 ComputationResult executeCalculator(CompilerState * compilerState) {
+	ConstantFolder * constantFolder = compilerState->constantFolder;
+	FlatSyntaxTree * flatSyntaxTree = compilerState->flatSyntaxTree;
 	Program * program = compilerState->abstractSyntaxtTree;
-	return computeExpression(program->expression);
+	if (constantFolder != NULL) {
+		return _popResult(&constantFolder->stacks);
+	}
+	ComputationResult computationResult;
+	_nodeInterner = compilerState->nodeInterner;
+	if (_engine == PARALLEL_ENGINE) {
+		computationResult = _parallelCompute(flatSyntaxTree, flatSyntaxTree != NULL ? NULL : program->expression);
+	}
+	else if (_engine == RECURSIVE_ENGINE) {
+		computationResult = flatSyntaxTree != NULL
+			? computeFlatNode(flatSyntaxTree, flatSyntaxTree->root)
+			: computeExpression(program->expression);
+	}
+	else {
+		computationResult = flatSyntaxTree != NULL
+			? _iterativeComputeFlatNode(flatSyntaxTree, flatSyntaxTree->root)
+			: _iterativeComputeExpression(program->expression);
+	}
+	_nodeInterner = NULL;
+	return computationResult;
 }
@@ -7,11 +7,17 @@
  * domain-specific models or DTOs (Data Transfer Objects).
  */
 #include "../../frontend/syntactic-analysis/AbstractSyntaxTree.h"
+#include "../../frontend/syntactic-analysis/FlatSyntaxTree.h"
+#include "../../frontend/syntactic-analysis/NodeInterner.h"
+#include "../../support/concurrency/WorkStealingPool.h"
+#include "../../support/configuration/Environment.h"
 #include "../../support/logging/Logger.h"
 #include "../../support/type/CompilerState.h"
 #include "../../support/type/ModuleDestructor.h"
 #include <limits.h>
+#include <pthread.h>
 #include <stdbool.h>
+#include <stdint.h>
 
 /** Initialize module's internal state. */
 ModuleDestructor initializeCalculatorModule();
@@ -27,6 +33,14 @@ typedef struct {
 
 typedef ComputationResult (*BinaryOperator)(const int, const int);
 
+/**
+ * Computes the value of a program while it's being parsed, folding every
+ * constant and arithmetic expression as soon as the parser reduces it. It
+ * only stores the partial results, so its memory is proportional to the depth
+ * of the parser stack, not to the size of the program.
+ */
+typedef struct ConstantFolder ConstantFolder;
+
 /** Arithmetic operations. */
 
 ComputationResult add(const int leftAddend, const int rightAddend);
@@ -34,13 +48,41 @@ ComputationResult divide(const int dividend, const int divisor);
 ComputationResult multiply(const int multiplicand, const int multiplier);
 ComputationResult subtract(const int minuend, const int subtract);
 
+/**
+ * Creates a new constant folder, without partial results.
+ */
+ConstantFolder * createConstantFolder();
+
+/**
+ * Destroys a constant folder and its partial results.
+ */
+void destroyConstantFolder(ConstantFolder * constantFolder);
+
+/**
+ * Combines the two last partial results of the folder, as an arithmetic
+ * expression of the specified type.
+ */
+void foldArithmeticExpression(ConstantFolder * constantFolder, const ExpressionType type);
+
+/**
+ * Pushes a new constant as a partial result of the folder.
+ */
+void foldConstant(ConstantFolder * constantFolder, const int value);
+
+/**
+ * Returns the last partial result of the folder, without removing it.
+ */
+ComputationResult peekConstantFolder(const ConstantFolder * constantFolder);
+
 /**
  * Computes the final value of a mathematical constant.
  */
 ComputationResult computeConstant(Constant * constant);
 
 /**
- * Computes the final value of a mathematical expression.
+ * Computes the final value of a mathematical expression. The value of a shared
+ * expression (see "NodeInterner.h") is memoized in the interner of the
+ * compilation that the calculator is executing, so it's computed once.
  */
 ComputationResult computeExpression(Expression * expression);
 
@@ -50,7 +92,28 @@ ComputationResult computeExpression(Expression * expression);
 ComputationResult computeFactor(Factor * factor);
 
 /**
- * Computes the program value using the current compiler state.
+ * Computes the final value of an imported factor. Its successful value is
+ * memoized, so the subtree shared by the imports of the same file is only
+ * computed once.
+ */
+ComputationResult computeImport(Import * import);
+
+/**
+ * Computes the final value of the subtree rooted at the specified node of a
+ * flat table.
+ */
+ComputationResult computeFlatNode(const FlatSyntaxTree * flatSyntaxTree, const NodeIndex index);
+
+/**
+ * Computes the program value using the current compiler state. If the state
+ * carries a constant folder, the value was already computed while parsing, and
+ * it's just returned. Otherwise, by default, it
+ * evaluates the tree with explicit stacks in heap-memory, so arbitrarily deep
+ * trees don't overflow the native stack; the recursive functions above are
+ * used instead if the "CALCULATOR_ENGINE" variable is "RECURSIVE". If it's
+ * "PARALLEL", the subtrees larger than "CALCULATOR_PARALLEL_THRESHOLD" nodes
+ * are computed on a work-stealing pool of threads, with the same result and
+ * the same errors (logged in the same order) as the serial engines.
  */
 ComputationResult executeCalculator(CompilerState * compilerState);
 
@@ -0,0 +1,304 @@
+#include "Rebalancer.h"
+
+/* MODULE INTERNAL STATE */
+
+static Logger * _logger = NULL;
+
+/**
+ * A growable array of expressions, used as a worklist, or to hold the
+ * operands and operators of a run.
+ */
+typedef struct {
+	void ** items;
+	size_t capacity;
+	size_t count;
+} PointerArray;
+
+/**
+ * A pending task of the flat rebuild. The new table is written in post-order,
+ * so the tasks are executed in a stack: the children of a node are emitted
+ * before the task that combines them.
+ */
+typedef enum {
+	BALANCE_TASK,
+	COMBINE_TASK,
+	VISIT_TASK
+} FlatTaskType;
+
+typedef struct {
+	FlatTaskType type;
+	FlatNodeType nodeType;
+	NodeIndex index;
+	size_t start;
+	size_t count;
+} FlatTask;
+
+/** Shutdown module's internal state. */
+void _shutdownRebalancerModule() {
+	if (_logger != NULL) {
+		LOG_DEBUGGING(_logger, "Destroying module: Rebalancer...");
+		destroyLogger(_logger);
+		_logger = NULL;
+	}
+}
+
+ModuleDestructor initializeRebalancerModule() {
+	_logger = createLogger("Rebalancer");
+	return _shutdownRebalancerModule;
+}
+
+/** PRIVATE FUNCTIONS */
+
+static Expression * _balance(Expression ** operands, const size_t count, Expression ** operators, size_t * nextOperator, const ExpressionType type);
+static void _collectFlatRun(const FlatSyntaxTree * flatSyntaxTree, const NodeIndex root, NodeIndex ** operands, size_t * operandCapacity, size_t * operandCount);
+static void _collectRun(Expression * root, PointerArray * operands, PointerArray * operators, PointerArray * pending);
+static void _emitFlatNode(FlatSyntaxTree * flatSyntaxTree, const FlatNode node);
+static void _pushFlatTask(FlatTask ** tasks, size_t * capacity, size_t * count, const FlatTask task);
+static void _pushPointer(PointerArray * array, void * item);
+static void _rebalanceAbstractSyntaxTree(Program * program);
+static void _rebalanceFlatSyntaxTree(FlatSyntaxTree * flatSyntaxTree);
+
+/**
+ * Builds a balanced tree over the operands, in order, reusing the operator
+ * nodes of the original run. The first operator (the root of the run) is
+ * also the new root, so the parent of the run doesn't change. The recursion
+ * is as deep as the resulting tree (i.e., logarithmic).
+ */
+static Expression * _balance(Expression ** operands, const size_t count, Expression ** operators, size_t * nextOperator, const ExpressionType type) {
+	if (count == 1) {
+		return operands[0];
+	}
+	Expression * expression = operators[(*nextOperator)++];
+	const size_t half = count / 2;
+	expression->type = type;
+	expression->leftExpression = _balance(operands, half, operators, nextOperator, type);
+	expression->rightExpression = _balance(operands + half, count - half, operators, nextOperator, type);
+	expression->size = 1 + expression->leftExpression->size + expression->rightExpression->size;
+	return expression;
+}
+
+
+/**
+ * Collects the operands (from left to right) of the run rooted at the
+ * specified node of a flat table, after the operands already collected.
+ */
+static void _collectFlatRun(const FlatSyntaxTree * flatSyntaxTree, const NodeIndex root, NodeIndex ** operands, size_t * operandCapacity, size_t * operandCount) {
+	const FlatNodeType type = flatSyntaxTree->nodes[root].type;
+	size_t pendingCapacity = 16;
+	size_t pendingCount = 0;
+	NodeIndex * pending = malloc(pendingCapacity * sizeof(NodeIndex));
+	pending[pendingCount++] = root;
+	while (0 < pendingCount) {
+		const NodeIndex index = pending[--pendingCount];
+		const FlatNode * node = &flatSyntaxTree->nodes[index];
+		if (node->type == type) {
+			if (pendingCapacity < pendingCount + 2) {
+				pendingCapacity *= 2;
+				pending = realloc(pending, pendingCapacity * sizeof(NodeIndex));
+			}
+			pending[pendingCount++] = node->rightExpression;
+			pending[pendingCount++] = node->leftExpression;
+		}
+		else {
+			if (*operandCapacity == *operandCount) {
+				*operandCapacity = *operandCapacity == 0 ? 16 : 2 * *operandCapacity;
+				*operands = realloc(*operands, *operandCapacity * sizeof(NodeIndex));
+			}
+			(*operands)[(*operandCount)++] = index;
+		}
+	}
+	free(pending);
+}
+
+
+/**
+ * Collects the operands (from left to right) and the operators of the run
+ * rooted at the specified expression, without recursion.
+ */
+static void _collectRun(Expression * root, PointerArray * operands, PointerArray * operators, PointerArray * pending) {
+	operands->count = 0;
+	operators->count = 0;
+	pending->count = 0;
+	_pushPointer(pending, root);
+	while (0 < pending->count) {
+		Expression * expression = pending->items[--pending->count];
+		if (expression->type == root->type) {
+			_pushPointer(operators, expression);
+			_pushPointer(pending, expression->rightExpression);
+			_pushPointer(pending, expression->leftExpression);
+		}
+		else {
+			_pushPointer(operands, expression);
+		}
+	}
+}
+
+
+/**
+ * Appends a node to the rebuilt table. The children of an operator are the
+ * last nodes appended (see "FlatSyntaxTree.h"), so only its type is needed.
+ */
+static void _emitFlatNode(FlatSyntaxTree * flatSyntaxTree, const FlatNode node) {
+	FlatNode effectiveNode = node;
+	if (node.type == PARENTHESIS_NODE) {
+		effectiveNode.expression = flatSyntaxTree->count - 1;
+		effectiveNode.size = 1 + flatSyntaxTree->nodes[effectiveNode.expression].size;
+	}
+	else if (node.type != CONSTANT_NODE) {
+		effectiveNode.rightExpression = flatSyntaxTree->count - 1;
+		effectiveNode.leftExpression = effectiveNode.rightExpression - flatSyntaxTree->nodes[effectiveNode.rightExpression].size;
+		effectiveNode.size = 1
+			+ flatSyntaxTree->nodes[effectiveNode.leftExpression].size
+			+ flatSyntaxTree->nodes[effectiveNode.rightExpression].size;
+	}
+	appendFlatNode(flatSyntaxTree, effectiveNode);
+}
+
+
+/**
+ * Pushes a task of the flat rebuild.
+ */
+static void _pushFlatTask(FlatTask ** tasks, size_t * capacity, size_t * count, const FlatTask task) {
+	if (*capacity == *count) {
+		*capacity = *capacity == 0 ? 16 : 2 * *capacity;
+		*tasks = realloc(*tasks, *capacity * sizeof(FlatTask));
+	}
+	(*tasks)[(*count)++] = task;
+}
+
+
+/**
+ * Appends an item to a growable array.
+ */
+static void _pushPointer(PointerArray * array, void * item) {
+	if (array->count == array->capacity) {
+		array->capacity = array->capacity == 0 ? 16 : 2 * array->capacity;
+		array->items = realloc(array->items, array->capacity * sizeof(void *));
+	}
+	array->items[array->count++] = item;
+}
+
+
+/**
+ * Rebalances a tree of the pointer-based layout in place, without allocating
+ * nodes: every run is rewired with its own operator nodes.
+ */
+static void _rebalanceAbstractSyntaxTree(Program * program) {
+	PointerArray operands = { 0 };
+	PointerArray operators = { 0 };
+	PointerArray pending = { 0 };
+	PointerArray worklist = { 0 };
+	_pushPointer(&worklist, program->expression);
+	while (0 < worklist.count) {
+		Expression * expression = worklist.items[--worklist.count];
+		switch (expression->type) {
+			case ADDITION:
+			case MULTIPLICATION:
+				_collectRun(expression, &operands, &operators, &pending);
+				size_t nextOperator = 0;
+				_balance((Expression **) operands.items, operands.count, (Expression **) operators.items, &nextOperator, expression->type);
+				for (size_t k = 0; k < operands.count; ++k) {
+					_pushPointer(&worklist, operands.items[k]);
+				}
+				break;
+			case DIVISION:
+			case SUBTRACTION:
+				_pushPointer(&worklist, expression->rightExpression);
+				_pushPointer(&worklist, expression->leftExpression);
+				break;
+			case FACTOR:
+				if (expression->factor->type == EXPRESSION) {
+					_pushPointer(&worklist, expression->factor->expression);
+				}
+				else if (expression->factor->type == IMPORTED_EXPRESSION && !expression->factor->import->rebalanced) {
+					expression->factor->import->rebalanced = true;
+					expression->factor->import->depth = 0;
+					_pushPointer(&worklist, expression->factor->import->expression);
+				}
+				break;
+		}
+	}
+	free(operands.items);
+	free(operators.items);
+	free(pending.items);
+	free(worklist.items);
+}
+
+
+/**
+ * Rebalances a flat table, writing a new table in post-order and replacing
+ * the old one with it. Both have the same amount of nodes.
+ */
+static void _rebalanceFlatSyntaxTree(FlatSyntaxTree * flatSyntaxTree) {
+	if (flatSyntaxTree->count == 0) {
+		return;
+	}
+	FlatSyntaxTree * rebalanced = createFlatSyntaxTree(flatSyntaxTree->count);
+	NodeIndex * operands = NULL;
+	size_t operandCapacity = 0;
+	size_t operandCount = 0;
+	FlatTask * tasks = NULL;
+	size_t taskCapacity = 0;
+	size_t taskCount = 0;
+	_pushFlatTask(&tasks, &taskCapacity, &taskCount, (FlatTask) { .type = VISIT_TASK, .index = flatSyntaxTree->root });
+	while (0 < taskCount) {
+		const FlatTask task = tasks[--taskCount];
+		if (task.type == COMBINE_TASK) {
+			_emitFlatNode(rebalanced, (FlatNode) { .type = task.nodeType });
+		}
+		else if (task.type == BALANCE_TASK && task.count == 1) {
+			_pushFlatTask(&tasks, &taskCapacity, &taskCount, (FlatTask) { .type = VISIT_TASK, .index = operands[task.start] });
+		}
+		else if (task.type == BALANCE_TASK) {
+			const size_t half = task.count / 2;
+			_pushFlatTask(&tasks, &taskCapacity, &taskCount, (FlatTask) { .type = COMBINE_TASK, .nodeType = task.nodeType });
+			_pushFlatTask(&tasks, &taskCapacity, &taskCount, (FlatTask) { .type = BALANCE_TASK, .nodeType = task.nodeType, .start = task.start + half, .count = task.count - half });
+			_pushFlatTask(&tasks, &taskCapacity, &taskCount, (FlatTask) { .type = BALANCE_TASK, .nodeType = task.nodeType, .start = task.start, .count = half });
+		}
+		else {
+			const FlatNode node = flatSyntaxTree->nodes[task.index];
+			switch (node.type) {
+				case ADDITION_NODE:
+				case MULTIPLICATION_NODE: {
+					const size_t start = operandCount;
+					_collectFlatRun(flatSyntaxTree, task.index, &operands, &operandCapacity, &operandCount);
+					_pushFlatTask(&tasks, &taskCapacity, &taskCount, (FlatTask) { .type = BALANCE_TASK, .nodeType = node.type, .start = start, .count = operandCount - start });
+					break;
+				}
+				case CONSTANT_NODE:
+					_emitFlatNode(rebalanced, node);
+					break;
+				case PARENTHESIS_NODE:
+					_pushFlatTask(&tasks, &taskCapacity, &taskCount, (FlatTask) { .type = COMBINE_TASK, .nodeType = node.type });
+					_pushFlatTask(&tasks, &taskCapacity, &taskCount, (FlatTask) { .type = VISIT_TASK, .index = node.expression });
+					break;
+				default:
+					_pushFlatTask(&tasks, &taskCapacity, &taskCount, (FlatTask) { .type = COMBINE_TASK, .nodeType = node.type });
+					_pushFlatTask(&tasks, &taskCapacity, &taskCount, (FlatTask) { .type = VISIT_TASK, .index = node.rightExpression });
+					_pushFlatTask(&tasks, &taskCapacity, &taskCount, (FlatTask) { .type = VISIT_TASK, .index = node.leftExpression });
+			}
+		}
+	}
+	free(operands);
+	free(tasks);
+	// The old nodes may be mapped from a file, so the tables swap places, and
+	// the old one is destroyed as a whole:
+	const FlatSyntaxTree replaced = *flatSyntaxTree;
+	*flatSyntaxTree = *rebalanced;
+	flatSyntaxTree->root = rebalanced->count - 1;
+	*rebalanced = replaced;
+	destroyFlatSyntaxTree(rebalanced);
+}
+
+/* PUBLIC FUNCTIONS */
+
+void executeRebalancer(CompilerState * compilerState) {
+	if (compilerState->flatSyntaxTree != NULL) {
+		LOG_DEBUGGING(_logger, "Rebalancing the flat table...");
+		_rebalanceFlatSyntaxTree(compilerState->flatSyntaxTree);
+	}
+	else if (compilerState->abstractSyntaxtTree != NULL) {
+		LOG_DEBUGGING(_logger, "Rebalancing the AST...");
+		_rebalanceAbstractSyntaxTree(compilerState->abstractSyntaxtTree);
+	}
+}
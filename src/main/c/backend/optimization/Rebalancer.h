@@ -0,0 +1,28 @@
+#ifndef REBALANCER_HEADER
+#define REBALANCER_HEADER
+
+#include "../../frontend/syntactic-analysis/AbstractSyntaxTree.h"
+#include "../../frontend/syntactic-analysis/FlatSyntaxTree.h"
+#include "../../support/logging/Logger.h"
+#include "../../support/type/CompilerState.h"
+#include "../../support/type/ModuleDestructor.h"
+#include <stdbool.h>
+#include <stdlib.h>
+
+/** Initialize module's internal state. */
+ModuleDestructor initializeRebalancerModule();
+
+/**
+ * Rewrites every run of additions (or of multiplications) of the AST into a
+ * balanced tree. The grammar associates them to the left, so "1 + 2 + ... + n"
+ * is a spine as deep as its amount of terms; after this pass, its depth is
+ * logarithmic.
+ *
+ * The operands keep their order, and the integer arithmetic wraps around, so
+ * the value of the program doesn't change. Subtractions, divisions and
+ * parentheses bound the runs: they're never moved across. Both layouts are
+ * supported, and the evaluate-only mode (without AST) is left untouched.
+ */
+void executeRebalancer(CompilerState * compilerState);
+
+#endif
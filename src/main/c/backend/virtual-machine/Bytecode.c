@@ -0,0 +1,302 @@
+#include "Bytecode.h"
+
+/* MODULE INTERNAL STATE */
+
+static const char _magic[4] = { 'F', 'B', 'V', 'M' };
+static const uint32_t _version = 1;
+static Logger * _logger = NULL;
+
+/**
+ * The header of a stored bytecode. The words are stored with the endianness
+ * of the host that compiled them.
+ */
+typedef struct {
+	char magic[4];
+	uint32_t version;
+	uint32_t maximumStackDepth;
+	uint32_t length;
+} BytecodeHeader;
+
+/**
+ * A pending step of the lowering: either visit an expression, or emit the
+ * instruction of its operator, after the code of its children.
+ */
+typedef struct {
+	Expression * expression;
+	bool emitOperator;
+} LoweringStep;
+
+/** Shutdown module's internal state. */
+void _shutdownBytecodeModule() {
+	if (_logger != NULL) {
+		LOG_DEBUGGING(_logger, "Destroying module: Bytecode...");
+		destroyLogger(_logger);
+		_logger = NULL;
+	}
+}
+
+ModuleDestructor initializeBytecodeModule() {
+	_logger = createLogger("Bytecode");
+	return _shutdownBytecodeModule;
+}
+
+/** PRIVATE FUNCTIONS */
+
+static void _compileExpression(Bytecode * bytecode, Expression * expression);
+static void _compileFlatSyntaxTree(Bytecode * bytecode, const FlatSyntaxTree * flatSyntaxTree);
+static Bytecode * _createBytecode(const uint32_t capacity);
+static void _emit(Bytecode * bytecode, const int32_t word);
+static void _emitInstruction(Bytecode * bytecode, const Instruction instruction, uint32_t * stackDepth);
+static Instruction _expressionTypeToInstruction(const ExpressionType type);
+static Instruction _flatNodeTypeToInstruction(const FlatNodeType type);
+static bool _verifyBytecode(const Bytecode * bytecode);
+
+/**
+ * Emits the post-fix code of an expression, walking the tree with an explicit
+ * stack. Parenthesized expressions produce no code.
+ */
+static void _compileExpression(Bytecode * bytecode, Expression * expression) {
+	uint32_t stackDepth = 0;
+	unsigned int capacity = 64;
+	unsigned int count = 0;
+	LoweringStep * steps = calloc(capacity, sizeof(LoweringStep));
+	steps[count++] = (LoweringStep) { .expression = expression, .emitOperator = false };
+	while (0 < count) {
+		LoweringStep step = steps[--count];
+		Expression * current = step.expression;
+		if (step.emitOperator) {
+			_emitInstruction(bytecode, _expressionTypeToInstruction(current->type), &stackDepth);
+			continue;
+		}
+		while (current->type == FACTOR && current->factor->type != CONSTANT) {
+			current = innerExpression(current->factor);
+		}
+		if (current->type == FACTOR) {
+			_emitInstruction(bytecode, PUSH_INSTRUCTION, &stackDepth);
+			_emit(bytecode, current->factor->constant->value);
+			continue;
+		}
+		if (capacity < count + 3) {
+			capacity *= 2;
+			steps = realloc(steps, capacity * sizeof(LoweringStep));
+		}
+		steps[count++] = (LoweringStep) { .expression = current, .emitOperator = true };
+		steps[count++] = (LoweringStep) { .expression = current->rightExpression, .emitOperator = false };
+		steps[count++] = (LoweringStep) { .expression = current->leftExpression, .emitOperator = false };
+	}
+	free(steps);
+}
+
+/**
+ * Emits the post-fix code of a flat table, which is already stored in
+ * post-order.
+ */
+static void _compileFlatSyntaxTree(Bytecode * bytecode, const FlatSyntaxTree * flatSyntaxTree) {
+	uint32_t stackDepth = 0;
+	const FlatNode * nodes = flatSyntaxTree->nodes;
+	const NodeIndex root = flatSyntaxTree->root;
+	for (NodeIndex k = 1 + root - nodes[root].size; k <= root; ++k) {
+		switch (nodes[k].type) {
+			case CONSTANT_NODE:
+				_emitInstruction(bytecode, PUSH_INSTRUCTION, &stackDepth);
+				_emit(bytecode, nodes[k].value);
+				break;
+			case PARENTHESIS_NODE:
+				break;
+			default:
+				_emitInstruction(bytecode, _flatNodeTypeToInstruction(nodes[k].type), &stackDepth);
+				break;
+		}
+	}
+}
+
+/**
+ * Creates an empty bytecode, with room for the specified amount of words.
+ * Returns NULL if there is no memory for it.
+ */
+static Bytecode * _createBytecode(const uint32_t capacity) {
+	Bytecode * bytecode = calloc(1, sizeof(Bytecode));
+	int32_t * code = calloc(capacity, sizeof(int32_t));
+	if (bytecode == NULL || code == NULL) {
+		free(bytecode);
+		free(code);
+		return NULL;
+	}
+	bytecode->capacity = capacity;
+	bytecode->code = code;
+	bytecode->length = 0;
+	bytecode->maximumStackDepth = 0;
+	return bytecode;
+}
+
+/**
+ * Appends a word to the code, growing it if needed.
+ */
+static void _emit(Bytecode * bytecode, const int32_t word) {
+	if (bytecode->length == bytecode->capacity) {
+		bytecode->capacity = bytecode->capacity == 0 ? 64 : 2 * bytecode->capacity;
+		bytecode->code = realloc(bytecode->code, bytecode->capacity * sizeof(int32_t));
+	}
+	bytecode->code[bytecode->length++] = word;
+}
+
+/**
+ * Appends an instruction to the code, and tracks the depth of the operand
+ * stack after its execution.
+ */
+static void _emitInstruction(Bytecode * bytecode, const Instruction instruction, uint32_t * stackDepth) {
+	_emit(bytecode, instruction);
+	if (instruction == PUSH_INSTRUCTION) {
+		++*stackDepth;
+		if (bytecode->maximumStackDepth < *stackDepth) {
+			bytecode->maximumStackDepth = *stackDepth;
+		}
+	}
+	else if (instruction != HALT_INSTRUCTION) {
+		--*stackDepth;
+	}
+}
+
+/**
+ * Converts an arithmetic expression type to its instruction.
+ */
+static Instruction _expressionTypeToInstruction(const ExpressionType type) {
+	switch (type) {
+		case ADDITION: return ADD_INSTRUCTION;
+		case DIVISION: return DIVIDE_INSTRUCTION;
+		case MULTIPLICATION: return MULTIPLY_INSTRUCTION;
+		case SUBTRACTION: return SUBTRACT_INSTRUCTION;
+		default:
+			LOG_ERROR(_logger, "The specified expression type cannot be converted into an instruction: %d", type);
+			return HALT_INSTRUCTION;
+	}
+}
+
+/**
+ * Analog to "_expressionTypeToInstruction", but for the type of a flat node.
+ */
+static Instruction _flatNodeTypeToInstruction(const FlatNodeType type) {
+	switch (type) {
+		case ADDITION_NODE: return ADD_INSTRUCTION;
+		case DIVISION_NODE: return DIVIDE_INSTRUCTION;
+		case MULTIPLICATION_NODE: return MULTIPLY_INSTRUCTION;
+		case SUBTRACTION_NODE: return SUBTRACT_INSTRUCTION;
+		default:
+			LOG_ERROR(_logger, "The specified flat node type cannot be converted into an instruction: %d", type);
+			return HALT_INSTRUCTION;
+	}
+}
+
+/**
+ * Checks that a loaded bytecode is safe to execute: every instruction is
+ * known, the operand stack never underflows nor exceeds its declared depth,
+ * and the code ends with a HALT_INSTRUCTION that leaves a single value.
+ */
+static bool _verifyBytecode(const Bytecode * bytecode) {
+	uint32_t stackDepth = 0;
+	for (uint32_t k = 0; k < bytecode->length; ++k) {
+		switch (bytecode->code[k]) {
+			case PUSH_INSTRUCTION:
+				if (bytecode->length <= ++k || bytecode->maximumStackDepth < ++stackDepth) {
+					return false;
+				}
+				break;
+			case ADD_INSTRUCTION:
+			case DIVIDE_INSTRUCTION:
+			case MULTIPLY_INSTRUCTION:
+			case SUBTRACT_INSTRUCTION:
+				if (stackDepth < 2) {
+					return false;
+				}
+				--stackDepth;
+				break;
+			case HALT_INSTRUCTION:
+				return k + 1 == bytecode->length && stackDepth == 1;
+			default:
+				return false;
+		}
+	}
+	return false;
+}
+
+/** PUBLIC FUNCTIONS */
+
+Bytecode * compileBytecode(CompilerState * compilerState) {
+	LOG_DEBUGGING(_logger, "Lowering the AST into bytecode...");
+	Bytecode * bytecode = _createBytecode(64);
+	FlatSyntaxTree * flatSyntaxTree = compilerState->flatSyntaxTree;
+	if (flatSyntaxTree != NULL) {
+		_compileFlatSyntaxTree(bytecode, flatSyntaxTree);
+	}
+	else {
+		Program * program = compilerState->abstractSyntaxtTree;
+		_compileExpression(bytecode, program->expression);
+	}
+	_emit(bytecode, HALT_INSTRUCTION);
+	LOG_DEBUGGING(_logger, "Lowering is done (length=%u, maximumStackDepth=%u).", bytecode->length, bytecode->maximumStackDepth);
+	return bytecode;
+}
+
+void destroyBytecode(Bytecode * bytecode) {
+	if (bytecode != NULL) {
+		if (bytecode->code != NULL) {
+			free(bytecode->code);
+			bytecode->code = NULL;
+		}
+		free(bytecode);
+	}
+}
+
+Bytecode * loadBytecode(const char * path) {
+	FILE * file = fopen(path, "rb");
+	if (file == NULL) {
+		LOG_ERROR(_logger, "Cannot open the bytecode file: \"%s\".", path);
+		return NULL;
+	}
+	BytecodeHeader header;
+	struct stat status;
+	Bytecode * bytecode = NULL;
+	// The length must be the one of the code stored, before allocating it:
+	if (fread(&header, sizeof(BytecodeHeader), 1, file) == 1
+		&& memcmp(header.magic, _magic, sizeof(_magic)) == 0
+		&& header.version == _version
+		&& 0 < header.length
+		&& fstat(fileno(file), &status) == 0
+		&& (size_t) status.st_size == sizeof(BytecodeHeader) + (size_t) header.length * sizeof(int32_t)) {
+		bytecode = _createBytecode(header.length);
+	}
+	if (bytecode != NULL) {
+		bytecode->length = header.length;
+		bytecode->maximumStackDepth = header.maximumStackDepth;
+		if (fread(bytecode->code, sizeof(int32_t), header.length, file) != header.length || !_verifyBytecode(bytecode)) {
+			destroyBytecode(bytecode);
+			bytecode = NULL;
+		}
+	}
+	fclose(file);
+	if (bytecode == NULL) {
+		LOG_ERROR(_logger, "The file is not a valid bytecode for this compiler: \"%s\".", path);
+	}
+	return bytecode;
+}
+
+bool saveBytecode(const Bytecode * bytecode, const char * path) {
+	FILE * file = fopen(path, "wb");
+	if (file == NULL) {
+		LOG_ERROR(_logger, "Cannot create the bytecode file: \"%s\".", path);
+		return false;
+	}
+	BytecodeHeader header = {
+		.version = _version,
+		.maximumStackDepth = bytecode->maximumStackDepth,
+		.length = bytecode->length
+	};
+	memcpy(header.magic, _magic, sizeof(_magic));
+	const bool succeeded = fwrite(&header, sizeof(BytecodeHeader), 1, file) == 1
+		&& fwrite(bytecode->code, sizeof(int32_t), bytecode->length, file) == bytecode->length;
+	if (fclose(file) != 0 || !succeeded) {
+		LOG_ERROR(_logger, "Cannot write the bytecode file: \"%s\".", path);
+		return false;
+	}
+	return true;
+}
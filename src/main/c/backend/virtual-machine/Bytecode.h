@@ -0,0 +1,68 @@
+#ifndef BYTECODE_HEADER
+#define BYTECODE_HEADER
+
+#include "../../frontend/syntactic-analysis/AbstractSyntaxTree.h"
+#include "../../frontend/syntactic-analysis/FlatSyntaxTree.h"
+#include "../../support/logging/Logger.h"
+#include "../../support/type/CompilerState.h"
+#include "../../support/type/ModuleDestructor.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+/** Initialize module's internal state. */
+ModuleDestructor initializeBytecodeModule();
+
+/**
+ * The instructions of the stack-based virtual machine. Every instruction is
+ * a single word, except PUSH_INSTRUCTION, which is followed by the constant
+ * to push.
+ */
+typedef enum {
+	ADD_INSTRUCTION,
+	DIVIDE_INSTRUCTION,
+	HALT_INSTRUCTION,
+	MULTIPLY_INSTRUCTION,
+	PUSH_INSTRUCTION,
+	SUBTRACT_INSTRUCTION
+} Instruction;
+
+/**
+ * A program lowered into post-fix order. The code always ends with a
+ * HALT_INSTRUCTION, and the maximum depth of the operand stack is known
+ * beforehand.
+ */
+typedef struct {
+	int32_t * code;
+	uint32_t capacity;
+	uint32_t length;
+	uint32_t maximumStackDepth;
+} Bytecode;
+
+/**
+ * Lowers the AST of the compiler state (in any layout) into bytecode. The
+ * traversal uses an explicit stack, so the depth of the tree is unbounded.
+ */
+Bytecode * compileBytecode(CompilerState * compilerState);
+
+/**
+ * Destroys a bytecode and its resources.
+ */
+void destroyBytecode(Bytecode * bytecode);
+
+/**
+ * Loads a bytecode previously stored with "saveBytecode". Returns NULL if the
+ * file cannot be read, if it's not a valid bytecode for this version of the
+ * compiler (e.g., it's truncated), or if there is no memory for it.
+ */
+Bytecode * loadBytecode(const char * path);
+
+/**
+ * Stores a bytecode in a file. Returns true if it succeeds.
+ */
+bool saveBytecode(const Bytecode * bytecode, const char * path);
+
+#endif
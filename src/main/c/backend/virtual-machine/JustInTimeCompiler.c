@@ -0,0 +1,230 @@
+#include "JustInTimeCompiler.h"
+
+/* MODULE INTERNAL STATE */
+
+/**
+ * The largest translation of a single word of bytecode, in bytes (a division
+ * takes 19).
+ */
+static const size_t _maximumBytesPerWord = 20;
+static Logger * _logger = NULL;
+
+/**
+ * The machine code being written, and the positions of the jumps to the stub
+ * that handles a division by zero, which is written at the end.
+ */
+typedef struct {
+	uint8_t * code;
+	size_t length;
+	size_t * jumps;
+	size_t jumpCapacity;
+	size_t jumpCount;
+} MachineCodeBuffer;
+
+/** Shutdown module's internal state. */
+void _shutdownJustInTimeCompilerModule() {
+	if (_logger != NULL) {
+		LOG_DEBUGGING(_logger, "Destroying module: JustInTimeCompiler...");
+		destroyLogger(_logger);
+		_logger = NULL;
+	}
+}
+
+ModuleDestructor initializeJustInTimeCompilerModule() {
+	_logger = createLogger("JustInTimeCompiler");
+	return _shutdownJustInTimeCompilerModule;
+}
+
+/** PRIVATE FUNCTIONS */
+
+static void _emitBytes(MachineCodeBuffer * buffer, const size_t length, const uint8_t * bytes);
+static void _emitImmediate(MachineCodeBuffer * buffer, const int32_t immediate);
+static void _emitJumpToDivisionByZero(MachineCodeBuffer * buffer, const bool conditional);
+static void _translate(MachineCodeBuffer * buffer, const Bytecode * bytecode);
+
+/**
+ * Appends raw bytes to the machine code.
+ */
+static void _emitBytes(MachineCodeBuffer * buffer, const size_t length, const uint8_t * bytes) {
+	memcpy(buffer->code + buffer->length, bytes, length);
+	buffer->length += length;
+}
+
+/**
+ * Appends a 32-bit immediate, in little-endian order.
+ */
+static void _emitImmediate(MachineCodeBuffer * buffer, const int32_t immediate) {
+	memcpy(buffer->code + buffer->length, &immediate, sizeof(int32_t));
+	buffer->length += sizeof(int32_t);
+}
+
+/**
+ * Appends a jump ("jz rel32", or "jmp rel32") to the division-by-zero stub,
+ * whose displacement is patched once the stub is written.
+ */
+static void _emitJumpToDivisionByZero(MachineCodeBuffer * buffer, const bool conditional) {
+	if (conditional) {
+		_emitBytes(buffer, 2, (uint8_t []) { 0x0F, 0x84 });
+	}
+	else {
+		_emitBytes(buffer, 1, (uint8_t []) { 0xE9 });
+	}
+	if (buffer->jumpCount == buffer->jumpCapacity) {
+		buffer->jumpCapacity = buffer->jumpCapacity == 0 ? 16 : 2 * buffer->jumpCapacity;
+		buffer->jumps = realloc(buffer->jumps, buffer->jumpCapacity * sizeof(size_t));
+	}
+	buffer->jumps[buffer->jumpCount++] = buffer->length;
+	_emitImmediate(buffer, 0);
+}
+
+/**
+ * Translates the bytecode. The top of the operand stack lives in EAX, and
+ * the rest of it in memory, where RDI points to the next free slot. A push
+ * followed by an arithmetic instruction becomes a single instruction with an
+ * immediate operand. The stack depth of every instruction is known
+ * beforehand, so the first push doesn't spill the (empty) top.
+ */
+static void _translate(MachineCodeBuffer * buffer, const Bytecode * bytecode) {
+	const int32_t * code = bytecode->code;
+	uint32_t stackDepth = 0;
+	for (uint32_t k = 0; code[k] != HALT_INSTRUCTION; ++k) {
+		if (code[k] == PUSH_INSTRUCTION) {
+			const int32_t constant = code[++k];
+			const Instruction next = code[1 + k];
+			if (0 < stackDepth && next != PUSH_INSTRUCTION && next != HALT_INSTRUCTION) {
+				// The constant is the right operand of the next instruction:
+				switch (next) {
+					case ADD_INSTRUCTION:
+						// add eax, imm32
+						_emitBytes(buffer, 1, (uint8_t []) { 0x05 });
+						_emitImmediate(buffer, constant);
+						break;
+					case DIVIDE_INSTRUCTION:
+						if (constant == 0) {
+							_emitJumpToDivisionByZero(buffer, false);
+						}
+						else {
+							// mov ecx, imm32; cdq; idiv ecx
+							_emitBytes(buffer, 1, (uint8_t []) { 0xB9 });
+							_emitImmediate(buffer, constant);
+							_emitBytes(buffer, 3, (uint8_t []) { 0x99, 0xF7, 0xF9 });
+						}
+						break;
+					case MULTIPLY_INSTRUCTION:
+						// imul eax, eax, imm32
+						_emitBytes(buffer, 2, (uint8_t []) { 0x69, 0xC0 });
+						_emitImmediate(buffer, constant);
+						break;
+					case SUBTRACT_INSTRUCTION:
+						// sub eax, imm32
+						_emitBytes(buffer, 1, (uint8_t []) { 0x2D });
+						_emitImmediate(buffer, constant);
+						break;
+					default:
+						break;
+				}
+				++k;
+				continue;
+			}
+			if (0 < stackDepth) {
+				// mov [rdi], eax; add rdi, 4
+				_emitBytes(buffer, 6, (uint8_t []) { 0x89, 0x07, 0x48, 0x83, 0xC7, 0x04 });
+			}
+			// mov eax, imm32
+			_emitBytes(buffer, 1, (uint8_t []) { 0xB8 });
+			_emitImmediate(buffer, constant);
+			++stackDepth;
+			continue;
+		}
+		switch (code[k]) {
+			case ADD_INSTRUCTION:
+				// sub rdi, 4; add eax, [rdi]
+				_emitBytes(buffer, 6, (uint8_t []) { 0x48, 0x83, 0xEF, 0x04, 0x03, 0x07 });
+				break;
+			case DIVIDE_INSTRUCTION:
+				// test eax, eax; jz stub
+				_emitBytes(buffer, 2, (uint8_t []) { 0x85, 0xC0 });
+				_emitJumpToDivisionByZero(buffer, true);
+				// sub rdi, 4; mov ecx, eax; mov eax, [rdi]; cdq; idiv ecx
+				_emitBytes(buffer, 11, (uint8_t []) { 0x48, 0x83, 0xEF, 0x04, 0x89, 0xC1, 0x8B, 0x07, 0x99, 0xF7, 0xF9 });
+				break;
+			case MULTIPLY_INSTRUCTION:
+				// sub rdi, 4; imul eax, [rdi]
+				_emitBytes(buffer, 7, (uint8_t []) { 0x48, 0x83, 0xEF, 0x04, 0x0F, 0xAF, 0x07 });
+				break;
+			case SUBTRACT_INSTRUCTION:
+				// sub rdi, 4; mov ecx, eax; mov eax, [rdi]; sub eax, ecx
+				_emitBytes(buffer, 10, (uint8_t []) { 0x48, 0x83, 0xEF, 0x04, 0x89, 0xC1, 0x8B, 0x07, 0x29, 0xC8 });
+				break;
+		}
+		--stackDepth;
+	}
+	// ret
+	_emitBytes(buffer, 1, (uint8_t []) { 0xC3 });
+	// The stub: mov byte [rsi], 1; ret
+	const size_t stub = buffer->length;
+	_emitBytes(buffer, 4, (uint8_t []) { 0xC6, 0x06, 0x01, 0xC3 });
+	for (size_t k = 0; k < buffer->jumpCount; ++k) {
+		const int32_t displacement = stub - (buffer->jumps[k] + sizeof(int32_t));
+		memcpy(buffer->code + buffer->jumps[k], &displacement, sizeof(int32_t));
+	}
+}
+
+/* PUBLIC FUNCTIONS */
+
+NativeCode * compileNativeCode(const Bytecode * bytecode) {
+#if defined(__x86_64__)
+	LOG_DEBUGGING(_logger, "Translating bytecode (length=%u)...", bytecode->length);
+	const size_t capacity = _maximumBytesPerWord * bytecode->length + 16;
+	void * memory = mmap(NULL, capacity, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (memory == MAP_FAILED) {
+		LOG_ERROR(_logger, "The executable memory cannot be mapped (%zu bytes).", capacity);
+		return NULL;
+	}
+	MachineCodeBuffer buffer = {
+		.code = memory,
+		.length = 0,
+		.jumps = NULL,
+		.jumpCapacity = 0,
+		.jumpCount = 0
+	};
+	_translate(&buffer, bytecode);
+	free(buffer.jumps);
+	if (mprotect(memory, capacity, PROT_READ | PROT_EXEC) != 0) {
+		LOG_ERROR(_logger, "The machine code cannot be made executable.");
+		munmap(memory, capacity);
+		return NULL;
+	}
+	NativeCode * nativeCode = calloc(1, sizeof(NativeCode));
+	nativeCode->bytecode = bytecode;
+	nativeCode->function = (NativeFunction) memory;
+	nativeCode->size = capacity;
+	LOG_DEBUGGING(_logger, "Translation is done (%zu bytes of machine code).", buffer.length);
+	return nativeCode;
+#else
+	LOG_WARNING(_logger, "The just-in-time compiler only supports x86-64 hosts.");
+	return NULL;
+#endif
+}
+
+void destroyNativeCode(NativeCode * nativeCode) {
+	if (nativeCode != NULL) {
+		munmap((void *) nativeCode->function, nativeCode->size);
+		free(nativeCode);
+	}
+}
+
+ComputationResult executeNativeCode(const NativeCode * nativeCode) {
+	int32_t * stack = calloc(1 + nativeCode->bytecode->maximumStackDepth, sizeof(int32_t));
+	bool divisionByZero = false;
+	ComputationResult computationResult = {
+		.succeeded = true,
+		.value = nativeCode->function(stack, &divisionByZero)
+	};
+	free(stack);
+	if (divisionByZero) {
+		LOG_DEBUGGING(_logger, "Division by zero: re-executing in the virtual machine...");
+		computationResult = executeVirtualMachine(nativeCode->bytecode);
+	}
+	return computationResult;
+}
@@ -0,0 +1,52 @@
+#ifndef JUST_IN_TIME_COMPILER_HEADER
+#define JUST_IN_TIME_COMPILER_HEADER
+
+#include "../../support/logging/Logger.h"
+#include "../../support/type/ModuleDestructor.h"
+#include "../domain-specific/Calculator.h"
+#include "Bytecode.h"
+#include "VirtualMachine.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+/** Initialize module's internal state. */
+ModuleDestructor initializeJustInTimeCompilerModule();
+
+/**
+ * A bytecode translated into x86-64 machine code, in a region of memory that
+ * is executable (and not writable anymore). The code receives the operand
+ * stack and a flag to raise on a division by zero, and returns the value of
+ * the program.
+ */
+typedef int (* NativeFunction)(int32_t * stack, bool * divisionByZero);
+
+typedef struct {
+	const Bytecode * bytecode;
+	NativeFunction function;
+	size_t size;
+} NativeCode;
+
+/**
+ * Translates a bytecode into machine code. The bytecode must outlive the
+ * native code. Returns NULL if the host is not an x86-64 one, or if the
+ * executable memory cannot be mapped.
+ */
+NativeCode * compileNativeCode(const Bytecode * bytecode);
+
+/**
+ * Destroys a native code, and unmaps its memory.
+ */
+void destroyNativeCode(NativeCode * nativeCode);
+
+/**
+ * Executes a native code. The result is the same that the virtual machine
+ * computes for its bytecode: as in the virtual machine, the machine code
+ * doesn't track failed results, so if a division by zero takes place, the
+ * bytecode is executed again by the virtual machine, that does.
+ */
+ComputationResult executeNativeCode(const NativeCode * nativeCode);
+
+#endif
@@ -0,0 +1,117 @@
+#include "NativeCodeCache.h"
+
+/* MODULE INTERNAL STATE */
+
+static Logger * _logger = NULL;
+
+/** Shutdown module's internal state. */
+void _shutdownNativeCodeCacheModule() {
+	if (_logger != NULL) {
+		LOG_DEBUGGING(_logger, "Destroying module: NativeCodeCache...");
+		destroyLogger(_logger);
+		_logger = NULL;
+	}
+}
+
+ModuleDestructor initializeNativeCodeCacheModule() {
+	_logger = createLogger("NativeCodeCache");
+	return _shutdownNativeCodeCacheModule;
+}
+
+/* PRIVATE FUNCTIONS */
+
+static void _dereference(NativeCodeEntry * nativeCodeEntry);
+static NativeCodeEntry ** _slotOf(NativeCodeCache * nativeCodeCache, const CompilationKey * compilationKey);
+
+/**
+ * Drops a reference to an entry, and destroys it if it was the last one.
+ * Requires the lock of its cache (if any).
+ */
+static void _dereference(NativeCodeEntry * nativeCodeEntry) {
+	if (--nativeCodeEntry->references == 0) {
+		destroyNativeCode(nativeCodeEntry->nativeCode);
+		destroyBytecode(nativeCodeEntry->bytecode);
+		free(nativeCodeEntry);
+	}
+}
+
+/**
+ * The slot of a key. The key is a hash already, so its low bits are used.
+ */
+static NativeCodeEntry ** _slotOf(NativeCodeCache * nativeCodeCache, const CompilationKey * compilationKey) {
+	return &nativeCodeCache->entries[compilationKey->low & (nativeCodeCache->capacity - 1)];
+}
+
+/* PUBLIC FUNCTIONS */
+
+NativeCodeEntry * acquireNativeCode(NativeCodeCache * nativeCodeCache, const CompilationKey * compilationKey) {
+	if (nativeCodeCache == NULL || compilationKey == NULL) {
+		return NULL;
+	}
+	pthread_mutex_lock(&nativeCodeCache->mutex);
+	NativeCodeEntry * nativeCodeEntry = *_slotOf(nativeCodeCache, compilationKey);
+	if (nativeCodeEntry != NULL && memcmp(&nativeCodeEntry->compilationKey, compilationKey, sizeof(CompilationKey)) == 0) {
+		++nativeCodeEntry->references;
+	}
+	else {
+		nativeCodeEntry = NULL;
+	}
+	pthread_mutex_unlock(&nativeCodeCache->mutex);
+	LOG_DEBUGGING(_logger, "The native code of the program is %s.", nativeCodeEntry == NULL ? "not cached" : "cached");
+	return nativeCodeEntry;
+}
+
+NativeCodeCache * createNativeCodeCache(const size_t capacity) {
+	NativeCodeCache * nativeCodeCache = calloc(1, sizeof(NativeCodeCache));
+	nativeCodeCache->capacity = 1;
+	while (nativeCodeCache->capacity < capacity) {
+		nativeCodeCache->capacity *= 2;
+	}
+	nativeCodeCache->entries = calloc(nativeCodeCache->capacity, sizeof(NativeCodeEntry *));
+	pthread_mutex_init(&nativeCodeCache->mutex, NULL);
+	return nativeCodeCache;
+}
+
+void destroyNativeCodeCache(NativeCodeCache * nativeCodeCache) {
+	if (nativeCodeCache != NULL) {
+		for (size_t k = 0; k < nativeCodeCache->capacity; ++k) {
+			if (nativeCodeCache->entries[k] != NULL) {
+				_dereference(nativeCodeCache->entries[k]);
+			}
+		}
+		pthread_mutex_destroy(&nativeCodeCache->mutex);
+		free(nativeCodeCache->entries);
+		free(nativeCodeCache);
+	}
+}
+
+void releaseNativeCode(NativeCodeCache * nativeCodeCache, NativeCodeEntry * nativeCodeEntry) {
+	if (nativeCodeCache == NULL) {
+		_dereference(nativeCodeEntry);
+	}
+	else {
+		pthread_mutex_lock(&nativeCodeCache->mutex);
+		_dereference(nativeCodeEntry);
+		pthread_mutex_unlock(&nativeCodeCache->mutex);
+	}
+}
+
+NativeCodeEntry * storeNativeCode(NativeCodeCache * nativeCodeCache, const CompilationKey * compilationKey, Bytecode * bytecode, NativeCode * nativeCode) {
+	NativeCodeEntry * nativeCodeEntry = calloc(1, sizeof(NativeCodeEntry));
+	nativeCodeEntry->bytecode = bytecode;
+	nativeCodeEntry->nativeCode = nativeCode;
+	nativeCodeEntry->references = 1;
+	if (nativeCodeCache == NULL || compilationKey == NULL) {
+		return nativeCodeEntry;
+	}
+	nativeCodeEntry->compilationKey = *compilationKey;
+	pthread_mutex_lock(&nativeCodeCache->mutex);
+	NativeCodeEntry ** slot = _slotOf(nativeCodeCache, compilationKey);
+	if (*slot != NULL) {
+		_dereference(*slot);
+	}
+	*slot = nativeCodeEntry;
+	++nativeCodeEntry->references;
+	pthread_mutex_unlock(&nativeCodeCache->mutex);
+	return nativeCodeEntry;
+}
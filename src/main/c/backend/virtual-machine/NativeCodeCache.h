@@ -0,0 +1,73 @@
+#ifndef NATIVE_CODE_CACHE_HEADER
+#define NATIVE_CODE_CACHE_HEADER
+
+#include "../../support/cache/CompilationCache.h"
+#include "../../support/logging/Logger.h"
+#include "../../support/type/ModuleDestructor.h"
+#include "Bytecode.h"
+#include "JustInTimeCompiler.h"
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** Initialize module's internal state. */
+ModuleDestructor initializeNativeCodeCacheModule();
+
+/**
+ * The native code of a program, with the bytecode it was translated from
+ * (which the native code needs to fall back to the virtual machine). It's
+ * destroyed once neither the cache nor any compilation references it.
+ */
+typedef struct {
+	Bytecode * bytecode;
+	CompilationKey compilationKey;
+	NativeCode * nativeCode;
+	unsigned int references;
+} NativeCodeEntry;
+
+/**
+ * The native code of the programs computed by a process that compiles many
+ * of them (in server or batch mode), so a program computed again with the
+ * just-in-time compiler skips the lowering and the translation, and only
+ * executes its machine code. The entries are keyed by the compilation key of
+ * the program (see "CompilationCache.h"), so a change in an imported file is
+ * a miss. There is a fixed amount of slots, and every slot keeps the last
+ * program stored in it. It's shared by every thread of the process.
+ */
+typedef struct {
+	NativeCodeEntry ** entries;
+	size_t capacity;
+	pthread_mutex_t mutex;
+} NativeCodeCache;
+
+/**
+ * Takes the entry of a key, which must be released after executing it.
+ * Returns NULL on a miss. A NULL cache always misses.
+ */
+NativeCodeEntry * acquireNativeCode(NativeCodeCache * nativeCodeCache, const CompilationKey * compilationKey);
+
+/**
+ * Creates an empty cache, with an amount of slots rounded up to a power of 2.
+ */
+NativeCodeCache * createNativeCodeCache(const size_t capacity);
+
+/**
+ * Destroys a cache, and every entry that no compilation references anymore.
+ */
+void destroyNativeCodeCache(NativeCodeCache * nativeCodeCache);
+
+/**
+ * Releases an entry taken with "acquireNativeCode" or "storeNativeCode".
+ */
+void releaseNativeCode(NativeCodeCache * nativeCodeCache, NativeCodeEntry * nativeCodeEntry);
+
+/**
+ * Stores the native code of a key (and takes its bytecode), replacing the
+ * entry in its slot, and returns the new entry already taken. With a NULL
+ * cache (or key), the entry is only referenced by the caller.
+ */
+NativeCodeEntry * storeNativeCode(NativeCodeCache * nativeCodeCache, const CompilationKey * compilationKey, Bytecode * bytecode, NativeCode * nativeCode);
+
+#endif
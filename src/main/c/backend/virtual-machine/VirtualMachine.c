@@ -0,0 +1,121 @@
+#include "VirtualMachine.h"
+
+/* MODULE INTERNAL STATE */
+
+static Logger * _logger = NULL;
+
+/** Shutdown module's internal state. */
+void _shutdownVirtualMachineModule() {
+	if (_logger != NULL) {
+		LOG_DEBUGGING(_logger, "Destroying module: VirtualMachine...");
+		destroyLogger(_logger);
+		_logger = NULL;
+	}
+}
+
+ModuleDestructor initializeVirtualMachineModule() {
+	_logger = createLogger("VirtualMachine");
+	return _shutdownVirtualMachineModule;
+}
+
+/** PRIVATE FUNCTIONS */
+
+static ComputationResult _executeChecked(const Bytecode * bytecode);
+
+/**
+ * Executes a bytecode tracking whether every value in the operand stack is
+ * valid, exactly as the Calculator propagates failed results. It's slower
+ * than the threaded loop, so it only runs when a division by zero occurs.
+ */
+static ComputationResult _executeChecked(const Bytecode * bytecode) {
+	ComputationResult * stack = calloc(1 + bytecode->maximumStackDepth, sizeof(ComputationResult));
+	ComputationResult * top = stack;
+	const int32_t * code = bytecode->code;
+	for (uint32_t k = 0; code[k] != HALT_INSTRUCTION; ++k) {
+		if (code[k] == PUSH_INSTRUCTION) {
+			++top;
+			top->succeeded = true;
+			top->value = code[++k];
+			continue;
+		}
+		--top;
+		if (top[0].succeeded && top[1].succeeded) {
+			switch (code[k]) {
+				case ADD_INSTRUCTION: top[0] = add(top[0].value, top[1].value); break;
+				case DIVIDE_INSTRUCTION: top[0] = divide(top[0].value, top[1].value); break;
+				case MULTIPLY_INSTRUCTION: top[0] = multiply(top[0].value, top[1].value); break;
+				case SUBTRACT_INSTRUCTION: top[0] = subtract(top[0].value, top[1].value); break;
+			}
+		}
+		else {
+			top[0].succeeded = false;
+			top[0].value = 0;
+		}
+	}
+	ComputationResult computationResult = *top;
+	free(stack);
+	return computationResult;
+}
+
+/** PUBLIC FUNCTIONS */
+
+ComputationResult executeVirtualMachine(const Bytecode * bytecode) {
+	static void * const handlers[] = {
+		[ADD_INSTRUCTION] = &&add,
+		[DIVIDE_INSTRUCTION] = &&divide,
+		[HALT_INSTRUCTION] = &&halt,
+		[MULTIPLY_INSTRUCTION] = &&multiply,
+		[PUSH_INSTRUCTION] = &&push,
+		[SUBTRACT_INSTRUCTION] = &&subtract
+	};
+	LOG_DEBUGGING(_logger, "Executing bytecode (length=%u)...", bytecode->length);
+	void ** threadedCode = calloc(bytecode->length, sizeof(void *));
+	for (uint32_t k = 0; k < bytecode->length; ++k) {
+		threadedCode[k] = handlers[bytecode->code[k]];
+		if (bytecode->code[k] == PUSH_INSTRUCTION) {
+			++k;
+			threadedCode[k] = (void *) (intptr_t) bytecode->code[k];
+		}
+	}
+	int * stack = calloc(1 + bytecode->maximumStackDepth, sizeof(int));
+	int * top = stack;
+	bool divisionByZero = false;
+	void ** instruction = threadedCode;
+	goto **instruction++;
+	add:
+		--top;
+		top[0] = (int) ((unsigned int) top[0] + (unsigned int) top[1]);
+		goto **instruction++;
+	divide:
+		if (top[0] == 0) {
+			divisionByZero = true;
+			goto halt;
+		}
+		--top;
+		top[0] = top[0] / top[1];
+		goto **instruction++;
+	multiply:
+		--top;
+		top[0] = (int) ((unsigned int) top[0] * (unsigned int) top[1]);
+		goto **instruction++;
+	push:
+		*++top = (int) (intptr_t) *instruction++;
+		goto **instruction++;
+	subtract:
+		--top;
+		top[0] = (int) ((unsigned int) top[0] - (unsigned int) top[1]);
+		goto **instruction++;
+	halt:;
+	ComputationResult computationResult = {
+		.succeeded = true,
+		.value = *top
+	};
+	free(stack);
+	free(threadedCode);
+	if (divisionByZero) {
+		LOG_DEBUGGING(_logger, "Division by zero: re-executing with checked results...");
+		computationResult = _executeChecked(bytecode);
+	}
+	LOG_DEBUGGING(_logger, "Execution is done.");
+	return computationResult;
+}
@@ -0,0 +1,24 @@
+#ifndef VIRTUAL_MACHINE_HEADER
+#define VIRTUAL_MACHINE_HEADER
+
+#include "../../support/logging/Logger.h"
+#include "../../support/type/ModuleDestructor.h"
+#include "../domain-specific/Calculator.h"
+#include "Bytecode.h"
+#include <stdint.h>
+#include <stdlib.h>
+
+/** Initialize module's internal state. */
+ModuleDestructor initializeVirtualMachineModule();
+
+/**
+ * Executes a bytecode in a stack-based virtual machine, using direct-threaded
+ * dispatch. The result is the same that the Calculator computes over the AST
+ * that produced the bytecode, including the failed results (and the errors
+ * logged) when a division by zero takes place.
+ *
+ * @see https://gcc.gnu.org/onlinedocs/gcc/Labels-as-Values.html
+ */
+ComputationResult executeVirtualMachine(const Bytecode * bytecode);
+
+#endif
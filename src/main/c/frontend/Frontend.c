@@ -2,34 +2,43 @@
 
 /* MODULE INTERNAL STATE */
 
-static LexicalAnalyzer * _lexicalAnalyzer = NULL;
+static bool _importPrefetch = true;
 static Logger * _logger = NULL;
+static bool _mappedInput = false;
 
 /** Shutdown module's internal state. */
 void _shutdownFrontendModule() {
 	if (_logger != NULL) {
-		logDebugging(_logger, "Destroying module: Frontend...");
+		LOG_DEBUGGING(_logger, "Destroying module: Frontend...");
 		destroyLogger(_logger);
 		_logger = NULL;
 	}
-	_lexicalAnalyzer = NULL;
 }
 
-ModuleDestructor initializeFrontendModule(LexicalAnalyzer * lexicalAnalyzer) {
-	_lexicalAnalyzer = lexicalAnalyzer;
+ModuleDestructor initializeFrontendModule() {
 	_logger = createLogger("Frontend");
+	_importPrefetch = getBooleanOrDefault("IMPORT_PREFETCH", _importPrefetch);
+	_mappedInput = strcmp(getStringOrDefault("INPUT_MODE", "STREAM"), "MAPPED") == 0;
 	return _shutdownFrontendModule;
 }
 
 /* IMPORTED FUNCTIONS */
 
+extern void * flexCreateMemoryBuffer(LexicalAnalyzer * lexicalAnalyzer, char * memory, const size_t sizeInBytes);
 extern bool flexHasBuffer(LexicalAnalyzer * lexicalAnalyzer);
 extern FlexContext flexCurrentContext(LexicalAnalyzer * lexicalAnalyzer);
 extern void flexEnterContext(LexicalAnalyzer * lexicalAnalyzer, FlexContext flexContext);
 extern void flexLeaveContext(LexicalAnalyzer * lexicalAnalyzer);
+extern const char * flexLookahead(LexicalAnalyzer * lexicalAnalyzer, size_t * length);
+extern void flexReset(LexicalAnalyzer * lexicalAnalyzer);
 
 /* PRIVATE FUNCTIONS */
 
+static const char * _compilationStatusAsString(const CompilationStatus compilationStatus);
+static InputBuffer * _createMappedInputBuffer(LexicalAnalyzer * lexicalAnalyzer, const int fileDescriptor);
+static void _destroyImportedInputBuffers(LexicalAnalyzer * lexicalAnalyzer);
+static CompilationStatus _parse(LexicalAnalyzer * lexicalAnalyzer, const TokenLabel label);
+
 static const char * _compilationStatusAsString(const CompilationStatus compilationStatus) {
 	switch (compilationStatus) {
 		case FAILED:
@@ -45,39 +54,165 @@ static const char * _compilationStatusAsString(const CompilationStatus compilati
 	}
 }
 
+/**
+ * Maps a regular file in memory, followed by the two null sentinels required
+ * by "yy_scan_buffer". The whole region is first reserved with anonymous
+ * (zeroed) pages, and then the file is mapped over its beginning, so the
+ * sentinels exist even if the size of the file is a multiple of the page size.
+ * Only the content after the current offset of the file is scanned (as a
+ * stream would), so the mapping starts at the page of that offset, and the
+ * offset is moved to the end afterwards, as if the file was read entirely.
+ * The mapping is private and writable, because Flex writes a null-terminator
+ * after each lexeme (only the touched pages get copied). Returns NULL if the
+ * file cannot be mapped.
+ *
+ * @see https://westes.github.io/flex/manual/Multiple-Input-Buffers.html
+ */
+static InputBuffer * _createMappedInputBuffer(LexicalAnalyzer * lexicalAnalyzer, const int fileDescriptor) {
+	struct stat status;
+	if (fstat(fileDescriptor, &status) != 0 || !S_ISREG(status.st_mode)) {
+		return NULL;
+	}
+	const off_t offset = lseek(fileDescriptor, 0, SEEK_CUR);
+	if (offset < 0 || status.st_size < offset) {
+		return NULL;
+	}
+	const size_t contentSizeInBytes = status.st_size - offset;
+	const size_t pageSizeInBytes = sysconf(_SC_PAGESIZE);
+	const size_t pageOffsetInBytes = offset % pageSizeInBytes;
+	const size_t mappedSizeInBytes = pageOffsetInBytes + contentSizeInBytes;
+	const size_t memorySizeInBytes = pageSizeInBytes * (1 + (mappedSizeInBytes + 1) / pageSizeInBytes);
+	char * memory = mmap(NULL, memorySizeInBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (memory == MAP_FAILED) {
+		return NULL;
+	}
+	if (0 < contentSizeInBytes
+		&& mmap(memory, mappedSizeInBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fileDescriptor, offset - pageOffsetInBytes) == MAP_FAILED) {
+		munmap(memory, memorySizeInBytes);
+		return NULL;
+	}
+	lseek(fileDescriptor, 0, SEEK_END);
+	InputBuffer * inputBuffer = (InputBuffer *) calloc(1, sizeof(InputBuffer));
+	inputBuffer->bufferSizeInBytes = 0;
+	inputBuffer->file = NULL;
+	inputBuffer->lexicalAnalyzer = lexicalAnalyzer;
+	inputBuffer->memory = memory;
+	inputBuffer->memorySizeInBytes = memorySizeInBytes;
+	inputBuffer->prefetchedEnd = NULL;
+	inputBuffer->pushed = false;
+	inputBuffer->buffer = flexCreateMemoryBuffer(lexicalAnalyzer, memory + pageOffsetInBytes, contentSizeInBytes + 2);
+	LOG_DEBUGGING(_logger, "Input mapped in memory (size=%zu bytes, offset=%lld bytes).", contentSizeInBytes, (long long) offset);
+	return inputBuffer;
+}
+
+/**
+ * Destroys the input buffers of the imports still stacked (e.g., after a
+ * syntax error inside an import). Flex must have popped them already.
+ */
+static void _destroyImportedInputBuffers(LexicalAnalyzer * lexicalAnalyzer) {
+	for (size_t k = 0; k < lexicalAnalyzer->importedInputBufferCount; ++k) {
+		destroyInputBuffer(lexicalAnalyzer->importedInputBuffers[k]);
+	}
+	lexicalAnalyzer->importedInputBufferCount = 0;
+}
+
+/**
+ * Pushes a token to the parser, with the semantic value already stored in the
+ * lexical-analyzer. The compilation fails if the flat table overflowed while
+ * reducing, although the parser itself may still be in progress (and then,
+ * it's restarted on reset).
+ */
+static CompilationStatus _parse(LexicalAnalyzer * lexicalAnalyzer, const TokenLabel label) {
+	CompilerState * compilerState = lexicalAnalyzer->compilerState;
+	lexicalAnalyzer->parserStatus = (CompilationStatus) yypush_parse(
+		(yypstate *) lexicalAnalyzer->parser,
+		label,
+		&lexicalAnalyzer->semanticValue,
+		(YYLTYPE *) lexicalAnalyzer->location,
+		compilerState);
+	const FlatSyntaxTree * flatSyntaxTree = compilerState->flatSyntaxTree;
+	if (flatSyntaxTree != NULL && flatSyntaxTree->overflowed) {
+		LOG_ERROR(_logger, "The program exceeds the maximum amount of nodes of the flat layout (%u).", MAXIMUM_FLAT_NODE_COUNT);
+		return FAILED;
+	}
+	return lexicalAnalyzer->parserStatus;
+}
+
 /* PUBLIC FUNCTIONS */
 
 InputBuffer * createInputBuffer(LexicalAnalyzer * lexicalAnalyzer, const char * path) {
+	if (_mappedInput) {
+		const int fileDescriptor = open(path, O_RDONLY);
+		if (0 <= fileDescriptor) {
+			InputBuffer * inputBuffer = _createMappedInputBuffer(lexicalAnalyzer, fileDescriptor);
+			close(fileDescriptor);
+			if (inputBuffer != NULL) {
+				return inputBuffer;
+			}
+		}
+		LOG_DEBUGGING(_logger, "The input \"%s\" cannot be mapped in memory: falling back to a stream.", path);
+	}
+	FILE * file = fopen(path, "r");
+	if (file == NULL) {
+		LOG_ERROR(_logger, "The input \"%s\" cannot be opened.", path);
+		return NULL;
+	}
 	InputBuffer * inputBuffer = (InputBuffer *) calloc(1, sizeof(InputBuffer));
 	inputBuffer->bufferSizeInBytes = YY_BUF_SIZE;
-	inputBuffer->file = fopen(path, "r");
+	inputBuffer->file = file;
 	inputBuffer->lexicalAnalyzer = lexicalAnalyzer;
+	inputBuffer->prefetchedEnd = NULL;
+	inputBuffer->pushed = false;
 	inputBuffer->buffer = yy_create_buffer(inputBuffer->file, inputBuffer->bufferSizeInBytes, lexicalAnalyzer->scanner);
 	return inputBuffer;
 }
 
+InputBuffer * createMemoryInputBuffer(LexicalAnalyzer * lexicalAnalyzer, char * memory, const size_t sizeInBytes) {
+	InputBuffer * inputBuffer = (InputBuffer *) calloc(1, sizeof(InputBuffer));
+	inputBuffer->bufferSizeInBytes = 0;
+	inputBuffer->file = NULL;
+	inputBuffer->lexicalAnalyzer = lexicalAnalyzer;
+	inputBuffer->memory = NULL;
+	inputBuffer->memorySizeInBytes = 0;
+	inputBuffer->prefetchedEnd = NULL;
+	inputBuffer->pushed = false;
+	inputBuffer->buffer = flexCreateMemoryBuffer(lexicalAnalyzer, memory, sizeInBytes);
+	return inputBuffer;
+}
+
+InputBuffer * createStandardInputBuffer(LexicalAnalyzer * lexicalAnalyzer) {
+	if (_mappedInput) {
+		InputBuffer * inputBuffer = _createMappedInputBuffer(lexicalAnalyzer, STDIN_FILENO);
+		if (inputBuffer == NULL) {
+			LOG_DEBUGGING(_logger, "The standard input cannot be mapped in memory: falling back to a stream.");
+		}
+		else {
+			pushInputBuffer(inputBuffer);
+		}
+		return inputBuffer;
+	}
+	return NULL;
+}
+
 LexicalAnalyzer * createLexicalAnalyzer() {
 	LexicalAnalyzer * lexicalAnalyzer = (LexicalAnalyzer *) calloc(1, sizeof(LexicalAnalyzer));
+	lexicalAnalyzer->compilerState = NULL;
+	lexicalAnalyzer->importedInputBufferCapacity = 0;
+	lexicalAnalyzer->importedInputBufferCount = 0;
+	lexicalAnalyzer->importedInputBuffers = NULL;
+	lexicalAnalyzer->importPrefetcher = _importPrefetch ? createImportPrefetcher() : NULL;
+	lexicalAnalyzer->inputBuffer = NULL;
 	lexicalAnalyzer->location = calloc(1, sizeof(YYLTYPE));
 	lexicalAnalyzer->logger = createLogger("LexicalAnalyzer");
-	yylex_init(&lexicalAnalyzer->scanner);
+	yylex_init_extra(lexicalAnalyzer, &lexicalAnalyzer->scanner);
 	lexicalAnalyzer->parser = yypstate_new();
+	lexicalAnalyzer->parserStatus = SUCCEEDED;
+	lexicalAnalyzer->pendingImport = NULL;
+	lexicalAnalyzer->prefetchedEnd = NULL;
 	flexEnterContext(lexicalAnalyzer, 0);
 	return lexicalAnalyzer;
 }
 
-Token * createToken(LexicalAnalyzer * lexicalAnalyzer, TokenLabel label) {
-	Token * token = (Token *) calloc(1, sizeof(Token));
-	token->context = flexCurrentContext(lexicalAnalyzer);
-	token->label = label;
-	token->length = yyget_leng(lexicalAnalyzer->scanner);
-	token->lexeme = (char *) calloc(token->length + 1, sizeof(char));
-	token->line = yyget_lineno(lexicalAnalyzer->scanner);
-	token->semanticValue = (SemanticValue *) calloc(1, sizeof(SemanticValue));
-	strncpy(token->lexeme, yyget_text(lexicalAnalyzer->scanner), token->length);
-	return token;
-}
-
 FlexContext currentLexicalAnalyzerContext(LexicalAnalyzer * lexicalAnalyzer) {
 	return flexCurrentContext(lexicalAnalyzer);
 }
@@ -85,21 +220,22 @@ FlexContext currentLexicalAnalyzerContext(LexicalAnalyzer * lexicalAnalyzer) {
 void destroyInputBuffer(InputBuffer * inputBuffer) {
 	if (inputBuffer != NULL) {
 		if (inputBuffer->buffer != NULL) {
-			/**
-			 * @todo
-			 *	Because "yypop_buffer_state" in "popInputBuffer" deletes the
-			 *	buffer, this line produces a double-free error. However,
-			 *	commenting the line produces a memory-leak when a syntax error
-			 *	takes place inside a secondary input buffer.
-			 */
-			// yy_delete_buffer((YY_BUFFER_STATE) inputBuffer->buffer, (yyscan_t) inputBuffer->lexicalAnalyzer->scanner);
+			// Flex deletes the pushed buffers itself, once they are popped:
+			if (!inputBuffer->pushed) {
+				yy_delete_buffer((YY_BUFFER_STATE) inputBuffer->buffer, (yyscan_t) inputBuffer->lexicalAnalyzer->scanner);
+			}
 			inputBuffer->buffer = NULL;
 		}
 		if (inputBuffer->file != NULL) {
 			fclose(inputBuffer->file);
 			inputBuffer->file = NULL;
 		}
+		if (inputBuffer->memory != NULL) {
+			munmap(inputBuffer->memory, inputBuffer->memorySizeInBytes);
+			inputBuffer->memory = NULL;
+		}
 		inputBuffer->bufferSizeInBytes = 0;
+		inputBuffer->memorySizeInBytes = 0;
 		inputBuffer->lexicalAnalyzer = NULL;
 		free(inputBuffer);
 	}
@@ -107,6 +243,12 @@ void destroyInputBuffer(InputBuffer * inputBuffer) {
 
 void destroyLexicalAnalyzer(LexicalAnalyzer * lexicalAnalyzer) {
 	if (lexicalAnalyzer != NULL) {
+		destroyImportPrefetcher(lexicalAnalyzer->importPrefetcher);
+		lexicalAnalyzer->importPrefetcher = NULL;
+		if (lexicalAnalyzer->inputBuffer != NULL) {
+			destroyInputBuffer(lexicalAnalyzer->inputBuffer);
+			lexicalAnalyzer->inputBuffer = NULL;
+		}
 		if (lexicalAnalyzer->parser != NULL) {
 			yypstate_delete((yypstate *) lexicalAnalyzer->parser);
 			lexicalAnalyzer->parser = NULL;
@@ -115,6 +257,9 @@ void destroyLexicalAnalyzer(LexicalAnalyzer * lexicalAnalyzer) {
 			yylex_destroy((yyscan_t) lexicalAnalyzer->scanner);
 			lexicalAnalyzer->scanner = NULL;
 		}
+		_destroyImportedInputBuffers(lexicalAnalyzer);
+		free(lexicalAnalyzer->importedInputBuffers);
+		lexicalAnalyzer->importedInputBuffers = NULL;
 		if (lexicalAnalyzer->logger != NULL) {
 			destroyLogger(lexicalAnalyzer->logger);
 			lexicalAnalyzer->logger = NULL;
@@ -127,20 +272,6 @@ void destroyLexicalAnalyzer(LexicalAnalyzer * lexicalAnalyzer) {
 	}
 }
 
-void destroyToken(Token * token) {
-	if (token != NULL) {
-		if (token->lexeme != NULL) {
-			free(token->lexeme);
-			token->lexeme = NULL;
-		}
-		if (token->semanticValue != NULL) {
-			free(token->semanticValue);
-			token->semanticValue = NULL;
-		}
-		free(token);
-	}
-}
-
 void enterLexicalAnalyzerContext(LexicalAnalyzer * lexicalAnalyzer, FlexContext flexContext) {
 	flexEnterContext(lexicalAnalyzer, flexContext);
 }
@@ -152,14 +283,14 @@ CompilationStatus executeLexicalAnalysis(LexicalAnalyzer * lexicalAnalyzer) {
 		lexicalAnalyzer->scanner);
 }
 
-CompilationStatus executeSyntacticAnalysis() {
-	logDebugging(_logger, "Parsing...");
+CompilationStatus executeSyntacticAnalysis(LexicalAnalyzer * lexicalAnalyzer) {
+	LOG_DEBUGGING(_logger, "Parsing...");
 	CompilationStatus status = IN_PROGRESS;
 	while (status == IN_PROGRESS) {
-		status = executeLexicalAnalysis(_lexicalAnalyzer);
+		status = executeLexicalAnalysis(lexicalAnalyzer);
 	}
-	logDebugging(_logger, "Compilation status: %s.", _compilationStatusAsString(status));
-	logDebugging(_logger, "Parsing is done.");
+	LOG_DEBUGGING(_logger, "Compilation status: %s.", _compilationStatusAsString(status));
+	LOG_DEBUGGING(_logger, "Parsing is done.");
 	return status;
 }
 
@@ -167,19 +298,109 @@ void leaveLexicalAnalyzerContext(LexicalAnalyzer * lexicalAnalyzer) {
 	flexLeaveContext(lexicalAnalyzer);
 }
 
+Token * nextToken(LexicalAnalyzer * lexicalAnalyzer, TokenLabel label) {
+	Token * token = &lexicalAnalyzer->token;
+	token->context = flexCurrentContext(lexicalAnalyzer);
+	token->label = label;
+	token->length = yyget_leng(lexicalAnalyzer->scanner);
+	token->lexeme = yyget_text(lexicalAnalyzer->scanner);
+	token->line = yyget_lineno(lexicalAnalyzer->scanner);
+	token->semanticValue = &lexicalAnalyzer->semanticValue;
+	memset(token->semanticValue, 0, sizeof(SemanticValue));
+	return token;
+}
+
 bool popInputBuffer(LexicalAnalyzer * lexicalAnalyzer) {
 	yypop_buffer_state((yyscan_t) lexicalAnalyzer->scanner);
+	if (0 < lexicalAnalyzer->importedInputBufferCount) {
+		// The end of an imported file (its Flex buffer is already deleted):
+		destroyInputBuffer(lexicalAnalyzer->importedInputBuffers[--lexicalAnalyzer->importedInputBufferCount]);
+	}
 	return flexHasBuffer(lexicalAnalyzer);
 }
 
+void prefetchNextImports(LexicalAnalyzer * lexicalAnalyzer, const char * path) {
+	if (lexicalAnalyzer->importPrefetcher == NULL) {
+		return;
+	}
+	const char ** prefetchedEnd = 0 < lexicalAnalyzer->importedInputBufferCount
+		? &((InputBuffer *) lexicalAnalyzer->importedInputBuffers[lexicalAnalyzer->importedInputBufferCount - 1])->prefetchedEnd
+		: &lexicalAnalyzer->prefetchedEnd;
+	size_t length = 0;
+	const char * lookahead = flexLookahead(lexicalAnalyzer, &length);
+	if (*prefetchedEnd == lookahead + length) {
+		// The imports of this text are already prefetched:
+		length = 0;
+	}
+	*prefetchedEnd = lookahead + length;
+	prefetchImports(lexicalAnalyzer->importPrefetcher, path, lookahead, length);
+}
+
+CompilationStatus pushImport(LexicalAnalyzer * lexicalAnalyzer, Import * import) {
+	if (recordImport(lexicalAnalyzer->compilerState->importCache, import)) {
+		return IN_PROGRESS;
+	}
+	SemanticValue * semanticValue = &lexicalAnalyzer->semanticValue;
+	if (import->shareable) {
+		memset(semanticValue, 0, sizeof(SemanticValue));
+		semanticValue->import = import;
+		return _parse(lexicalAnalyzer, IMPORT);
+	}
+	CompilationStatus status = IN_PROGRESS;
+	for (uint32_t k = 0; k < import->tokenCount && status == IN_PROGRESS; ++k) {
+		const ImportedToken * token = &import->tokens[k];
+		memset(semanticValue, 0, sizeof(SemanticValue));
+		if (token->label == IMPORT) {
+			semanticValue->import = token->import;
+		}
+		else {
+			semanticValue->integer = token->integer;
+		}
+		status = _parse(lexicalAnalyzer, token->label);
+	}
+	return status;
+}
+
+void pushImportedInputBuffer(LexicalAnalyzer * lexicalAnalyzer) {
+	if (lexicalAnalyzer->importedInputBufferCount == lexicalAnalyzer->importedInputBufferCapacity) {
+		lexicalAnalyzer->importedInputBufferCapacity = lexicalAnalyzer->importedInputBufferCapacity == 0 ? 8 : 2 * lexicalAnalyzer->importedInputBufferCapacity;
+		lexicalAnalyzer->importedInputBuffers = realloc(lexicalAnalyzer->importedInputBuffers, lexicalAnalyzer->importedInputBufferCapacity * sizeof(void *));
+	}
+	lexicalAnalyzer->importedInputBuffers[lexicalAnalyzer->importedInputBufferCount++] = lexicalAnalyzer->inputBuffer;
+	pushInputBuffer(lexicalAnalyzer->inputBuffer);
+	lexicalAnalyzer->inputBuffer = NULL;
+}
+
 void pushInputBuffer(InputBuffer * inputBuffer) {
+	inputBuffer->pushed = true;
 	yypush_buffer_state((YY_BUFFER_STATE) inputBuffer->buffer, (yyscan_t) inputBuffer->lexicalAnalyzer->scanner);
 }
 
 CompilationStatus pushToken(LexicalAnalyzer * lexicalAnalyzer, Token * token) {
-	return (CompilationStatus) yypush_parse(
-		(yypstate *) lexicalAnalyzer->parser,
-		token->label,
-		token->semanticValue,
-		(YYLTYPE *) lexicalAnalyzer->location);
+	CompilerState * compilerState = lexicalAnalyzer->compilerState;
+	++compilerState->metrics.tokens;
+	if (recordImportedToken(compilerState->importCache, token->label, token->semanticValue->integer)) {
+		return IN_PROGRESS;
+	}
+	return _parse(lexicalAnalyzer, token->label);
+}
+
+void resetLexicalAnalyzer(LexicalAnalyzer * lexicalAnalyzer) {
+	flexReset(lexicalAnalyzer);
+	_destroyImportedInputBuffers(lexicalAnalyzer);
+	resetImportPrefetcher(lexicalAnalyzer->importPrefetcher);
+	if (lexicalAnalyzer->inputBuffer != NULL) {
+		destroyInputBuffer(lexicalAnalyzer->inputBuffer);
+		lexicalAnalyzer->inputBuffer = NULL;
+	}
+	if (lexicalAnalyzer->parserStatus == IN_PROGRESS) {
+		// Bison only restarts by itself a parser that accepted or aborted:
+		yypstate_delete((yypstate *) lexicalAnalyzer->parser);
+		lexicalAnalyzer->parser = yypstate_new();
+		lexicalAnalyzer->parserStatus = SUCCEEDED;
+	}
+	lexicalAnalyzer->compilerState = NULL;
+	lexicalAnalyzer->pendingImport = NULL;
+	lexicalAnalyzer->prefetchedEnd = NULL;
+	memset(lexicalAnalyzer->location, 0, sizeof(YYLTYPE));
 }
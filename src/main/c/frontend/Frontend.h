@@ -3,38 +3,67 @@
 
 #include "../support/logging/Logger.h"
 #include "../support/type/CompilationStatus.h"
+#include "../support/type/CompilerState.h"
 #include "../support/type/FlexContext.h"
 #include "../support/type/InputBuffer.h"
 #include "../support/type/LexicalAnalyzer.h"
 #include "../support/type/ModuleDestructor.h"
 #include "../support/type/Token.h"
 #include "../support/type/TokenLabel.h"
+#include "../support/configuration/Environment.h"
 #include "lexical-analysis/FlexScanner.h"
+#include "lexical-analysis/ImportCache.h"
+#include "lexical-analysis/ImportPrefetcher.h"
+#include "syntactic-analysis/FlatSyntaxTree.h"
+#include <fcntl.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 /** Initialize module's internal state. */
-ModuleDestructor initializeFrontendModule(LexicalAnalyzer * lexicalAnalyzer);
+ModuleDestructor initializeFrontendModule();
 
 /**
- * Creates a new input buffer for the scanner.
+ * Creates a new input buffer for the scanner. If the "MAPPED" input mode is
+ * active, the file is mapped in memory and scanned in place, without copies
+ * nor refills. Returns NULL if the file cannot be opened. The buffer is not
+ * scanned until it's pushed (see "pushInputBuffer").
  *
  * @see https://westes.github.io/flex/manual/Multiple-Input-Buffers.html
  */
 InputBuffer * createInputBuffer(LexicalAnalyzer * lexicalAnalyzer, const char * path);
 
 /**
- * Creates a new reentrant lexical-analyzer.
- *
- * @see https://westes.github.io/flex/manual/Reentrant.html
+ * Creates a new input buffer that scans a program already stored in memory.
+ * The last two bytes of the memory (included in its size) must be null, as
+ * Flex requires. The memory is not copied, so it must outlive the scanning,
+ * and it's not released with the buffer.
  */
-LexicalAnalyzer * createLexicalAnalyzer();
+InputBuffer * createMemoryInputBuffer(LexicalAnalyzer * lexicalAnalyzer, char * memory, const size_t sizeInBytes);
 
 /**
- * Creates a new token. You need to set the semantic-value after creation.
+ * Maps the standard input in memory and makes it the current input buffer of
+ * the scanner, if the "MAPPED" input mode is active and the standard input is
+ * a regular file (from its current offset, so a file partially read by a
+ * parent process is scanned as with a stream). Otherwise, returns NULL, and
+ * the scanner reads the standard input through "stdio" as usual (e.g., from a
+ * pipe).
+ */
+InputBuffer * createStandardInputBuffer(LexicalAnalyzer * lexicalAnalyzer);
+
+/**
+ * Creates a new reentrant lexical-analyzer. Before every compilation, set its
+ * compiler state, which reaches the parser and its semantic actions. Many
+ * compilations can run at the same time, if each one has its own
+ * lexical-analyzer (see "resetLexicalAnalyzer" to reuse it afterwards).
+ *
+ * @see https://westes.github.io/flex/manual/Reentrant.html
  */
-Token * createToken(LexicalAnalyzer * lexicalAnalyzer, TokenLabel label);
+LexicalAnalyzer * createLexicalAnalyzer();
 
 /**
  * Returns the current lexical-analyzer context identifier.
@@ -47,15 +76,11 @@ FlexContext currentLexicalAnalyzerContext(LexicalAnalyzer * lexicalAnalyzer);
 void destroyInputBuffer(InputBuffer * inputBuffer);
 
 /**
- * Destroys a lexical-analyzer and its resources.
+ * Destroys a lexical-analyzer and its resources (including the input buffers
+ * of the imports, and the prefetcher).
  */
 void destroyLexicalAnalyzer(LexicalAnalyzer * lexicalAnalyzer);
 
-/**
- * Destroys a token.
- */
-void destroyToken(Token * token);
-
 /**
  * Enters to a new nested lexical-analyzer context.
  */
@@ -69,7 +94,7 @@ CompilationStatus executeLexicalAnalysis(LexicalAnalyzer * lexicalAnalyzer);
 /**
  * Starts parsing the input until it reaches the end or fails.
  */
-CompilationStatus executeSyntacticAnalysis();
+CompilationStatus executeSyntacticAnalysis(LexicalAnalyzer * lexicalAnalyzer);
 
 /**
  * Leaves the current nested lexical-analyzer context.
@@ -77,19 +102,59 @@ CompilationStatus executeSyntacticAnalysis();
 void leaveLexicalAnalyzerContext(LexicalAnalyzer * lexicalAnalyzer);
 
 /**
- * Pops the current input buffer from the lexical-analyzer. Returns true if
- * there is more input buffers available; false otherwise.
+ * Fills the token slot of the lexical-analyzer with the current lexeme, and
+ * returns it. You need to set the semantic-value after that. The token is
+ * overwritten by the next call, so it must not be destroyed nor retained.
+ */
+Token * nextToken(LexicalAnalyzer * lexicalAnalyzer, TokenLabel label);
+
+/**
+ * Pops the current input buffer from the lexical-analyzer, and destroys it if
+ * it belongs to an import. Returns true if there is more input buffers
+ * available; false otherwise.
  */
 bool popInputBuffer(LexicalAnalyzer * lexicalAnalyzer);
 
+/**
+ * Prefetches the imports that follow the current one in the text that the
+ * scanner already read (see "ImportPrefetcher.h"), so they are read in the
+ * background before the scanner reaches them. The path of the current import
+ * is not prefetched, because the scanner opens it right away. The text of a
+ * buffer is only scanned again after a refill.
+ */
+void prefetchNextImports(LexicalAnalyzer * lexicalAnalyzer, const char * path);
+
+/**
+ * Pushes an import to the parser input stream, as if its file were lexed
+ * again: a shareable import is pushed as a single token, and any other one as
+ * all of its tokens. Inside another file that is being lexed, the import is
+ * recorded there instead.
+ */
+CompilationStatus pushImport(LexicalAnalyzer * lexicalAnalyzer, Import * import);
+
+/**
+ * Pushes the pending input buffer of an import (see "createInputBuffer") on
+ * top of the stack of imports. The lexical-analyzer owns it from now on.
+ */
+void pushImportedInputBuffer(LexicalAnalyzer * lexicalAnalyzer);
+
 /**
  * Pushes a new input buffer to merge its tokens into the stream.
  */
 void pushInputBuffer(InputBuffer * inputBuffer);
 
 /**
- * Pushes a new token to the parser input stream.
+ * Pushes a new token to the parser input stream (or records it, while an
+ * imported file is being lexed).
  */
 CompilationStatus pushToken(LexicalAnalyzer * lexicalAnalyzer, Token * token);
 
+/**
+ * Leaves the lexical-analyzer ready for a new compilation, as if it had just
+ * been created: drops the input buffers and the contexts left by the last
+ * compilation, and restarts the parser if it didn't finish. The input buffers
+ * created by the caller can be destroyed only after this.
+ */
+void resetLexicalAnalyzer(LexicalAnalyzer * lexicalAnalyzer);
+
 #endif
@@ -0,0 +1,253 @@
+#include "FastScanner.h"
+
+/* MODULE INTERNAL STATE */
+
+static bool _advancedVectorExtensions = false;
+static Logger * _logger = NULL;
+
+/** Shutdown module's internal state. */
+void _shutdownFastScannerModule() {
+	if (_logger != NULL) {
+		LOG_DEBUGGING(_logger, "Destroying module: FastScanner...");
+		destroyLogger(_logger);
+		_logger = NULL;
+	}
+}
+
+ModuleDestructor initializeFastScannerModule() {
+	_logger = createLogger("FastScanner");
+#if defined(__x86_64__)
+	_advancedVectorExtensions = __builtin_cpu_supports("avx2");
+	LOG_DEBUGGING(_logger, "The fast scanner compares %d bytes at once.", _advancedVectorExtensions ? 32 : 16);
+#endif
+	return _shutdownFastScannerModule;
+}
+
+/* PRIVATE FUNCTIONS */
+
+#if defined(__x86_64__)
+static size_t _countLineFeedsAvx2(const char * text, const size_t length, size_t * count);
+static size_t _countLineFeedsSse2(const char * text, const size_t length, size_t * count);
+#endif
+static bool _isWhitespace(const char character);
+static uint64_t _parseEightDigits(const char * digits);
+#if defined(__x86_64__)
+static size_t _skipCommentBodyAvx2(const char * text, const size_t length);
+static size_t _skipCommentBodySse2(const char * text, const size_t length);
+static size_t _skipWhitespaceAvx2(const char * text, const size_t length);
+static size_t _skipWhitespaceSse2(const char * text, const size_t length);
+#endif
+
+#if defined(__x86_64__)
+
+/**
+ * Counts the line-feeds of every whole block of 32 bytes. Returns the length
+ * counted, so the rest is counted a byte at a time.
+ */
+__attribute__((target("avx2")))
+static size_t _countLineFeedsAvx2(const char * text, const size_t length, size_t * count) {
+	const __m256i lineFeed = _mm256_set1_epi8('\n');
+	size_t k = 0;
+	for (; k + 32 <= length; k += 32) {
+		const __m256i bytes = _mm256_loadu_si256((const __m256i *) (text + k));
+		*count += __builtin_popcount((uint32_t) _mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, lineFeed)));
+	}
+	return k;
+}
+
+/**
+ * Counts the line-feeds of every whole block of 16 bytes. Returns the length
+ * counted, so the rest is counted a byte at a time.
+ */
+static size_t _countLineFeedsSse2(const char * text, const size_t length, size_t * count) {
+	const __m128i lineFeed = _mm_set1_epi8('\n');
+	size_t k = 0;
+	for (; k + 16 <= length; k += 16) {
+		const __m128i bytes = _mm_loadu_si128((const __m128i *) (text + k));
+		*count += __builtin_popcount((uint32_t) _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, lineFeed)));
+	}
+	return k;
+}
+
+#endif
+
+/**
+ * Whether a character belongs to the "[[:space:]]" class: a space, or a
+ * control character between "\t" and "\r".
+ */
+static bool _isWhitespace(const char character) {
+	return character == ' ' || (unsigned char) (character - '\t') <= '\r' - '\t';
+}
+
+/**
+ * Parses 8 digits at once, within a 64-bit word (a.k.a. SWAR): every step
+ * combines the adjacent pairs of the previous one, so the first digit, in
+ * the lowest byte, ends up as the most significant one.
+ *
+ * @see https://lemire.me/blog/2022/01/21/swar-explained-parsing-eight-digits/
+ */
+static uint64_t _parseEightDigits(const char * digits) {
+	uint64_t value;
+	memcpy(&value, digits, sizeof(value));
+	value -= 0x3030303030303030ULL;
+	value = (10 * value + (value >> 8)) & 0x00FF00FF00FF00FFULL;
+	value = (100 * value + (value >> 16)) & 0x0000FFFF0000FFFFULL;
+	return (10000 * value + (value >> 32)) & 0x00000000FFFFFFFFULL;
+}
+
+#if defined(__x86_64__)
+
+/**
+ * Finds the first asterisk followed by a slash, within the whole blocks of 32
+ * bytes: every block is compared with the block one byte ahead. Returns its
+ * position, or the length searched if there is none.
+ */
+__attribute__((target("avx2")))
+static size_t _skipCommentBodyAvx2(const char * text, const size_t length) {
+	const __m256i asterisk = _mm256_set1_epi8('*');
+	const __m256i slash = _mm256_set1_epi8('/');
+	size_t k = 0;
+	for (; k + 33 <= length; k += 32) {
+		const __m256i bytes = _mm256_loadu_si256((const __m256i *) (text + k));
+		const __m256i nextBytes = _mm256_loadu_si256((const __m256i *) (text + k + 1));
+		const uint32_t mask = _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(bytes, asterisk), _mm256_cmpeq_epi8(nextBytes, slash)));
+		if (mask != 0) {
+			return k + __builtin_ctz(mask);
+		}
+	}
+	return k;
+}
+
+/**
+ * Finds the first asterisk followed by a slash, within the whole blocks of 16
+ * bytes (as the AVX2 version does).
+ */
+static size_t _skipCommentBodySse2(const char * text, const size_t length) {
+	const __m128i asterisk = _mm_set1_epi8('*');
+	const __m128i slash = _mm_set1_epi8('/');
+	size_t k = 0;
+	for (; k + 17 <= length; k += 16) {
+		const __m128i bytes = _mm_loadu_si128((const __m128i *) (text + k));
+		const __m128i nextBytes = _mm_loadu_si128((const __m128i *) (text + k + 1));
+		const uint32_t mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(bytes, asterisk), _mm_cmpeq_epi8(nextBytes, slash)));
+		if (mask != 0) {
+			return k + __builtin_ctz(mask);
+		}
+	}
+	return k;
+}
+
+/**
+ * Finds the first character that is not whitespace, within the whole blocks
+ * of 32 bytes. A control character is whitespace if its unsigned distance to
+ * "\t" is at most 4 (i.e., if the minimum of both is the distance itself,
+ * because there is no unsigned comparison of bytes). Returns its position, or
+ * the length searched if there is none.
+ */
+__attribute__((target("avx2")))
+static size_t _skipWhitespaceAvx2(const char * text, const size_t length) {
+	const __m256i space = _mm256_set1_epi8(' ');
+	const __m256i tab = _mm256_set1_epi8('\t');
+	const __m256i controlRange = _mm256_set1_epi8('\r' - '\t');
+	size_t k = 0;
+	for (; k + 32 <= length; k += 32) {
+		const __m256i bytes = _mm256_loadu_si256((const __m256i *) (text + k));
+		const __m256i distance = _mm256_sub_epi8(bytes, tab);
+		const __m256i whitespace = _mm256_or_si256(
+			_mm256_cmpeq_epi8(bytes, space),
+			_mm256_cmpeq_epi8(_mm256_min_epu8(distance, controlRange), distance));
+		const uint32_t mask = ~(uint32_t) _mm256_movemask_epi8(whitespace);
+		if (mask != 0) {
+			return k + __builtin_ctz(mask);
+		}
+	}
+	return k;
+}
+
+/**
+ * Finds the first character that is not whitespace, within the whole blocks
+ * of 16 bytes (as the AVX2 version does).
+ */
+static size_t _skipWhitespaceSse2(const char * text, const size_t length) {
+	const __m128i space = _mm_set1_epi8(' ');
+	const __m128i tab = _mm_set1_epi8('\t');
+	const __m128i controlRange = _mm_set1_epi8('\r' - '\t');
+	size_t k = 0;
+	for (; k + 16 <= length; k += 16) {
+		const __m128i bytes = _mm_loadu_si128((const __m128i *) (text + k));
+		const __m128i distance = _mm_sub_epi8(bytes, tab);
+		const __m128i whitespace = _mm_or_si128(
+			_mm_cmpeq_epi8(bytes, space),
+			_mm_cmpeq_epi8(_mm_min_epu8(distance, controlRange), distance));
+		const uint32_t mask = ~(uint32_t) _mm_movemask_epi8(whitespace) & 0xFFFF;
+		if (mask != 0) {
+			return k + __builtin_ctz(mask);
+		}
+	}
+	return k;
+}
+
+#endif
+
+/* PUBLIC FUNCTIONS */
+
+size_t countLineFeeds(const char * text, const size_t length) {
+	size_t count = 0;
+	size_t k = 0;
+#if defined(__x86_64__)
+	k = _advancedVectorExtensions
+		? _countLineFeedsAvx2(text, length, &count)
+		: _countLineFeedsSse2(text, length, &count);
+#endif
+	for (; k < length; ++k) {
+		count += text[k] == '\n';
+	}
+	return count;
+}
+
+int parseDigits(const char * digits, const size_t length) {
+	size_t k = 0;
+	while (k < length && digits[k] == '0') {
+		++k;
+	}
+	// More than 19 significant digits are always larger than LONG_MAX:
+	if (19 < length - k) {
+		return (int) LONG_MAX;
+	}
+	uint64_t value = 0;
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	for (; k + 8 <= length; k += 8) {
+		value = 100000000 * value + _parseEightDigits(digits + k);
+	}
+#endif
+	for (; k < length; ++k) {
+		value = 10 * value + (digits[k] - '0');
+	}
+	return (int) (long) (value <= LONG_MAX ? value : LONG_MAX);
+}
+
+size_t skipCommentBody(const char * text, const size_t length) {
+	size_t k = 0;
+#if defined(__x86_64__)
+	k = _advancedVectorExtensions
+		? _skipCommentBodyAvx2(text, length)
+		: _skipCommentBodySse2(text, length);
+#endif
+	while (k < length && !(text[k] == '*' && (k + 1 == length || text[k + 1] == '/'))) {
+		++k;
+	}
+	return k;
+}
+
+size_t skipWhitespace(const char * text, const size_t length) {
+	size_t k = 0;
+#if defined(__x86_64__)
+	k = _advancedVectorExtensions
+		? _skipWhitespaceAvx2(text, length)
+		: _skipWhitespaceSse2(text, length);
+#endif
+	while (k < length && _isWhitespace(text[k])) {
+		++k;
+	}
+	return k;
+}
@@ -0,0 +1,56 @@
+#ifndef FAST_SCANNER_HEADER
+#define FAST_SCANNER_HEADER
+
+#include "../../support/logging/Logger.h"
+#include "../../support/type/ModuleDestructor.h"
+#include <limits.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+/** Initialize module's internal state. */
+ModuleDestructor initializeFastScannerModule();
+
+/**
+ * The fast paths of the lexical-analyzer, over the lexemes that Flex matches
+ * one transition per byte, but that need no state machine at all: the runs
+ * of whitespace, the bodies of the comments, and the runs of digits. On
+ * x86-64, they compare 16 bytes at once with SSE2, or 32 bytes with AVX2 if
+ * the host supports it; on other hosts, they compare a byte at a time.
+ *
+ * Every function receives the text available (not null-terminated), and
+ * never reads past its length.
+ */
+
+/**
+ * Counts the line-feeds of a text (to advance the line number over a skipped
+ * text).
+ */
+size_t countLineFeeds(const char * text, const size_t length);
+
+/**
+ * Parses a run of decimal digits, with exactly the same result of "atoi"
+ * (i.e., a value larger than LONG_MAX saturates, and it's truncated to an
+ * "int" afterwards).
+ */
+int parseDigits(const char * digits, const size_t length);
+
+/**
+ * Returns the length of the prefix of the body of a comment that can be
+ * skipped: everything before the first "*" followed by "/" (or before an "*"
+ * at the end of the text, which may be followed by "/" later).
+ */
+size_t skipCommentBody(const char * text, const size_t length);
+
+/**
+ * Returns the length of the prefix of a text made of whitespace (i.e., the
+ * "[[:space:]]" class of Flex: space, "\t", "\n", "\v", "\f" and "\r").
+ */
+size_t skipWhitespace(const char * text, const size_t length);
+
+#endif
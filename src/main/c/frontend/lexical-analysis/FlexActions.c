@@ -2,30 +2,26 @@
 
 /* MODULE INTERNAL STATE */
 
+static bool _fastScanner = false;
 static bool _logIgnoredLexemes = true;
-static InputBuffer * _inputBuffer = NULL;
-static LexicalAnalyzer * _lexicalAnalyzer = NULL;
 static Logger * _logger = NULL;
 
 /** Shutdown module's internal state. */
 void _shutdownFlexActionsModule() {
 	if (_logger != NULL) {
-		logDebugging(_logger, "Destroying module: FlexActions...");
+		LOG_DEBUGGING(_logger, "Destroying module: FlexActions...");
 		destroyLogger(_logger);
 		_logger = NULL;
 	}
-	if (_inputBuffer != NULL) {
-		destroyInputBuffer(_inputBuffer);
-		_inputBuffer = NULL;
-	}
-	_lexicalAnalyzer = NULL;
 }
 
-ModuleDestructor initializeFlexActionsModule(LexicalAnalyzer * lexicalAnalyzer) {
-	_inputBuffer = NULL;
-	_lexicalAnalyzer = lexicalAnalyzer;
+ModuleDestructor initializeFlexActionsModule() {
 	_logger = createLogger("FlexActions");
 	_logIgnoredLexemes = getBooleanOrDefault("LOG_IGNORED_LEXEMES", _logIgnoredLexemes);
+	// The text skipped by the fast scanner produces no lexemes, so it's only
+	// used if the ignored lexemes are not logged:
+	_fastScanner = getBooleanOrDefault("FAST_SCANNER", _fastScanner)
+		&& !(_logIgnoredLexemes && IS_LOGGING_ENABLED(_logger, DEBUGGING));
 	return _shutdownFlexActionsModule;
 }
 
@@ -34,11 +30,15 @@ ModuleDestructor initializeFlexActionsModule(LexicalAnalyzer * lexicalAnalyzer)
 static void _logTokenAction(const char * actionName, Token * token);
 
 /**
- * Logs a lexical-analyzer action over a token in DEBUGGING level.
+ * Logs a lexical-analyzer action over a token in DEBUGGING level. The lexeme
+ * is only escaped if the log is visible.
  */
 static void _logTokenAction(const char * actionName, Token * token) {
+	if (!IS_LOGGING_ENABLED(_logger, DEBUGGING)) {
+		return;
+	}
 	char * _lexeme = escape(token->lexeme);
-	logDebugging(_logger, WARNING_COLOR "%s" DEFAULT_COLOR ": Token(context=%d, label=%d, length=%d, lexeme=%s\"%s\"%s, line=%d, semanticValue=%p)",
+	LOG_DEBUGGING(_logger, WARNING_COLOR "%s" DEFAULT_COLOR ": Token(context=%d, label=%d, length=%d, lexeme=%s\"%s\"%s, line=%d, semanticValue=%p)",
 		actionName,
 		token->context,
 		token->label,
@@ -52,110 +52,129 @@ static void _logTokenAction(const char * actionName, Token * token) {
 
 /* PUBLIC FUNCTIONS */
 
-CompilationStatus ArithmeticOperatorLexemeAction(TokenLabel label) {
-	Token * token = createToken(_lexicalAnalyzer, label);
+CompilationStatus ArithmeticOperatorLexemeAction(LexicalAnalyzer * lexicalAnalyzer, TokenLabel label) {
+	Token * token = nextToken(lexicalAnalyzer, label);
 	_logTokenAction(__FUNCTION__, token);
-	CompilationStatus status = pushToken(_lexicalAnalyzer, token);
-	destroyToken(token);
-	return status;
+	return pushToken(lexicalAnalyzer, token);
 }
 
-CompilationStatus EnterImportExpressionLexemeAction(FlexContext context) {
+CompilationStatus EnterImportExpressionLexemeAction(LexicalAnalyzer * lexicalAnalyzer, FlexContext context) {
 	if (_logIgnoredLexemes) {
-		Token * token = createToken(_lexicalAnalyzer, OPEN_BRACE);
+		Token * token = nextToken(lexicalAnalyzer, OPEN_BRACE);
 		_logTokenAction(__FUNCTION__, token);
-		destroyToken(token);
 	}
-	enterLexicalAnalyzerContext(_lexicalAnalyzer, context);
+	enterLexicalAnalyzerContext(lexicalAnalyzer, context);
 	return IN_PROGRESS;
 }
 
-CompilationStatus EnterMultilineCommentLexemeAction(FlexContext context) {
+CompilationStatus EnterMultilineCommentLexemeAction(LexicalAnalyzer * lexicalAnalyzer, FlexContext context) {
 	if (_logIgnoredLexemes) {
-		Token * token = createToken(_lexicalAnalyzer, OPEN_COMMENT);
+		Token * token = nextToken(lexicalAnalyzer, OPEN_COMMENT);
 		_logTokenAction(__FUNCTION__, token);
-		destroyToken(token);
 	}
-	enterLexicalAnalyzerContext(_lexicalAnalyzer, context);
+	enterLexicalAnalyzerContext(lexicalAnalyzer, context);
 	return IN_PROGRESS;
 }
 
-CompilationStatus EOFLexemeAction() {
+CompilationStatus EOFLexemeAction(LexicalAnalyzer * lexicalAnalyzer) {
 	CompilationStatus status = IN_PROGRESS;
-	Token * token = createToken(_lexicalAnalyzer, 0);
+	Token * token = nextToken(lexicalAnalyzer, 0);
 	_logTokenAction(__FUNCTION__, token);
-	if (!popInputBuffer(_lexicalAnalyzer)) {
-		status = pushToken(_lexicalAnalyzer, token);
-		FlexContext context = currentLexicalAnalyzerContext(_lexicalAnalyzer);
+	if (!popInputBuffer(lexicalAnalyzer)) {
+		status = pushToken(lexicalAnalyzer, token);
+		FlexContext context = currentLexicalAnalyzerContext(lexicalAnalyzer);
 		if (0 < context) {
-			logError(_logger, "The final context is not closed (context=%d).", context);
+			LOG_ERROR(_logger, "The final context is not closed (context=%d).", context);
 			status = FAILED;
 		}
 	}
-	destroyToken(token);
+	else {
+		// The end of an imported file, whose tokens were recorded:
+		Import * import = endImport(lexicalAnalyzer->compilerState->importCache);
+		if (import != NULL) {
+			status = pushImport(lexicalAnalyzer, import);
+		}
+	}
 	return status;
 }
 
-CompilationStatus IgnoredLexemeAction() {
+CompilationStatus IgnoredLexemeAction(LexicalAnalyzer * lexicalAnalyzer) {
 	if (_logIgnoredLexemes) {
-		Token * token = createToken(_lexicalAnalyzer, IGNORED);
+		Token * token = nextToken(lexicalAnalyzer, IGNORED);
 		_logTokenAction(__FUNCTION__, token);
-		destroyToken(token);
 	}
 	return IN_PROGRESS;
 }
 
-CompilationStatus IntegerLexemeAction() {
-	Token * token = createToken(_lexicalAnalyzer, INTEGER);
-	token->semanticValue->integer = atoi(token->lexeme);
+CompilationStatus IntegerLexemeAction(LexicalAnalyzer * lexicalAnalyzer) {
+	Token * token = nextToken(lexicalAnalyzer, INTEGER);
+	token->semanticValue->integer = _fastScanner
+		? parseDigits(token->lexeme, token->length)
+		: atoi(token->lexeme);
 	_logTokenAction(__FUNCTION__, token);
-	CompilationStatus status = pushToken(_lexicalAnalyzer, token);
-	destroyToken(token);
-	return status;
+	return pushToken(lexicalAnalyzer, token);
+}
+
+bool IsFastScannerEnabled() {
+	return _fastScanner;
 }
 
-CompilationStatus LeaveImportExpressionLexemeAction() {
-	pushInputBuffer(_inputBuffer);
-	leaveLexicalAnalyzerContext(_lexicalAnalyzer);
+CompilationStatus LeaveImportExpressionLexemeAction(LexicalAnalyzer * lexicalAnalyzer) {
+	CompilationStatus status = IN_PROGRESS;
+	Import * import = lexicalAnalyzer->pendingImport;
+	if (import != NULL) {
+		// The file was already lexed, so its tokens are replayed instead:
+		lexicalAnalyzer->pendingImport = NULL;
+		status = pushImport(lexicalAnalyzer, import);
+	}
+	else if (lexicalAnalyzer->inputBuffer == NULL) {
+		LOG_ERROR(_logger, "The imported file cannot be opened.");
+		return FAILED;
+	}
+	else {
+		pushImportedInputBuffer(lexicalAnalyzer);
+		beginImport(lexicalAnalyzer->compilerState->importCache);
+	}
+	leaveLexicalAnalyzerContext(lexicalAnalyzer);
 	if (_logIgnoredLexemes) {
-		Token * token = createToken(_lexicalAnalyzer, CLOSE_BRACE);
+		Token * token = nextToken(lexicalAnalyzer, CLOSE_BRACE);
 		_logTokenAction(__FUNCTION__, token);
-		destroyToken(token);
 	}
-	return IN_PROGRESS;
+	return status;
 }
 
-CompilationStatus LeaveMultilineCommentLexemeAction() {
-	leaveLexicalAnalyzerContext(_lexicalAnalyzer);
+CompilationStatus LeaveMultilineCommentLexemeAction(LexicalAnalyzer * lexicalAnalyzer) {
+	leaveLexicalAnalyzerContext(lexicalAnalyzer);
 	if (_logIgnoredLexemes) {
-		Token * token = createToken(_lexicalAnalyzer, CLOSE_COMMENT);
+		Token * token = nextToken(lexicalAnalyzer, CLOSE_COMMENT);
 		_logTokenAction(__FUNCTION__, token);
-		destroyToken(token);
 	}
 	return IN_PROGRESS;
 }
 
-CompilationStatus ParenthesisLexemeAction(TokenLabel label) {
-	Token * token = createToken(_lexicalAnalyzer, label);
+CompilationStatus ParenthesisLexemeAction(LexicalAnalyzer * lexicalAnalyzer, TokenLabel label) {
+	Token * token = nextToken(lexicalAnalyzer, label);
 	_logTokenAction(__FUNCTION__, token);
-	CompilationStatus status = pushToken(_lexicalAnalyzer, token);
-	destroyToken(token);
-	return status;
+	return pushToken(lexicalAnalyzer, token);
 }
 
-CompilationStatus SubexpressionLexemeAction() {
-	Token * token = createToken(_lexicalAnalyzer, IGNORED);
-	_inputBuffer = createInputBuffer(_lexicalAnalyzer, token->lexeme);
+CompilationStatus SubexpressionLexemeAction(LexicalAnalyzer * lexicalAnalyzer) {
+	Token * token = nextToken(lexicalAnalyzer, IGNORED);
 	if (_logIgnoredLexemes) {
 		_logTokenAction(__FUNCTION__, token);
 	}
-	destroyToken(token);
+	lexicalAnalyzer->pendingImport = findImport(lexicalAnalyzer->compilerState->importCache, token->lexeme);
+	if (lexicalAnalyzer->pendingImport == NULL) {
+		prefetchNextImports(lexicalAnalyzer, token->lexeme);
+		// The lexeme is not available after creating the buffer, because a
+		// mapped input buffer switches the state of the scanner back and forth.
+		lexicalAnalyzer->inputBuffer = createInputBuffer(lexicalAnalyzer, token->lexeme);
+	}
 	return IN_PROGRESS;
 }
 
-CompilationStatus UnknownLexemeAction() {
-	Token * token = createToken(_lexicalAnalyzer, UNKNOWN);
+CompilationStatus UnknownLexemeAction(LexicalAnalyzer * lexicalAnalyzer) {
+	Token * token = nextToken(lexicalAnalyzer, UNKNOWN);
 	_logTokenAction(__FUNCTION__, token);
-	destroyToken(token);
 	return FAILED;
 }
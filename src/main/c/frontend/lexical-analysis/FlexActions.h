@@ -11,8 +11,16 @@
 #include "../../support/type/Token.h"
 #include "../../support/type/TokenLabel.h"
 #include "../Frontend.h"
+#include "FastScanner.h"
+#include "ImportCache.h"
 
 /** Initialize module's internal state. */
 ModuleDestructor initializeFlexActionsModule();
 
+/**
+ * Whether the scanner skips the whitespace and the bodies of the comments
+ * with the fast scanner (see "FastScanner.h"), before matching each lexeme.
+ */
+bool IsFastScannerEnabled();
+
 #endif
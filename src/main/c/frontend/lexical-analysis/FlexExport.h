@@ -3,13 +3,16 @@
 
 #include "../../support/type/FlexContext.h"
 #include "../../support/type/LexicalAnalyzer.h"
+#include "FastScanner.h"
 #include <stdbool.h>
+#include <stddef.h>
 
 /**
  * Hook that allows to export a static function or variable from the inside of
  * Flex infrastructure, in this case, the current context (a.k.a. start
- * condition). This source exists only because Flex uses static for methods
- * that are in its public API, a clearly flawed design decision.
+ * condition), and the position of the scanner in its buffer. This source
+ * exists only because Flex uses static for methods that are in its public
+ * API, a clearly flawed design decision.
  */
 
 FlexContext flexCurrentContext(LexicalAnalyzer * lexicalAnalyzer) {
@@ -21,6 +24,21 @@ void flexEnterContext(LexicalAnalyzer * lexicalAnalyzer, FlexContext flexContext
 	yy_push_state(flexContext, lexicalAnalyzer->scanner);
 }
 
+void * flexCreateMemoryBuffer(LexicalAnalyzer * lexicalAnalyzer, char * memory, const size_t sizeInBytes) {
+	struct yyguts_t * yyg = (struct yyguts_t *) lexicalAnalyzer->scanner;
+	YY_BUFFER_STATE currentBuffer = YY_CURRENT_BUFFER;
+	YY_BUFFER_STATE buffer = yy_scan_buffer(memory, sizeInBytes, lexicalAnalyzer->scanner);
+	// Because "yy_scan_buffer" also switches to the new buffer, which must wait
+	// until it's pushed:
+	if (currentBuffer != NULL) {
+		yy_switch_to_buffer(currentBuffer, lexicalAnalyzer->scanner);
+	}
+	else {
+		YY_CURRENT_BUFFER_LVALUE = NULL;
+	}
+	return buffer;
+}
+
 bool flexHasBuffer(LexicalAnalyzer * lexicalAnalyzer) {
 	struct yyguts_t * yyg = (struct yyguts_t *) lexicalAnalyzer->scanner;
 	return YY_CURRENT_BUFFER != NULL;
@@ -30,4 +48,74 @@ void flexLeaveContext(LexicalAnalyzer * lexicalAnalyzer) {
 	yy_pop_state(lexicalAnalyzer->scanner);
 }
 
+/**
+ * Returns the text that the scanner already read past the current lexeme and
+ * the character that follows it (which Flex holds), up to the end of the text
+ * available in its buffer, without consuming it. The end of that text is the
+ * same until the buffer is refilled.
+ */
+const char * flexLookahead(LexicalAnalyzer * lexicalAnalyzer, size_t * length) {
+	struct yyguts_t * yyg = (struct yyguts_t *) lexicalAnalyzer->scanner;
+	*length = 0;
+	if (YY_CURRENT_BUFFER == NULL) {
+		return NULL;
+	}
+	const char * text = yyg->yy_c_buf_p + 1;
+	const char * end = &YY_CURRENT_BUFFER_LVALUE->yy_ch_buf[yyg->yy_n_chars];
+	if (end <= text) {
+		return end;
+	}
+	*length = end - text;
+	return text;
+}
+
+void flexReset(LexicalAnalyzer * lexicalAnalyzer) {
+	struct yyguts_t * yyg = (struct yyguts_t *) lexicalAnalyzer->scanner;
+	while (YY_CURRENT_BUFFER != NULL) {
+		yypop_buffer_state(lexicalAnalyzer->scanner);
+	}
+	// Leaves every context, except the initial one:
+	while (1 < yyg->yy_start_stack_ptr) {
+		yy_pop_state(lexicalAnalyzer->scanner);
+	}
+}
+
+/**
+ * Advances the scanner over the text that the fast scanner skips from its
+ * current position (see "FastScanner.h"): a run of whitespace, or the body of
+ * a comment. Only the text already in the buffer is skipped, so if the run
+ * goes on after a refill, Flex matches the rest as usual. The character after
+ * the previous lexeme is held by Flex (its place holds the null-terminator of
+ * that lexeme), so it's restored first, and the next one is held instead.
+ */
+void flexSkipIgnoredText(LexicalAnalyzer * lexicalAnalyzer) {
+	struct yyguts_t * yyg = (struct yyguts_t *) lexicalAnalyzer->scanner;
+	// Until the first scan, the position is not loaded from the buffer yet:
+	if (!yyg->yy_init || YY_CURRENT_BUFFER == NULL) {
+		return;
+	}
+	char * text = yyg->yy_c_buf_p;
+	const char * end = &YY_CURRENT_BUFFER_LVALUE->yy_ch_buf[yyg->yy_n_chars];
+	if (end <= text) {
+		return;
+	}
+	*text = yyg->yy_hold_char;
+	size_t length = 0;
+	switch (YYSTATE) {
+		case INITIAL:
+			length = skipWhitespace(text, end - text);
+			break;
+		case MULTILINE_COMMENT:
+			length = skipCommentBody(text, end - text);
+			break;
+		default:
+			break;
+	}
+	if (0 < length) {
+		yylineno += countLineFeeds(text, length);
+		yyg->yy_c_buf_p = text + length;
+		yyg->yy_hold_char = *yyg->yy_c_buf_p;
+	}
+}
+
 #endif
@@ -0,0 +1,280 @@
+#include "ImportCache.h"
+
+/* MODULE INTERNAL STATE */
+
+static const size_t _initialBucketCount = 64;
+static Logger * _logger = NULL;
+
+/** Shutdown module's internal state. */
+void _shutdownImportCacheModule() {
+	if (_logger != NULL) {
+		LOG_DEBUGGING(_logger, "Destroying module: ImportCache...");
+		destroyLogger(_logger);
+		_logger = NULL;
+	}
+}
+
+ModuleDestructor initializeImportCacheModule() {
+	_logger = createLogger("ImportCache");
+	return _shutdownImportCacheModule;
+}
+
+/* PRIVATE FUNCTIONS */
+
+static void _appendToken(Import * import, const ImportedToken token);
+static void _destroyEntry(ImportCacheEntry * entry);
+static size_t _hashIdentity(const ImportIdentity * identity);
+static void _insertEntry(ImportCache * importCache, ImportCacheEntry * entry);
+static bool _isParenthesizedExpression(const Import * import);
+static bool _isSameIdentity(const ImportIdentity * identity, const ImportIdentity * otherIdentity);
+
+/**
+ * Appends a token to an import, growing its array if needed.
+ */
+static void _appendToken(Import * import, const ImportedToken token) {
+	if (import->tokenCount == import->tokenCapacity) {
+		import->tokenCapacity = import->tokenCapacity == 0 ? 16 : 2 * import->tokenCapacity;
+		import->tokens = realloc(import->tokens, import->tokenCapacity * sizeof(ImportedToken));
+	}
+	import->tokens[import->tokenCount++] = token;
+}
+
+/**
+ * Destroys an entry, its identity and its import.
+ */
+static void _destroyEntry(ImportCacheEntry * entry) {
+	free(entry->identity.canonicalPath);
+	free(entry->import->tokens);
+	free(entry->import);
+	free(entry);
+}
+
+/**
+ * Hashes the canonical path and the inode of an identity (see "FNV-1a").
+ *
+ * @see https://en.wikipedia.org/wiki/Fowler%E2%80%93Noll%E2%80%93Vo_hash_function
+ */
+static size_t _hashIdentity(const ImportIdentity * identity) {
+	uint64_t hash = 14695981039346656037ULL;
+	if (identity->canonicalPath != NULL) {
+		for (const char * character = identity->canonicalPath; *character != '\0'; ++character) {
+			hash = (hash ^ (unsigned char) *character) * 1099511628211ULL;
+		}
+	}
+	hash = (hash ^ (uint64_t) identity->inode) * 1099511628211ULL;
+	return hash;
+}
+
+/**
+ * Inserts an entry in the table, doubling the amount of buckets when the
+ * load factor exceeds 3/4.
+ */
+static void _insertEntry(ImportCache * importCache, ImportCacheEntry * entry) {
+	if (4 * (importCache->entryCount + 1) > 3 * importCache->bucketCount) {
+		const size_t bucketCount = 2 * importCache->bucketCount;
+		ImportCacheEntry ** buckets = calloc(bucketCount, sizeof(ImportCacheEntry *));
+		for (size_t k = 0; k < importCache->bucketCount; ++k) {
+			ImportCacheEntry * current = importCache->buckets[k];
+			while (current != NULL) {
+				ImportCacheEntry * next = current->next;
+				const size_t bucket = _hashIdentity(&current->identity) % bucketCount;
+				current->next = buckets[bucket];
+				buckets[bucket] = current;
+				current = next;
+			}
+		}
+		free(importCache->buckets);
+		importCache->buckets = buckets;
+		importCache->bucketCount = bucketCount;
+	}
+	const size_t bucket = _hashIdentity(&entry->identity) % importCache->bucketCount;
+	entry->next = importCache->buckets[bucket];
+	importCache->buckets[bucket] = entry;
+	++importCache->entryCount;
+}
+
+/**
+ * Whether the tokens of an import are a single parenthesized expression that
+ * the grammar accepts: the first parenthesis closes at the last token, and
+ * the operands (integers, or nested imports) alternate with the operators.
+ * Only then, splicing the import as a factor is the same as splicing its
+ * text, whatever the precedence of the operators around it.
+ */
+static bool _isParenthesizedExpression(const Import * import) {
+	const ImportedToken * tokens = import->tokens;
+	const uint32_t count = import->tokenCount;
+	if (count < 3 || tokens[0].label != OPEN_PARENTHESIS || tokens[count - 1].label != CLOSE_PARENTHESIS) {
+		return false;
+	}
+	size_t depth = 0;
+	bool expectingOperand = true;
+	for (uint32_t k = 0; k < count; ++k) {
+		switch (tokens[k].label) {
+			case OPEN_PARENTHESIS:
+				if (!expectingOperand) {
+					return false;
+				}
+				++depth;
+				break;
+			case CLOSE_PARENTHESIS:
+				if (expectingOperand || depth == 0 || (--depth == 0 && k + 1 < count)) {
+					return false;
+				}
+				break;
+			case IMPORT:
+			case INTEGER:
+				if (!expectingOperand) {
+					return false;
+				}
+				expectingOperand = false;
+				break;
+			case ADD:
+			case DIV:
+			case MUL:
+			case SUB:
+				if (expectingOperand) {
+					return false;
+				}
+				expectingOperand = true;
+				break;
+			default:
+				return false;
+		}
+	}
+	return depth == 0;
+}
+
+/**
+ * Whether two identities refer to the same version of the same file. An
+ * identity without canonical path never matches.
+ */
+static bool _isSameIdentity(const ImportIdentity * identity, const ImportIdentity * otherIdentity) {
+	return identity->canonicalPath != NULL
+		&& otherIdentity->canonicalPath != NULL
+		&& identity->inode == otherIdentity->inode
+		&& identity->device == otherIdentity->device
+		&& identity->modification.tv_sec == otherIdentity->modification.tv_sec
+		&& identity->modification.tv_nsec == otherIdentity->modification.tv_nsec
+		&& strcmp(identity->canonicalPath, otherIdentity->canonicalPath) == 0;
+}
+
+/* PUBLIC FUNCTIONS */
+
+void beginImport(ImportCache * importCache) {
+	if (importCache == NULL) {
+		return;
+	}
+	ImportCacheEntry * entry = calloc(1, sizeof(ImportCacheEntry));
+	entry->identity = importCache->pendingIdentity;
+	entry->import = calloc(1, sizeof(Import));
+	entry->next = NULL;
+	importCache->pendingIdentity = (ImportIdentity) { 0 };
+	if (importCache->recordingCount == importCache->recordingCapacity) {
+		importCache->recordingCapacity = importCache->recordingCapacity == 0 ? 8 : 2 * importCache->recordingCapacity;
+		importCache->recordings = realloc(importCache->recordings, importCache->recordingCapacity * sizeof(ImportCacheEntry *));
+	}
+	importCache->recordings[importCache->recordingCount++] = entry;
+}
+
+ImportCache * createImportCache() {
+	ImportCache * importCache = calloc(1, sizeof(ImportCache));
+	importCache->bucketCount = _initialBucketCount;
+	importCache->buckets = calloc(importCache->bucketCount, sizeof(ImportCacheEntry *));
+	return importCache;
+}
+
+void destroyImportCache(ImportCache * importCache) {
+	if (importCache != NULL) {
+		for (size_t k = 0; k < importCache->bucketCount; ++k) {
+			ImportCacheEntry * entry = importCache->buckets[k];
+			while (entry != NULL) {
+				ImportCacheEntry * next = entry->next;
+				_destroyEntry(entry);
+				entry = next;
+			}
+		}
+		for (size_t k = 0; k < importCache->recordingCount; ++k) {
+			_destroyEntry(importCache->recordings[k]);
+		}
+		free(importCache->pendingIdentity.canonicalPath);
+		free(importCache->recordings);
+		free(importCache->buckets);
+		free(importCache);
+	}
+}
+
+Import * endImport(ImportCache * importCache) {
+	if (importCache == NULL || importCache->recordingCount == 0) {
+		return NULL;
+	}
+	ImportCacheEntry * entry = importCache->recordings[--importCache->recordingCount];
+	Import * import = entry->import;
+	import->shareable = _isParenthesizedExpression(import);
+	_insertEntry(importCache, entry);
+	LOG_DEBUGGING(_logger, "Import lexed: \"%s\" (tokens=%u, shareable=%s).",
+		entry->identity.canonicalPath == NULL ? "" : entry->identity.canonicalPath,
+		import->tokenCount,
+		import->shareable ? "true" : "false");
+	return import;
+}
+
+Import * findImport(ImportCache * importCache, const char * path) {
+	if (importCache == NULL) {
+		return NULL;
+	}
+	free(importCache->pendingIdentity.canonicalPath);
+	importCache->pendingIdentity = (ImportIdentity) { 0 };
+	struct stat status;
+	if (stat(path, &status) != 0) {
+		// The lexical-analyzer reports that the file cannot be opened:
+		return NULL;
+	}
+	ImportIdentity identity = {
+		.canonicalPath = realpath(path, NULL),
+		.device = status.st_dev,
+		.inode = status.st_ino,
+		.modification = status.st_mtim
+	};
+	const size_t bucket = _hashIdentity(&identity) % importCache->bucketCount;
+	for (ImportCacheEntry * entry = importCache->buckets[bucket]; entry != NULL; entry = entry->next) {
+		if (_isSameIdentity(&entry->identity, &identity)) {
+			LOG_DEBUGGING(_logger, "Import found in cache: \"%s\".", identity.canonicalPath);
+			free(identity.canonicalPath);
+			return entry->import;
+		}
+	}
+	importCache->pendingIdentity = identity;
+	return NULL;
+}
+
+bool recordImport(ImportCache * importCache, Import * import) {
+	if (importCache == NULL || importCache->recordingCount == 0) {
+		return false;
+	}
+	Import * enclosingImport = importCache->recordings[importCache->recordingCount - 1]->import;
+	if (import->shareable) {
+		ImportedToken token = {
+			.import = import,
+			.label = IMPORT
+		};
+		_appendToken(enclosingImport, token);
+	}
+	else {
+		for (uint32_t k = 0; k < import->tokenCount; ++k) {
+			_appendToken(enclosingImport, import->tokens[k]);
+		}
+	}
+	return true;
+}
+
+bool recordImportedToken(ImportCache * importCache, const TokenLabel label, const int integer) {
+	if (importCache == NULL || importCache->recordingCount == 0) {
+		return false;
+	}
+	ImportedToken token = {
+		.integer = integer,
+		.label = label
+	};
+	_appendToken(importCache->recordings[importCache->recordingCount - 1]->import, token);
+	return true;
+}
@@ -0,0 +1,100 @@
+#ifndef IMPORT_CACHE_HEADER
+#define IMPORT_CACHE_HEADER
+
+#include "../../support/logging/Logger.h"
+#include "../../support/type/ModuleDestructor.h"
+#include "../../support/type/TokenLabel.h"
+#include "../syntactic-analysis/AbstractSyntaxTree.h"
+#include "../syntactic-analysis/BisonParser.h"
+#include <limits.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <time.h>
+
+/** Initialize module's internal state. */
+ModuleDestructor initializeImportCacheModule();
+
+/**
+ * The identity of an imported file: its canonical path (absolute, and without
+ * symbolic links), along with its inode and the time of its last modification,
+ * so a file replaced or modified during the compilation is lexed again.
+ */
+typedef struct {
+	char * canonicalPath;
+	dev_t device;
+	ino_t inode;
+	struct timespec modification;
+} ImportIdentity;
+
+typedef struct ImportCacheEntry ImportCacheEntry;
+
+struct ImportCacheEntry {
+	ImportIdentity identity;
+	Import * import;
+	ImportCacheEntry * next;
+};
+
+/**
+ * The imports of a single compilation, in a hash table by identity (with
+ * separate chaining), and the stack of the files being lexed. While a file is
+ * lexed, its tokens are recorded in its import instead of being parsed; the
+ * import is replayed into the parser (or into the enclosing import) once the
+ * file ends.
+ */
+typedef struct {
+	ImportCacheEntry ** buckets;
+	size_t bucketCount;
+	size_t entryCount;
+	ImportIdentity pendingIdentity;
+	ImportCacheEntry ** recordings;
+	size_t recordingCapacity;
+	size_t recordingCount;
+} ImportCache;
+
+/**
+ * Starts recording the tokens of the file found by the last "findImport",
+ * which is about to be lexed.
+ */
+void beginImport(ImportCache * importCache);
+
+/**
+ * Creates a new empty cache.
+ */
+ImportCache * createImportCache();
+
+/**
+ * Destroys a cache, and all of its imports.
+ */
+void destroyImportCache(ImportCache * importCache);
+
+/**
+ * Stops recording the tokens of the innermost file being lexed, and stores
+ * its import in the cache. Returns the import, or NULL if the cache is NULL.
+ */
+Import * endImport(ImportCache * importCache);
+
+/**
+ * Returns the import of the file in the specified path, if it was already
+ * lexed in this compilation and it didn't change since then. Otherwise,
+ * returns NULL, and remembers the identity of the file for "beginImport".
+ */
+Import * findImport(ImportCache * importCache, const char * path);
+
+/**
+ * Appends an entire import to the innermost file being lexed. Returns false
+ * if there is no such file (or no cache), so the import must be parsed.
+ */
+bool recordImport(ImportCache * importCache, Import * import);
+
+/**
+ * Appends a token to the innermost file being lexed. Returns false if there
+ * is no such file (or no cache), so the token must be parsed.
+ */
+bool recordImportedToken(ImportCache * importCache, const TokenLabel label, const int integer);
+
+#endif
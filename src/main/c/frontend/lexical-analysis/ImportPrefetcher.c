@@ -0,0 +1,182 @@
+#include "ImportPrefetcher.h"
+
+/* MODULE INTERNAL STATE */
+
+static const size_t _chunkSizeInBytes = 1 << 16;
+static Logger * _logger = NULL;
+
+/**
+ * A file to read ahead of the lexical-analyzer, and to scan for imports.
+ */
+typedef struct {
+	ImportPrefetcher * importPrefetcher;
+	char * path;
+} PrefetchTask;
+
+/** Shutdown module's internal state. */
+void _shutdownImportPrefetcherModule() {
+	if (_logger != NULL) {
+		LOG_DEBUGGING(_logger, "Destroying module: ImportPrefetcher...");
+		destroyLogger(_logger);
+		_logger = NULL;
+	}
+}
+
+ModuleDestructor initializeImportPrefetcherModule() {
+	_logger = createLogger("ImportPrefetcher");
+	return _shutdownImportPrefetcherModule;
+}
+
+/* PRIVATE FUNCTIONS */
+
+static void _adviseWillNeed(const char * path);
+static void _cancel(ImportPrefetcher * importPrefetcher);
+static bool _isCancelled(ImportPrefetcher * importPrefetcher);
+static void _prefetch(void * argument);
+static void _submit(ImportPrefetcher * importPrefetcher, const char * path, const bool advise);
+static void _submitAdvised(void * argument, const char * path);
+static void _submitUnadvised(void * argument, const char * path);
+
+/**
+ * Requests the system to read an entire file into the page cache, without
+ * waiting for it.
+ */
+static void _adviseWillNeed(const char * path) {
+	const int fileDescriptor = open(path, O_RDONLY);
+	if (0 <= fileDescriptor) {
+		posix_fadvise(fileDescriptor, 0, 0, POSIX_FADV_WILLNEED);
+		close(fileDescriptor);
+	}
+}
+
+/**
+ * Cancels every prefetch submitted so far, and waits until the thread drops
+ * them. The prefetcher accepts new submissions afterwards.
+ */
+static void _cancel(ImportPrefetcher * importPrefetcher) {
+	if (importPrefetcher->threadPool != NULL) {
+		__atomic_store_n(&importPrefetcher->cancelled, true, __ATOMIC_RELEASE);
+		waitForThreadPool(importPrefetcher->threadPool);
+		__atomic_store_n(&importPrefetcher->cancelled, false, __ATOMIC_RELEASE);
+	}
+}
+
+/**
+ * Whether the prefetches submitted so far were cancelled.
+ */
+static bool _isCancelled(ImportPrefetcher * importPrefetcher) {
+	return __atomic_load_n(&importPrefetcher->cancelled, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * The task of the background thread: reads a file, which brings it to the
+ * page cache, and submits every import found inside. A cancelled task is
+ * dropped without reading its file.
+ */
+static void _prefetch(void * argument) {
+	PrefetchTask * prefetchTask = argument;
+	const int fileDescriptor = _isCancelled(prefetchTask->importPrefetcher) ? -1 : open(prefetchTask->path, O_RDONLY);
+	if (fileDescriptor < 0) {
+		// The lexical-analyzer reports that the file cannot be opened (if it
+		// wasn't cancelled):
+		free(prefetchTask->path);
+		free(prefetchTask);
+		return;
+	}
+	LOG_DEBUGGING(_logger, "Prefetching \"%s\"...", prefetchTask->path);
+	posix_fadvise(fileDescriptor, 0, 0, POSIX_FADV_SEQUENTIAL);
+	char * chunk = malloc(_chunkSizeInBytes);
+	ImportScanner importScanner = { 0 };
+	ssize_t length = 0;
+	while (!_isCancelled(prefetchTask->importPrefetcher) && 0 < (length = read(fileDescriptor, chunk, _chunkSizeInBytes))) {
+		scanImports(&importScanner, chunk, length, _submitAdvised, prefetchTask->importPrefetcher);
+	}
+	close(fileDescriptor);
+	free(chunk);
+	free(prefetchTask->path);
+	free(prefetchTask);
+}
+
+/**
+ * Submits a path to the background thread (and starts it, the first time),
+ * unless it was already prefetched. With advice, the read of the file is
+ * requested to the system right away, so the reads of all the imports of a
+ * file are in flight at the same time.
+ */
+static void _submit(ImportPrefetcher * importPrefetcher, const char * path, const bool advise) {
+	if (_isCancelled(importPrefetcher)) {
+		return;
+	}
+	pthread_mutex_lock(&importPrefetcher->mutex);
+	const bool seen = !addToStringSet(importPrefetcher->seenPaths, path);
+	if (!seen && importPrefetcher->threadPool == NULL) {
+		importPrefetcher->threadPool = createThreadPool(1);
+	}
+	pthread_mutex_unlock(&importPrefetcher->mutex);
+	if (seen) {
+		return;
+	}
+	if (advise) {
+		_adviseWillNeed(path);
+	}
+	PrefetchTask * prefetchTask = calloc(1, sizeof(PrefetchTask));
+	prefetchTask->importPrefetcher = importPrefetcher;
+	prefetchTask->path = strdup(path);
+	submitToThreadPool(importPrefetcher->threadPool, _prefetch, prefetchTask);
+}
+
+/**
+ * Submits an import found by the background thread, with advice.
+ */
+static void _submitAdvised(void * argument, const char * path) {
+	_submit(argument, path, true);
+}
+
+/**
+ * Submits an import found by the lexical-analyzer, without advice (the thread
+ * reads them in the order the lexical-analyzer opens them).
+ */
+static void _submitUnadvised(void * argument, const char * path) {
+	_submit(argument, path, false);
+}
+
+/* PUBLIC FUNCTIONS */
+
+ImportPrefetcher * createImportPrefetcher() {
+	ImportPrefetcher * importPrefetcher = calloc(1, sizeof(ImportPrefetcher));
+	importPrefetcher->cancelled = false;
+	pthread_mutex_init(&importPrefetcher->mutex, NULL);
+	importPrefetcher->seenPaths = createStringSet();
+	importPrefetcher->threadPool = NULL;
+	return importPrefetcher;
+}
+
+void destroyImportPrefetcher(ImportPrefetcher * importPrefetcher) {
+	if (importPrefetcher != NULL) {
+		// The pool only stops once its queue is empty:
+		__atomic_store_n(&importPrefetcher->cancelled, true, __ATOMIC_RELEASE);
+		destroyThreadPool(importPrefetcher->threadPool);
+		destroyStringSet(importPrefetcher->seenPaths);
+		pthread_mutex_destroy(&importPrefetcher->mutex);
+		free(importPrefetcher);
+	}
+}
+
+void prefetchImports(ImportPrefetcher * importPrefetcher, const char * path, const char * lookahead, const size_t length) {
+	if (importPrefetcher != NULL) {
+		pthread_mutex_lock(&importPrefetcher->mutex);
+		addToStringSet(importPrefetcher->seenPaths, path);
+		pthread_mutex_unlock(&importPrefetcher->mutex);
+		ImportScanner importScanner = { 0 };
+		scanImports(&importScanner, lookahead, length, _submitUnadvised, importPrefetcher);
+	}
+}
+
+void resetImportPrefetcher(ImportPrefetcher * importPrefetcher) {
+	if (importPrefetcher != NULL) {
+		_cancel(importPrefetcher);
+		pthread_mutex_lock(&importPrefetcher->mutex);
+		clearStringSet(importPrefetcher->seenPaths);
+		pthread_mutex_unlock(&importPrefetcher->mutex);
+	}
+}
@@ -0,0 +1,69 @@
+#ifndef IMPORT_PREFETCHER_HEADER
+#define IMPORT_PREFETCHER_HEADER
+
+#include "../../support/concurrency/ThreadPool.h"
+#include "../../support/language/StringSet.h"
+#include "../../support/logging/Logger.h"
+#include "../../support/type/ModuleDestructor.h"
+#include "ImportScanner.h"
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/** Initialize module's internal state. */
+ModuleDestructor initializeImportPrefetcherModule();
+
+/**
+ * Reads the imported files ahead of the lexical-analyzer, in a background
+ * thread. Once the lexical-analyzer finds an import, the text that follows it
+ * (as much as the scanner already read) is scanned for the next imports, and
+ * the thread reads those files, in order, and scans them for their own
+ * imports, whose reads are requested to the system at once (see
+ * "posix_fadvise"), before scanning them in turn. So, by the time the
+ * lexical-analyzer opens the next import, its content is usually in the page
+ * cache already.
+ *
+ * Every path is prefetched once per compilation (see "resetImportPrefetcher"),
+ * so a cycle of imports doesn't keep the thread busy. The thread starts with
+ * the first import, so a program without imports never creates it. Once
+ * cancelled, the pending prefetches are dropped, the one in flight stops
+ * after its current chunk, and nothing else is submitted.
+ */
+typedef struct {
+	bool cancelled;
+	pthread_mutex_t mutex;
+	StringSet * seenPaths;
+	ThreadPool * threadPool;
+} ImportPrefetcher;
+
+/**
+ * Creates a new prefetcher, without its thread.
+ */
+ImportPrefetcher * createImportPrefetcher();
+
+/**
+ * Cancels the pending prefetches, stops the thread, and destroys the
+ * prefetcher.
+ */
+void destroyImportPrefetcher(ImportPrefetcher * importPrefetcher);
+
+/**
+ * Prefetches the files imported in a text that the lexical-analyzer will scan
+ * next and, recursively, their own imports. The file in the path is the one
+ * the lexical-analyzer opens now, so it's never read in the background. It
+ * returns once the text is scanned. A NULL prefetcher does nothing.
+ */
+void prefetchImports(ImportPrefetcher * importPrefetcher, const char * path, const char * lookahead, const size_t length);
+
+/**
+ * Cancels the prefetches of the last compilation (and waits for the one in
+ * flight), and forgets the paths already prefetched, before a new one.
+ */
+void resetImportPrefetcher(ImportPrefetcher * importPrefetcher);
+
+#endif
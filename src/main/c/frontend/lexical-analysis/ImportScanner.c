@@ -0,0 +1,46 @@
+#include "ImportScanner.h"
+
+/* PUBLIC FUNCTIONS */
+
+void scanImports(ImportScanner * importScanner, const char * chunk, const size_t length, ImportPathConsumer consumer, void * argument) {
+	for (size_t k = 0; k < length; ++k) {
+		const char character = chunk[k];
+		switch (importScanner->state) {
+			case CODE_SCAN_STATE:
+				if (character == '{') {
+					importScanner->pathLength = 0;
+					importScanner->state = IMPORT_SCAN_STATE;
+				}
+				else if (importScanner->previous == '/' && character == '*') {
+					// The asterisk cannot close the comment it opens:
+					importScanner->previous = '\0';
+					importScanner->state = COMMENT_SCAN_STATE;
+					continue;
+				}
+				break;
+			case COMMENT_SCAN_STATE:
+				if (importScanner->previous == '*' && character == '/') {
+					importScanner->previous = '\0';
+					importScanner->state = CODE_SCAN_STATE;
+					continue;
+				}
+				break;
+			case IMPORT_SCAN_STATE:
+				if (character == '}') {
+					if (0 < importScanner->pathLength && importScanner->pathLength < PATH_MAX) {
+						importScanner->path[importScanner->pathLength] = '\0';
+						consumer(argument, importScanner->path);
+					}
+					importScanner->state = CODE_SCAN_STATE;
+				}
+				else if (character == '{') {
+					importScanner->state = CODE_SCAN_STATE;
+				}
+				else if (importScanner->pathLength < PATH_MAX) {
+					importScanner->path[importScanner->pathLength++] = character;
+				}
+				break;
+		}
+		importScanner->previous = character;
+	}
+}
@@ -0,0 +1,44 @@
+#ifndef IMPORT_SCANNER_HEADER
+#define IMPORT_SCANNER_HEADER
+
+#include <limits.h>
+#include <stddef.h>
+
+/**
+ * Finds the import paths of a program without lexing it, following the
+ * contexts of "FlexPatterns.l": a path is the text between braces, and the
+ * imports inside a comment are ignored. The program is fed in chunks, so a
+ * file can be scanned while it's read.
+ */
+
+/**
+ * Receives every import path found, null-terminated. The path is only valid
+ * during the call.
+ */
+typedef void (* ImportPathConsumer)(void * argument, const char * path);
+
+typedef enum {
+	CODE_SCAN_STATE = 0,
+	COMMENT_SCAN_STATE,
+	IMPORT_SCAN_STATE
+} ImportScanState;
+
+/**
+ * The state of a scanning between chunks. A zeroed scanner is ready to scan
+ * a new program.
+ */
+typedef struct {
+	char path[PATH_MAX];
+	size_t pathLength;
+	char previous;
+	ImportScanState state;
+} ImportScanner;
+
+/**
+ * Scans the next chunk of a program. An import path longer than PATH_MAX
+ * cannot be opened, so it's skipped; an import with a nested brace is
+ * rejected by the lexical-analyzer, so it's skipped too.
+ */
+void scanImports(ImportScanner * importScanner, const char * chunk, const size_t length, ImportPathConsumer consumer, void * argument);
+
+#endif
@@ -7,7 +7,7 @@ static Logger * _logger = NULL;
 /** Shutdown module's internal state. */
 void _shutdownAbstractSyntaxTreeModule() {
 	if (_logger != NULL) {
-		logDebugging(_logger, "Destroying module: AbstractSyntaxTree...");
+		LOG_DEBUGGING(_logger, "Destroying module: AbstractSyntaxTree...");
 		destroyLogger(_logger);
 		_logger = NULL;
 	}
@@ -18,53 +18,66 @@ ModuleDestructor initializeAbstractSyntaxTreeModule() {
 	return _shutdownAbstractSyntaxTreeModule;
 }
 
-/* PUBLIC FUNCTIONS */
+/* PRIVATE FUNCTIONS */
 
-void destroyConstant(Constant * constant) {
-	logDebugging(_logger, "Executing destructor: %s", __FUNCTION__);
-	if (constant != NULL) {
-		free(constant);
-	}
-}
+/**
+ * A pending expression of the depth measurement, and its depth.
+ */
+typedef struct {
+	const Expression * expression;
+	size_t depth;
+} DepthStep;
+
+static size_t _measureDepth(const Expression * root);
 
-void destroyExpression(Expression * expression) {
-	logDebugging(_logger, "Executing destructor: %s", __FUNCTION__);
-	if (expression != NULL) {
-		switch (expression->type) {
-			case ADDITION:
-			case DIVISION:
-			case MULTIPLICATION:
-			case SUBTRACTION:
-				destroyExpression(expression->leftExpression);
-				destroyExpression(expression->rightExpression);
-				break;
-			case FACTOR:
-				destroyFactor(expression->factor);
-				break;
+/**
+ * Measures the depth of a subtree. The depth of a shared import is measured
+ * once, and then added to the depth of every one of its occurrences, so a
+ * subtree imported many times isn't walked again.
+ */
+static size_t _measureDepth(const Expression * root) {
+	size_t capacity = 64;
+	size_t count = 0;
+	size_t maximumDepth = 0;
+	DepthStep * steps = malloc(capacity * sizeof(DepthStep));
+	steps[count++] = (DepthStep) { .expression = root, .depth = 0 };
+	while (0 < count) {
+		const DepthStep step = steps[--count];
+		if (capacity < count + 2) {
+			capacity *= 2;
+			steps = realloc(steps, capacity * sizeof(DepthStep));
+		}
+		const Expression * expression = step.expression;
+		if (expression->type != FACTOR) {
+			steps[count++] = (DepthStep) { .expression = expression->leftExpression, .depth = step.depth + 1 };
+			steps[count++] = (DepthStep) { .expression = expression->rightExpression, .depth = step.depth + 1 };
+		}
+		else if (expression->factor->type == EXPRESSION) {
+			steps[count++] = (DepthStep) { .expression = expression->factor->expression, .depth = step.depth + 1 };
+		}
+		else if (expression->factor->type == IMPORTED_EXPRESSION) {
+			Import * import = expression->factor->import;
+			if (import->depth == 0) {
+				import->depth = _measureDepth(import->expression);
+			}
+			if (maximumDepth < step.depth + 1 + import->depth) {
+				maximumDepth = step.depth + 1 + import->depth;
+			}
+		}
+		else if (maximumDepth < step.depth + 1) {
+			maximumDepth = step.depth + 1;
 		}
-		free(expression);
 	}
+	free(steps);
+	return maximumDepth;
 }
 
-void destroyFactor(Factor * factor) {
-	logDebugging(_logger, "Executing destructor: %s", __FUNCTION__);
-	if (factor != NULL) {
-		switch (factor->type) {
-			case CONSTANT:
-				destroyConstant(factor->constant);
-				break;
-			case EXPRESSION:
-				destroyExpression(factor->expression);
-				break;
-		}
-		free(factor);
-	}
+/* PUBLIC FUNCTIONS */
+
+Expression * innerExpression(const Factor * factor) {
+	return factor->type == IMPORTED_EXPRESSION ? factor->import->expression : factor->expression;
 }
 
-void destroyProgram(Program * program) {
-	logDebugging(_logger, "Executing destructor: %s", __FUNCTION__);
-	if (program != NULL) {
-		destroyExpression(program->expression);
-		free(program);
-	}
+size_t measureAbstractSyntaxTreeDepth(const Program * program) {
+	return _measureDepth(program->expression);
 }
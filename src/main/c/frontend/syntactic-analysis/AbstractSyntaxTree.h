@@ -3,6 +3,9 @@
 
 #include "../../support/logging/Logger.h"
 #include "../../support/type/ModuleDestructor.h"
+#include "../../support/type/TokenLabel.h"
+#include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
 
 /** Initialize module's internal state. */
@@ -20,6 +23,7 @@ typedef enum FactorType FactorType;
 typedef struct Constant Constant;
 typedef struct Expression Expression;
 typedef struct Factor Factor;
+typedef struct Import Import;
 typedef struct Program Program;
 
 /**
@@ -36,7 +40,8 @@ enum ExpressionType {
 
 enum FactorType {
 	CONSTANT,
-	EXPRESSION
+	EXPRESSION,
+	IMPORTED_EXPRESSION
 };
 
 struct Constant {
@@ -47,6 +52,7 @@ struct Factor {
 	union {
 		Constant * constant;
 		Expression * expression;
+		Import * import;
 	};
 	FactorType type;
 };
@@ -60,6 +66,13 @@ struct Expression {
 		};
 	};
 	ExpressionType type;
+
+	/**
+	 * The amount of nodes in the subtree rooted at this expression (inclusive),
+	 * counted as in the flat layout: a factor and its constant are a single
+	 * node, and a parenthesized expression adds one node to its inner one.
+	 */
+	uint32_t size;
 };
 
 struct Program {
@@ -67,12 +80,79 @@ struct Program {
 };
 
 /**
- * Node recursive super-duper-trambolik-destructors.
+ * A token of an imported file, as the lexical-analyzer found it: either an
+ * integer, or another import nested in the file.
+ */
+typedef struct {
+	union {
+		int integer;
+		Import * import;
+	};
+	TokenLabel label;
+} ImportedToken;
+
+/**
+ * A file imported with "{path}", lexed once per compilation (see
+ * "ImportCache.h"). Every import of the same file replays its tokens. If the
+ * file is a single parenthesized expression, it's also parsed only once: the
+ * first import builds the subtree (or the flat nodes), and the others share it
+ * as an imported factor, whose successful value is computed once too.
+ */
+struct Import {
+	/**
+	 * Whether the tokens are a single parenthesized expression, so the file
+	 * can be spliced as a factor without changing the meaning of the program.
+	 */
+	bool shareable;
+
+	/**
+	 * The shared subtree, once parsed: the inner expression of the
+	 * parentheses with the pointer layout, or the index of the parenthesis
+	 * node with the flat one.
+	 */
+	Expression * expression;
+	uint32_t node;
+	bool parsed;
+
+	/**
+	 * Whether the rebalancer already rewrote the shared subtree, so it's only
+	 * rewritten once, however many imports share it.
+	 */
+	bool rebalanced;
+
+	/**
+	 * The depth of the shared subtree, once measured (or 0).
+	 */
+	size_t depth;
+
+	/**
+	 * The value of the shared subtree, once it's successfully computed. It's
+	 * accessed atomically, because the parallel engine can compute the same
+	 * import in many threads.
+	 */
+	bool memoized;
+	int value;
+
+	ImportedToken * tokens;
+	uint32_t tokenCapacity;
+	uint32_t tokenCount;
+};
+
+/**
+ * Returns the inner expression of a parenthesized or an imported factor.
  */
+Expression * innerExpression(const Factor * factor);
 
-void destroyConstant(Constant * constant);
-void destroyExpression(Expression * expression);
-void destroyFactor(Factor * factor);
-void destroyProgram(Program * program);
+/**
+ * Measures the depth of the tree without recursion. The wrapper expressions
+ * of factors don't count, so it matches the depth of the same program in the
+ * flat layout (see "measureFlatSyntaxTreeDepth").
+ */
+size_t measureAbstractSyntaxTreeDepth(const Program * program);
+
+/**
+ * There are no node destructors: every node lives in the arena of the
+ * compiler state (see "CompilerState.h"), which drops the entire tree at once.
+ */
 
 #endif
@@ -2,21 +2,18 @@
 
 /* MODULE INTERNAL STATE */
 
-static CompilerState * _compilerState = NULL;
 static Logger * _logger = NULL;
 
 /** Shutdown module's internal state. */
 void _shutdownBisonActionsModule() {
 	if (_logger != NULL) {
-		logDebugging(_logger, "Destroying module: BisonActions...");
+		LOG_DEBUGGING(_logger, "Destroying module: BisonActions...");
 		destroyLogger(_logger);
 		_logger = NULL;
 	}
-	_compilerState = NULL;
 }
 
-ModuleDestructor initializeBisonActionsModule(CompilerState * compilerState) {
-	_compilerState = compilerState;
+ModuleDestructor initializeBisonActionsModule() {
 	_logger = createLogger("BisonActions");
 	return _shutdownBisonActionsModule;
 }
@@ -25,61 +22,310 @@ ModuleDestructor initializeBisonActionsModule(CompilerState * compilerState) {
 
 /* PRIVATE FUNCTIONS */
 
+static void * _buildNode(CompilerState * compilerState, const InternedNodeType type, const void * prototype, const size_t sizeInBytes);
+static void _copyFlatSubtree(CompilerState * compilerState, const NodeIndex root);
+static FlatNodeType _expressionTypeToFlatNodeType(const ExpressionType type);
 static void _logSyntacticAnalyzerAction(const char * functionName);
+static void _parseImport(CompilerState * compilerState, Import * import);
+
+/**
+ * Returns the node equal to a prototype, and builds it in the arena only if
+ * there isn't one interned yet (or if there is no interner at all).
+ */
+static void * _buildNode(CompilerState * compilerState, const InternedNodeType type, const void * prototype, const size_t sizeInBytes) {
+	void * node = findInternedNode(compilerState->nodeInterner, type, prototype);
+	if (node == NULL) {
+		node = allocateInArena(compilerState->arena, sizeInBytes);
+		memcpy(node, prototype, sizeInBytes);
+		internNode(compilerState->nodeInterner, type, node);
+	}
+	return node;
+}
+
+/**
+ * Appends a copy of the subtree of a flat table rooted at the specified node,
+ * as the parser would have appended it again. The subtree is a contiguous
+ * range, so its copy only shifts the indices of the children. The room for the
+ * copy is checked first: the files that import the same file twice, in a
+ * chain, double the table at each level, so it overflows (and the parsing
+ * fails) before copying anything.
+ */
+static void _copyFlatSubtree(CompilerState * compilerState, const NodeIndex root) {
+	FlatSyntaxTree * flatSyntaxTree = compilerState->flatSyntaxTree;
+	const NodeIndex size = flatSyntaxTree->nodes[root].size;
+	if (!reserveFlatNodes(flatSyntaxTree, size)) {
+		return;
+	}
+	const NodeIndex first = 1 + root - size;
+	const NodeIndex offset = flatSyntaxTree->count - first;
+	for (NodeIndex k = first; k <= root; ++k) {
+		FlatNode node = flatSyntaxTree->nodes[k];
+		switch (node.type) {
+			case CONSTANT_NODE:
+				break;
+			case PARENTHESIS_NODE:
+				node.expression += offset;
+				break;
+			default:
+				node.leftExpression += offset;
+				node.rightExpression += offset;
+				break;
+		}
+		appendFlatNode(flatSyntaxTree, node);
+	}
+	compilerState->metrics.nodes += size;
+}
+
+/**
+ * Converts an arithmetic expression type to the type of its flat node.
+ */
+static FlatNodeType _expressionTypeToFlatNodeType(const ExpressionType type) {
+	switch (type) {
+		case ADDITION: return ADDITION_NODE;
+		case DIVISION: return DIVISION_NODE;
+		case MULTIPLICATION: return MULTIPLICATION_NODE;
+		default: return SUBTRACTION_NODE;
+	}
+}
 
 /**
  * Logs a syntactic-analyzer action in DEBUGGING level.
  */
 static void _logSyntacticAnalyzerAction(const char * functionName) {
-	logDebugging(_logger, "%s", functionName);
+	LOG_DEBUGGING(_logger, "%s", functionName);
+}
+
+/**
+ * Parses the tokens of a shareable import with a parser of its own, that
+ * shares the compiler state, so the nodes are built as if the main parser
+ * reduced them (in the same arena, table or folder). The root of the program
+ * set by the nested parser is restored afterwards. The tokens were validated
+ * when the file was lexed, so the parser always accepts them.
+ */
+static void _parseImport(CompilerState * compilerState, Import * import) {
+	void * abstractSyntaxTree = compilerState->abstractSyntaxtTree;
+	FlatSyntaxTree * flatSyntaxTree = compilerState->flatSyntaxTree;
+	const NodeIndex root = flatSyntaxTree == NULL ? 0 : flatSyntaxTree->root;
+	yypstate * parser = yypstate_new();
+	YYLTYPE location = { 0 };
+	SemanticValue semanticValue;
+	for (uint32_t k = 0; k <= import->tokenCount; ++k) {
+		memset(&semanticValue, 0, sizeof(SemanticValue));
+		TokenLabel label = YYEOF;
+		if (k < import->tokenCount) {
+			const ImportedToken * token = &import->tokens[k];
+			label = token->label;
+			if (label == IMPORT) {
+				semanticValue.import = token->import;
+			}
+			else {
+				semanticValue.integer = token->integer;
+			}
+		}
+		yypush_parse(parser, label, &semanticValue, &location, compilerState);
+	}
+	yypstate_delete(parser);
+	if (flatSyntaxTree != NULL) {
+		import->node = flatSyntaxTree->count - 1;
+		flatSyntaxTree->root = root;
+	}
+	else if (compilerState->constantFolder == NULL) {
+		Program * program = compilerState->abstractSyntaxtTree;
+		import->expression = program->expression->factor->expression;
+		compilerState->abstractSyntaxtTree = abstractSyntaxTree;
+	}
+	import->parsed = true;
 }
 
 /* PUBLIC FUNCTIONS */
 
-Constant * IntegerConstantSemanticAction(const int value) {
+/**
+ * Every action receives the state of its own compilation (the "%parse-param"
+ * of the grammar), so many parsers can run at the same time. When the compiler
+ * state carries a constant folder, the following actions
+ * fold the value of the program in it, and return NULL. When it carries a flat
+ * table, they append nodes to it instead, and return NULL too: Bison reduces
+ * in post-order, so the children of every new node are found at the end of
+ * the table, unless it overflowed: then they do nothing else, and the
+ * lexical-analyzer fails the compilation (see "Frontend.c"). Otherwise, if it carries a node interner, the nodes of the
+ * pointer-based AST are only built if there isn't an equal one already.
+ *
+ * The metrics count the logical nodes of the AST in every layout, as the flat
+ * one stores them: a constant, an arithmetic operator and a parenthesized (or
+ * imported) expression are a node each, whatever the amount of structures
+ * (or the sharing) the pointer-based layout uses for them.
+ */
+
+Constant * IntegerConstantSemanticAction(CompilerState * compilerState, const int value) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	Constant * constant = calloc(1, sizeof(Constant));
-	constant->value = value;
-	return constant;
+	if (compilerState->constantFolder != NULL) {
+		foldConstant(compilerState->constantFolder, value);
+		return NULL;
+	}
+	FlatSyntaxTree * flatSyntaxTree = compilerState->flatSyntaxTree;
+	if (flatSyntaxTree != NULL) {
+		FlatNode node = {
+			.value = value,
+			.type = CONSTANT_NODE,
+			.size = 1
+		};
+		appendFlatNode(flatSyntaxTree, node);
+		++compilerState->metrics.nodes;
+		return NULL;
+	}
+	++compilerState->metrics.nodes;
+	const Constant prototype = {
+		.value = value
+	};
+	return _buildNode(compilerState, INTERNED_CONSTANT, &prototype, sizeof(Constant));
 }
 
-Expression * ArithmeticExpressionSemanticAction(Expression * leftExpression, Expression * rightExpression, ExpressionType type) {
+Expression * ArithmeticExpressionSemanticAction(CompilerState * compilerState, Expression * leftExpression, Expression * rightExpression, ExpressionType type) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	Expression * expression = calloc(1, sizeof(Expression));
-	expression->leftExpression = leftExpression;
-	expression->rightExpression = rightExpression;
-	expression->type = type;
-	return expression;
+	if (compilerState->constantFolder != NULL) {
+		foldArithmeticExpression(compilerState->constantFolder, type);
+		return NULL;
+	}
+	FlatSyntaxTree * flatSyntaxTree = compilerState->flatSyntaxTree;
+	if (flatSyntaxTree != NULL) {
+		if (flatSyntaxTree->overflowed) {
+			return NULL;
+		}
+		const NodeIndex right = flatSyntaxTree->count - 1;
+		const NodeIndex left = right - flatSyntaxTree->nodes[right].size;
+		FlatNode node = {
+			.leftExpression = left,
+			.rightExpression = right,
+			.type = _expressionTypeToFlatNodeType(type),
+			.size = 1 + flatSyntaxTree->nodes[left].size + flatSyntaxTree->nodes[right].size
+		};
+		appendFlatNode(flatSyntaxTree, node);
+		++compilerState->metrics.nodes;
+		return NULL;
+	}
+	++compilerState->metrics.nodes;
+	const Expression prototype = {
+		.leftExpression = leftExpression,
+		.rightExpression = rightExpression,
+		.type = type,
+		.size = 1 + leftExpression->size + rightExpression->size
+	};
+	return _buildNode(compilerState, INTERNED_EXPRESSION, &prototype, sizeof(Expression));
+}
+
+Expression * FactorExpressionSemanticAction(CompilerState * compilerState, Factor * factor) {
+	_logSyntacticAnalyzerAction(__FUNCTION__);
+	if (compilerState->constantFolder != NULL || compilerState->flatSyntaxTree != NULL) {
+		return NULL;
+	}
+	const Expression prototype = {
+		.factor = factor,
+		.type = FACTOR,
+		.size = factor->type == CONSTANT ? 1 : 1 + innerExpression(factor)->size
+	};
+	return _buildNode(compilerState, INTERNED_EXPRESSION, &prototype, sizeof(Expression));
 }
 
-Expression * FactorExpressionSemanticAction(Factor * factor) {
+Factor * ConstantFactorSemanticAction(CompilerState * compilerState, Constant * constant) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	Expression * expression = calloc(1, sizeof(Expression));
-	expression->factor = factor;
-	expression->type = FACTOR;
-	return expression;
+	if (compilerState->constantFolder != NULL || compilerState->flatSyntaxTree != NULL) {
+		return NULL;
+	}
+	const Factor prototype = {
+		.constant = constant,
+		.type = CONSTANT
+	};
+	return _buildNode(compilerState, INTERNED_FACTOR, &prototype, sizeof(Factor));
 }
 
-Factor * ConstantFactorSemanticAction(Constant * constant) {
+Factor * ExpressionFactorSemanticAction(CompilerState * compilerState, Expression * expression) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	Factor * factor = calloc(1, sizeof(Factor));
-	factor->constant = constant;
-	factor->type = CONSTANT;
-	return factor;
+	if (compilerState->constantFolder != NULL) {
+		return NULL;
+	}
+	FlatSyntaxTree * flatSyntaxTree = compilerState->flatSyntaxTree;
+	if (flatSyntaxTree != NULL) {
+		if (flatSyntaxTree->overflowed) {
+			return NULL;
+		}
+		const NodeIndex child = flatSyntaxTree->count - 1;
+		FlatNode node = {
+			.expression = child,
+			.type = PARENTHESIS_NODE,
+			.size = 1 + flatSyntaxTree->nodes[child].size
+		};
+		appendFlatNode(flatSyntaxTree, node);
+		++compilerState->metrics.nodes;
+		return NULL;
+	}
+	++compilerState->metrics.nodes;
+	const Factor prototype = {
+		.expression = expression,
+		.type = EXPRESSION
+	};
+	return _buildNode(compilerState, INTERNED_FACTOR, &prototype, sizeof(Factor));
 }
 
-Factor * ExpressionFactorSemanticAction(Expression * expression) {
+/**
+ * The first import of a shareable file parses it. Later, with the pointer
+ * layout, every import shares the same subtree; with the flat layout, the
+ * nodes are copied instead; and with a constant folder, the value is folded
+ * again only if it didn't succeed before (so the errors are still logged).
+ */
+Factor * ImportFactorSemanticAction(CompilerState * compilerState, Import * import) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	Factor * factor = calloc(1, sizeof(Factor));
-	factor->expression = expression;
-	factor->type = EXPRESSION;
-	return factor;
+	ConstantFolder * constantFolder = compilerState->constantFolder;
+	if (constantFolder != NULL) {
+		if (import->memoized) {
+			foldConstant(constantFolder, import->value);
+		}
+		else {
+			_parseImport(compilerState, import);
+			const ComputationResult computationResult = peekConstantFolder(constantFolder);
+			import->memoized = computationResult.succeeded;
+			import->value = computationResult.value;
+		}
+		return NULL;
+	}
+	FlatSyntaxTree * flatSyntaxTree = compilerState->flatSyntaxTree;
+	if (flatSyntaxTree != NULL) {
+		if (flatSyntaxTree->overflowed) {
+			return NULL;
+		}
+		if (import->parsed) {
+			_copyFlatSubtree(compilerState, import->node);
+		}
+		else {
+			_parseImport(compilerState, import);
+		}
+		return NULL;
+	}
+	if (import->parsed) {
+		// Counted as the copy of the flat layout, although it's shared:
+		compilerState->metrics.nodes += 1 + import->expression->size;
+	}
+	else {
+		_parseImport(compilerState, import);
+	}
+	const Factor prototype = {
+		.import = import,
+		.type = IMPORTED_EXPRESSION
+	};
+	return _buildNode(compilerState, INTERNED_FACTOR, &prototype, sizeof(Factor));
 }
 
-Program * ExpressionProgramSemanticAction(Expression * expression) {
+Program * ExpressionProgramSemanticAction(CompilerState * compilerState, Expression * expression) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	Program * program = calloc(1, sizeof(Program));
+	if (compilerState->constantFolder != NULL) {
+		return NULL;
+	}
+	FlatSyntaxTree * flatSyntaxTree = compilerState->flatSyntaxTree;
+	if (flatSyntaxTree != NULL) {
+		flatSyntaxTree->root = flatSyntaxTree->count - 1;
+		return NULL;
+	}
+	Program * program = allocateInArena(compilerState->arena, sizeof(Program));
 	program->expression = expression;
-	_compilerState->abstractSyntaxtTree = program;
+	compilerState->abstractSyntaxtTree = program;
 	return program;
 }
@@ -1,13 +1,19 @@
 #ifndef BISON_ACTIONS_HEADER
 #define BISON_ACTIONS_HEADER
 
+#include "../../backend/domain-specific/Calculator.h"
 #include "../../support/logging/Logger.h"
+#include "../../support/memory/Arena.h"
 #include "../../support/type/CompilerState.h"
 #include "../../support/type/ModuleDestructor.h"
+#include "../../support/type/SemanticValue.h"
 #include "../../support/type/TokenLabel.h"
 #include "AbstractSyntaxTree.h"
 #include "BisonParser.h"
+#include "FlatSyntaxTree.h"
+#include "NodeInterner.h"
 #include <stdlib.h>
+#include <string.h>
 
 /** Initialize module's internal state. */
 ModuleDestructor initializeBisonActionsModule();
@@ -16,11 +22,12 @@ ModuleDestructor initializeBisonActionsModule();
  * Bison semantic actions.
  */
 
-Constant * IntegerConstantSemanticAction(const int value);
-Expression * ArithmeticExpressionSemanticAction(Expression * leftExpression, Expression * rightExpression, ExpressionType type);
-Expression * FactorExpressionSemanticAction(Factor * factor);
-Factor * ConstantFactorSemanticAction(Constant * constant);
-Factor * ExpressionFactorSemanticAction(Expression * expression);
-Program * ExpressionProgramSemanticAction(Expression * expression);
+Constant * IntegerConstantSemanticAction(CompilerState * compilerState, const int value);
+Expression * ArithmeticExpressionSemanticAction(CompilerState * compilerState, Expression * leftExpression, Expression * rightExpression, ExpressionType type);
+Expression * FactorExpressionSemanticAction(CompilerState * compilerState, Factor * factor);
+Factor * ConstantFactorSemanticAction(CompilerState * compilerState, Constant * constant);
+Factor * ExpressionFactorSemanticAction(CompilerState * compilerState, Expression * expression);
+Factor * ImportFactorSemanticAction(CompilerState * compilerState, Import * import);
+Program * ExpressionProgramSemanticAction(CompilerState * compilerState, Expression * expression);
 
 #endif
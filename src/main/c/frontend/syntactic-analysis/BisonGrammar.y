@@ -12,10 +12,16 @@
  * @see https://www.gnu.org/software/bison/manual/html_node/Error-Reporting-Function.html
  * @see https://www.gnu.org/software/bison/manual/html_node/Tracking-Locations.html
  */
-void yyerror(const YYLTYPE * location, const char * message) {}
+void yyerror(const YYLTYPE * location, CompilerState * compilerState, const char * message) {}
 
 %}
 
+%code requires {
+
+#include "../../support/type/CompilerState.h"
+
+}
+
 // You touch this, and you die.
 %define api.pure full
 %define api.push-pull push
@@ -23,9 +29,19 @@ void yyerror(const YYLTYPE * location, const char * message) {}
 %define parse.error detailed
 %locations
 
+/**
+ * The state of the compilation travels as an argument of the parser (and of
+ * every semantic action), instead of living in a global variable, so many
+ * compilations can run at the same time.
+ *
+ * @see https://www.gnu.org/software/bison/manual/html_node/Parser-Function.html
+ */
+%parse-param {CompilerState * compilerState}
+
 %union {
 	/** Terminals. */
 
+	Import * import;
 	signed int integer;
 	TokenLabel token;
 
@@ -38,16 +54,13 @@ void yyerror(const YYLTYPE * location, const char * message) {}
 }
 
 /**
- * Destructors. This functions are executed after the parsing ends, so if the
- * AST must be used in the following phases of the compiler you shouldn't used
- * this approach for the AST root node ("program" non-terminal, in this
- * grammar), or it will drop the entire tree even if the parsing succeeds.
+ * Destructors. This grammar doesn't declare any, because the nodes of the AST
+ * are allocated in the arena of the compiler state. When the parsing fails,
+ * the partial trees that Bison drops are released at once by rolling back the
+ * arena to the mark taken before the parsing began (see "EntryPoint.c").
  *
  * @see https://www.gnu.org/software/bison/manual/html_node/Destructor-Decl.html
  */
-%destructor { destroyConstant($$); } <constant>
-%destructor { destroyExpression($$); } <expression>
-%destructor { destroyFactor($$); } <factor>
 
 /** Terminals. */
 %token <integer> INTEGER
@@ -56,6 +69,7 @@ void yyerror(const YYLTYPE * location, const char * message) {}
 %token <token> CLOSE_COMMENT
 %token <token> CLOSE_PARENTHESIS
 %token <token> DIV
+%token <import> IMPORT
 %token <token> MUL
 %token <token> OPEN_BRACE
 %token <token> OPEN_COMMENT
@@ -84,21 +98,22 @@ void yyerror(const YYLTYPE * location, const char * message) {}
 
 // IMPORTANT: To use λ in the following grammar, use the %empty symbol.
 
-program: expression											{ $$ = ExpressionProgramSemanticAction($1); }
+program: expression											{ $$ = ExpressionProgramSemanticAction(compilerState, $1); }
 	;
 
-expression: expression[left] ADD expression[right]			{ $$ = ArithmeticExpressionSemanticAction($left, $right, ADDITION); }
-	| expression[left] DIV expression[right]				{ $$ = ArithmeticExpressionSemanticAction($left, $right, DIVISION); }
-	| expression[left] MUL expression[right]				{ $$ = ArithmeticExpressionSemanticAction($left, $right, MULTIPLICATION); }
-	| expression[left] SUB expression[right]				{ $$ = ArithmeticExpressionSemanticAction($left, $right, SUBTRACTION); }
-	| factor												{ $$ = FactorExpressionSemanticAction($1); }
+expression: expression[left] ADD expression[right]			{ $$ = ArithmeticExpressionSemanticAction(compilerState, $left, $right, ADDITION); }
+	| expression[left] DIV expression[right]				{ $$ = ArithmeticExpressionSemanticAction(compilerState, $left, $right, DIVISION); }
+	| expression[left] MUL expression[right]				{ $$ = ArithmeticExpressionSemanticAction(compilerState, $left, $right, MULTIPLICATION); }
+	| expression[left] SUB expression[right]				{ $$ = ArithmeticExpressionSemanticAction(compilerState, $left, $right, SUBTRACTION); }
+	| factor												{ $$ = FactorExpressionSemanticAction(compilerState, $1); }
 	;
 
-factor: OPEN_PARENTHESIS expression CLOSE_PARENTHESIS		{ $$ = ExpressionFactorSemanticAction($2); }
-	| constant												{ $$ = ConstantFactorSemanticAction($1); }
+factor: OPEN_PARENTHESIS expression CLOSE_PARENTHESIS		{ $$ = ExpressionFactorSemanticAction(compilerState, $2); }
+	| constant												{ $$ = ConstantFactorSemanticAction(compilerState, $1); }
+	| IMPORT												{ $$ = ImportFactorSemanticAction(compilerState, $1); }
 	;
 
-constant: INTEGER											{ $$ = IntegerConstantSemanticAction($1); }
+constant: INTEGER											{ $$ = IntegerConstantSemanticAction(compilerState, $1); }
 	;
 
 %%
@@ -0,0 +1,85 @@
+#include "FlatSyntaxTree.h"
+
+/* PUBLIC FUNCTIONS */
+
+bool appendFlatNode(FlatSyntaxTree * flatSyntaxTree, const FlatNode node) {
+	if (!reserveFlatNodes(flatSyntaxTree, 1)) {
+		return false;
+	}
+	flatSyntaxTree->nodes[flatSyntaxTree->count++] = node;
+	return true;
+}
+
+FlatSyntaxTree * createFlatSyntaxTree(const NodeIndex capacity) {
+	FlatSyntaxTree * flatSyntaxTree = calloc(1, sizeof(FlatSyntaxTree));
+	flatSyntaxTree->nodes = calloc(capacity, sizeof(FlatNode));
+	flatSyntaxTree->capacity = capacity;
+	flatSyntaxTree->count = 0;
+	flatSyntaxTree->root = 0;
+	flatSyntaxTree->overflowed = false;
+	flatSyntaxTree->mapping = NULL;
+	flatSyntaxTree->mappingSize = 0;
+	return flatSyntaxTree;
+}
+
+void destroyFlatSyntaxTree(FlatSyntaxTree * flatSyntaxTree) {
+	if (flatSyntaxTree != NULL) {
+		if (flatSyntaxTree->mapping != NULL) {
+			munmap(flatSyntaxTree->mapping, flatSyntaxTree->mappingSize);
+			flatSyntaxTree->mapping = NULL;
+			flatSyntaxTree->nodes = NULL;
+		}
+		else if (flatSyntaxTree->nodes != NULL) {
+			free(flatSyntaxTree->nodes);
+			flatSyntaxTree->nodes = NULL;
+		}
+		free(flatSyntaxTree);
+	}
+}
+
+size_t measureFlatSyntaxTreeDepth(const FlatSyntaxTree * flatSyntaxTree) {
+	if (flatSyntaxTree->count == 0) {
+		return 0;
+	}
+	// The table is in post-order, so the children of a node are measured first:
+	uint32_t * depths = malloc(flatSyntaxTree->count * sizeof(uint32_t));
+	for (NodeIndex k = 0; k < flatSyntaxTree->count; ++k) {
+		const FlatNode * node = &flatSyntaxTree->nodes[k];
+		switch (node->type) {
+			case CONSTANT_NODE:
+				depths[k] = 1;
+				break;
+			case PARENTHESIS_NODE:
+				depths[k] = 1 + depths[node->expression];
+				break;
+			default:
+				depths[k] = 1 + (depths[node->leftExpression] < depths[node->rightExpression]
+					? depths[node->rightExpression]
+					: depths[node->leftExpression]);
+		}
+	}
+	const size_t depth = depths[flatSyntaxTree->root];
+	free(depths);
+	return depth;
+}
+
+bool reserveFlatNodes(FlatSyntaxTree * flatSyntaxTree, const NodeIndex count) {
+	if (MAXIMUM_FLAT_NODE_COUNT - flatSyntaxTree->count < count) {
+		flatSyntaxTree->overflowed = true;
+		return false;
+	}
+	if (flatSyntaxTree->capacity - flatSyntaxTree->count < count) {
+		NodeIndex capacity = flatSyntaxTree->capacity == 0 ? 1 : flatSyntaxTree->capacity;
+		while (capacity - flatSyntaxTree->count < count) {
+			capacity = capacity < MAXIMUM_FLAT_NODE_COUNT / 2 ? 2 * capacity : MAXIMUM_FLAT_NODE_COUNT;
+		}
+		FlatNode * nodes = realloc(flatSyntaxTree->nodes, (size_t) capacity * sizeof(FlatNode));
+		if (nodes == NULL) {
+			flatSyntaxTree->overflowed = true;
+			return false;
+		}
+		flatSyntaxTree->nodes = nodes;
+		flatSyntaxTree->capacity = capacity;
+	}
+	return true;
+}
@@ -0,0 +1,113 @@
+#ifndef FLAT_SYNTAX_TREE_HEADER
+#define FLAT_SYNTAX_TREE_HEADER
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+
+/**
+ * An alternative layout of the Abstract Syntax Tree (AST): a single contiguous
+ * table of fixed-size nodes, where children are referenced by index and
+ * constants are stored inline, so the "Expression -> Factor -> Constant" chain
+ * of the pointer-based tree collapses into one node.
+ *
+ * Bison reduces the rules in post-order, hence the parser appends the nodes
+ * children-first: the right child (or the only child) of a node is always the
+ * previous node in the table, and the root is the last one.
+ */
+
+/**
+ * The maximum amount of nodes of a table, so its 32-bit indices and sizes
+ * never wrap around.
+ */
+#define MAXIMUM_FLAT_NODE_COUNT (UINT32_MAX >> 1)
+
+typedef enum FlatNodeType FlatNodeType;
+
+typedef struct FlatNode FlatNode;
+typedef struct FlatSyntaxTree FlatSyntaxTree;
+
+typedef uint32_t NodeIndex;
+
+enum FlatNodeType {
+	ADDITION_NODE,
+	CONSTANT_NODE,
+	DIVISION_NODE,
+	MULTIPLICATION_NODE,
+	PARENTHESIS_NODE,
+	SUBTRACTION_NODE
+};
+
+struct FlatNode {
+	union {
+		int value;
+		NodeIndex expression;
+		struct {
+			NodeIndex leftExpression;
+			NodeIndex rightExpression;
+		};
+	};
+	FlatNodeType type;
+
+	/**
+	 * The amount of nodes in the subtree rooted at this node (inclusive).
+	 */
+	uint32_t size;
+};
+
+_Static_assert(sizeof(FlatNode) == 16, "A flat node must fit in 16 bytes.");
+
+struct FlatSyntaxTree {
+	FlatNode * nodes;
+	NodeIndex capacity;
+	NodeIndex count;
+	NodeIndex root;
+
+	/**
+	 * Whether a node was dropped, because the table reached the maximum
+	 * amount of nodes, or it couldn't grow. The table is incomplete, so the
+	 * compilation that fills it must fail.
+	 */
+	bool overflowed;
+
+	/**
+	 * The file mapped in memory that holds the nodes, if the table was loaded
+	 * from disk (see "SyntaxTreeImage.h"), or NULL if they're in heap-memory.
+	 * A mapped table cannot grow.
+	 */
+	void * mapping;
+	size_t mappingSize;
+};
+
+/**
+ * Appends a node to the table. If the table is full (see
+ * "MAXIMUM_FLAT_NODE_COUNT") or there is no memory to grow it, the node is
+ * dropped, the table is marked as overflowed, and it returns false.
+ */
+bool appendFlatNode(FlatSyntaxTree * flatSyntaxTree, const FlatNode node);
+
+/**
+ * Creates a new empty table, with room for the specified amount of nodes
+ * before it needs to grow.
+ */
+FlatSyntaxTree * createFlatSyntaxTree(const NodeIndex capacity);
+
+/**
+ * Destroys a table and all of its nodes (or unmaps them).
+ */
+void destroyFlatSyntaxTree(FlatSyntaxTree * flatSyntaxTree);
+
+/**
+ * Measures the depth of the tree, with a single pass over the table.
+ */
+size_t measureFlatSyntaxTreeDepth(const FlatSyntaxTree * flatSyntaxTree);
+
+/**
+ * Makes room for the specified amount of nodes at once, so appending them
+ * doesn't move the table. If they don't fit (see "MAXIMUM_FLAT_NODE_COUNT"),
+ * or there is no memory to grow it, the table is marked as overflowed, and it
+ * returns false.
+ */
+bool reserveFlatNodes(FlatSyntaxTree * flatSyntaxTree, const NodeIndex count);
+#endif
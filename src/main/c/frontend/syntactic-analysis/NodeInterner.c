@@ -0,0 +1,213 @@
+#include "NodeInterner.h"
+
+/* MODULE INTERNAL STATE */
+
+static const size_t _initialCapacity = 1 << 10;
+static const size_t _initialSharedCapacity = 1 << 6;
+static Logger * _logger = NULL;
+
+/** Shutdown module's internal state. */
+void _shutdownNodeInternerModule() {
+	if (_logger != NULL) {
+		LOG_DEBUGGING(_logger, "Destroying module: NodeInterner...");
+		destroyLogger(_logger);
+		_logger = NULL;
+	}
+}
+
+ModuleDestructor initializeNodeInternerModule() {
+	_logger = createLogger("NodeInterner");
+	return _shutdownNodeInternerModule;
+}
+
+/* PRIVATE FUNCTIONS */
+
+static uint64_t _hashNode(const InternedNodeType type, const void * node);
+static bool _isSameNode(const InternedNodeType type, const void * node, const void * otherNode);
+static uint64_t _mix(const uint64_t hash, const uint64_t word);
+static void _share(NodeInterner * nodeInterner, const Expression * expression);
+
+/**
+ * Hashes the type, the value and the children pointers of a node (the
+ * children are interned already, so their addresses identify them).
+ */
+static uint64_t _hashNode(const InternedNodeType type, const void * node) {
+	uint64_t hash = _mix(0, type);
+	switch (type) {
+		case INTERNED_CONSTANT: {
+			const Constant * constant = node;
+			return _mix(hash, (uint32_t) constant->value);
+		}
+		case INTERNED_EXPRESSION: {
+			const Expression * expression = node;
+			hash = _mix(hash, expression->type);
+			if (expression->type == FACTOR) {
+				return _mix(hash, (uintptr_t) expression->factor);
+			}
+			hash = _mix(hash, (uintptr_t) expression->leftExpression);
+			return _mix(hash, (uintptr_t) expression->rightExpression);
+		}
+		default: {
+			const Factor * factor = node;
+			hash = _mix(hash, factor->type);
+			return _mix(hash, (uintptr_t) factor->constant);
+		}
+	}
+}
+
+/**
+ * Whether two nodes of the same type are structurally equal.
+ */
+static bool _isSameNode(const InternedNodeType type, const void * node, const void * otherNode) {
+	switch (type) {
+		case INTERNED_CONSTANT:
+			return ((const Constant *) node)->value == ((const Constant *) otherNode)->value;
+		case INTERNED_EXPRESSION: {
+			const Expression * expression = node;
+			const Expression * otherExpression = otherNode;
+			if (expression->type != otherExpression->type) {
+				return false;
+			}
+			return expression->type == FACTOR
+				? expression->factor == otherExpression->factor
+				: expression->leftExpression == otherExpression->leftExpression
+					&& expression->rightExpression == otherExpression->rightExpression;
+		}
+		default: {
+			const Factor * factor = node;
+			const Factor * otherFactor = otherNode;
+			return factor->type == otherFactor->type && factor->constant == otherFactor->constant;
+		}
+	}
+}
+
+/**
+ * Mixes a word into a hash (see "SplitMix64"), so the pointers, which are
+ * aligned and close to each other in the arena, spread over the table.
+ *
+ * @see https://prng.di.unimi.it/splitmix64.c
+ */
+static uint64_t _mix(const uint64_t hash, const uint64_t word) {
+	uint64_t mixed = hash ^ (word + 0x9E3779B97F4A7C15ULL + (hash << 6) + (hash >> 2));
+	mixed = (mixed ^ (mixed >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	mixed = (mixed ^ (mixed >> 27)) * 0x94D049BB133111EBULL;
+	return mixed ^ (mixed >> 31);
+}
+
+/**
+ * Adds an expression to the shared ones, unless it's there already. The side
+ * table doubles when it's half full, as the one of the nodes.
+ */
+static void _share(NodeInterner * nodeInterner, const Expression * expression) {
+	if (findSharedExpression(nodeInterner, expression) != NULL) {
+		return;
+	}
+	if (nodeInterner->sharedCapacity < 2 * (nodeInterner->sharedCount + 1)) {
+		const size_t capacity = nodeInterner->sharedCapacity == 0 ? _initialSharedCapacity : 2 * nodeInterner->sharedCapacity;
+		SharedExpression * sharedExpressions = calloc(capacity, sizeof(SharedExpression));
+		for (size_t k = 0; k < nodeInterner->sharedCapacity; ++k) {
+			if (nodeInterner->sharedExpressions[k].expression != NULL) {
+				size_t slot = _mix(0, (uintptr_t) nodeInterner->sharedExpressions[k].expression) & (capacity - 1);
+				while (sharedExpressions[slot].expression != NULL) {
+					slot = (slot + 1) & (capacity - 1);
+				}
+				sharedExpressions[slot] = nodeInterner->sharedExpressions[k];
+			}
+		}
+		free(nodeInterner->sharedExpressions);
+		nodeInterner->sharedExpressions = sharedExpressions;
+		nodeInterner->sharedCapacity = capacity;
+	}
+	const size_t mask = nodeInterner->sharedCapacity - 1;
+	size_t slot = _mix(0, (uintptr_t) expression) & mask;
+	while (nodeInterner->sharedExpressions[slot].expression != NULL) {
+		slot = (slot + 1) & mask;
+	}
+	nodeInterner->sharedExpressions[slot].expression = expression;
+	++nodeInterner->sharedCount;
+}
+
+/* PUBLIC FUNCTIONS */
+
+NodeInterner * createNodeInterner() {
+	NodeInterner * nodeInterner = calloc(1, sizeof(NodeInterner));
+	nodeInterner->capacity = _initialCapacity;
+	nodeInterner->nodes = calloc(nodeInterner->capacity, sizeof(InternedNode));
+	return nodeInterner;
+}
+
+void destroyNodeInterner(NodeInterner * nodeInterner) {
+	if (nodeInterner != NULL) {
+		LOG_DEBUGGING(_logger, "Nodes interned: %zu (shared %zu times, %zu expressions).", nodeInterner->count, nodeInterner->hits, nodeInterner->sharedCount);
+		free(nodeInterner->nodes);
+		free(nodeInterner->sharedExpressions);
+		free(nodeInterner);
+	}
+}
+
+void * findInternedNode(NodeInterner * nodeInterner, const InternedNodeType type, const void * prototype) {
+	if (nodeInterner == NULL) {
+		return NULL;
+	}
+	const uint64_t hash = _hashNode(type, prototype);
+	const size_t mask = nodeInterner->capacity - 1;
+	for (size_t k = hash & mask; nodeInterner->nodes[k].node != NULL; k = (k + 1) & mask) {
+		const InternedNode * internedNode = &nodeInterner->nodes[k];
+		if (internedNode->hash == hash && internedNode->type == type && _isSameNode(type, internedNode->node, prototype)) {
+			if (type == INTERNED_EXPRESSION) {
+				_share(nodeInterner, internedNode->node);
+			}
+			++nodeInterner->hits;
+			return internedNode->node;
+		}
+	}
+	return NULL;
+}
+
+SharedExpression * findSharedExpression(const NodeInterner * nodeInterner, const Expression * expression) {
+	if (nodeInterner == NULL || nodeInterner->sharedCount == 0) {
+		return NULL;
+	}
+	const size_t mask = nodeInterner->sharedCapacity - 1;
+	for (size_t k = _mix(0, (uintptr_t) expression) & mask; nodeInterner->sharedExpressions[k].expression != NULL; k = (k + 1) & mask) {
+		if (nodeInterner->sharedExpressions[k].expression == expression) {
+			return &nodeInterner->sharedExpressions[k];
+		}
+	}
+	return NULL;
+}
+
+void internNode(NodeInterner * nodeInterner, const InternedNodeType type, void * node) {
+	if (nodeInterner == NULL) {
+		return;
+	}
+	// The table doubles when it's half full, so the probes stay short:
+	if (nodeInterner->capacity < 2 * (nodeInterner->count + 1)) {
+		const size_t capacity = 2 * nodeInterner->capacity;
+		InternedNode * nodes = calloc(capacity, sizeof(InternedNode));
+		for (size_t k = 0; k < nodeInterner->capacity; ++k) {
+			if (nodeInterner->nodes[k].node != NULL) {
+				size_t slot = nodeInterner->nodes[k].hash & (capacity - 1);
+				while (nodes[slot].node != NULL) {
+					slot = (slot + 1) & (capacity - 1);
+				}
+				nodes[slot] = nodeInterner->nodes[k];
+			}
+		}
+		free(nodeInterner->nodes);
+		nodeInterner->nodes = nodes;
+		nodeInterner->capacity = capacity;
+	}
+	const uint64_t hash = _hashNode(type, node);
+	const size_t mask = nodeInterner->capacity - 1;
+	size_t slot = hash & mask;
+	while (nodeInterner->nodes[slot].node != NULL) {
+		slot = (slot + 1) & mask;
+	}
+	nodeInterner->nodes[slot] = (InternedNode) {
+		.hash = hash,
+		.node = node,
+		.type = type
+	};
+	++nodeInterner->count;
+}
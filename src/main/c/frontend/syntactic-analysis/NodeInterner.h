@@ -0,0 +1,98 @@
+#ifndef NODE_INTERNER_HEADER
+#define NODE_INTERNER_HEADER
+
+#include "../../support/logging/Logger.h"
+#include "../../support/type/ModuleDestructor.h"
+#include "AbstractSyntaxTree.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/** Initialize module's internal state. */
+ModuleDestructor initializeNodeInternerModule();
+
+/**
+ * The kinds of nodes of the pointer-based AST that can be interned.
+ */
+typedef enum {
+	INTERNED_CONSTANT,
+	INTERNED_EXPRESSION,
+	INTERNED_FACTOR
+} InternedNodeType;
+
+typedef struct {
+	uint64_t hash;
+	void * node;
+	InternedNodeType type;
+} InternedNode;
+
+/**
+ * An expression shared among many parents, and its value, once it's
+ * successfully computed. The value is accessed atomically, as the one of an
+ * import, because the parallel engine can compute the same expression in many
+ * threads.
+ */
+typedef struct {
+	const Expression * expression;
+	bool memoized;
+	int value;
+} SharedExpression;
+
+/**
+ * The nodes of a single compilation, in a hash table by structure (with open
+ * addressing), so the parser builds every distinct constant, factor and
+ * expression only once, and shares it among all of its parents: the AST
+ * becomes a directed acyclic graph (a.k.a. hash-consing). Bison reduces the
+ * children first, so they're already interned, and two nodes are equal if
+ * their types, values and children pointers are.
+ *
+ * The nodes still live in the arena of the compiler state, which owns them
+ * (the interner only references them), so a rollback or the teardown drop
+ * them as usual. The shared expressions are also kept in a side table (keyed
+ * by their address, so the nodes stay as small as without the interner),
+ * where the calculator memoizes their values, so it computes each one once.
+ * The table only grows while parsing, so it's read without any lock later.
+ *
+ * @see https://en.wikipedia.org/wiki/Hash_consing
+ */
+typedef struct {
+	InternedNode * nodes;
+	size_t capacity;
+	size_t count;
+	size_t hits;
+	SharedExpression * sharedExpressions;
+	size_t sharedCapacity;
+	size_t sharedCount;
+} NodeInterner;
+
+/**
+ * Creates a new empty interner.
+ */
+NodeInterner * createNodeInterner();
+
+/**
+ * Destroys an interner (but not its nodes, owned by the arena).
+ */
+void destroyNodeInterner(NodeInterner * nodeInterner);
+
+/**
+ * Returns the interned node equal to a prototype (a constant, an expression
+ * or a factor, built in the native stack), or NULL if there is none yet. An
+ * expression found is added to the shared ones. A NULL interner finds nothing.
+ */
+void * findInternedNode(NodeInterner * nodeInterner, const InternedNodeType type, const void * prototype);
+
+/**
+ * Returns the entry of a shared expression, or NULL if the expression isn't
+ * shared (or the interner is NULL).
+ */
+SharedExpression * findSharedExpression(const NodeInterner * nodeInterner, const Expression * expression);
+
+/**
+ * Interns a node just built in the arena, that "findInternedNode" didn't
+ * find. A NULL interner does nothing.
+ */
+void internNode(NodeInterner * nodeInterner, const InternedNodeType type, void * node);
+
+#endif
@@ -0,0 +1,289 @@
+#include "SyntaxTreeImage.h"
+
+/* MODULE INTERNAL STATE */
+
+static const NodeIndex _flattenedInitialCapacity = 1 << 10;
+static const char _magic[4] = { 'F', 'B', 'S', 'T' };
+static const uint32_t _version = 1;
+static Logger * _logger = NULL;
+
+/**
+ * The header of a stored image. It's as large as a node, so the table that
+ * follows it is aligned in the mapping.
+ */
+typedef struct {
+	char magic[4];
+	uint32_t version;
+	uint32_t count;
+	uint32_t root;
+} SyntaxTreeImageHeader;
+
+_Static_assert(sizeof(SyntaxTreeImageHeader) == sizeof(FlatNode), "The header of an image must be as large as a flat node.");
+
+/**
+ * A pending step of the flattening: either visit an expression, or append the
+ * node of its operator (or of its parentheses), after the nodes of its
+ * children.
+ */
+typedef struct {
+	Expression * expression;
+	FlatNodeType type;
+	bool appendNode;
+} FlatteningStep;
+
+/** Shutdown module's internal state. */
+void _shutdownSyntaxTreeImageModule() {
+	if (_logger != NULL) {
+		LOG_DEBUGGING(_logger, "Destroying module: SyntaxTreeImage...");
+		destroyLogger(_logger);
+		_logger = NULL;
+	}
+}
+
+ModuleDestructor initializeSyntaxTreeImageModule() {
+	_logger = createLogger("SyntaxTreeImage");
+	return _shutdownSyntaxTreeImageModule;
+}
+
+/* PRIVATE FUNCTIONS */
+
+static void _appendPostOrderNode(FlatSyntaxTree * flatSyntaxTree, const FlatNode node);
+static FlatNodeType _expressionTypeToFlatNodeType(const ExpressionType type);
+static FlatSyntaxTree * _flattenExpression(Expression * expression);
+static bool _verifyFlatNodes(const FlatNode * nodes, const NodeIndex count);
+static bool _writeImage(const FlatSyntaxTree * flatSyntaxTree, const char * path);
+
+/**
+ * Appends a node whose children are the last nodes appended, in post-order,
+ * so only its type (or its value) is needed.
+ */
+static void _appendPostOrderNode(FlatSyntaxTree * flatSyntaxTree, const FlatNode node) {
+	FlatNode effectiveNode = node;
+	if (node.type == PARENTHESIS_NODE) {
+		effectiveNode.expression = flatSyntaxTree->count - 1;
+		effectiveNode.size = 1 + flatSyntaxTree->nodes[effectiveNode.expression].size;
+	}
+	else if (node.type != CONSTANT_NODE) {
+		effectiveNode.rightExpression = flatSyntaxTree->count - 1;
+		effectiveNode.leftExpression = effectiveNode.rightExpression - flatSyntaxTree->nodes[effectiveNode.rightExpression].size;
+		effectiveNode.size = 1
+			+ flatSyntaxTree->nodes[effectiveNode.leftExpression].size
+			+ flatSyntaxTree->nodes[effectiveNode.rightExpression].size;
+	}
+	else {
+		effectiveNode.size = 1;
+	}
+	appendFlatNode(flatSyntaxTree, effectiveNode);
+}
+
+/**
+ * Converts an arithmetic expression type to the type of its flat node.
+ */
+static FlatNodeType _expressionTypeToFlatNodeType(const ExpressionType type) {
+	switch (type) {
+		case ADDITION: return ADDITION_NODE;
+		case DIVISION: return DIVISION_NODE;
+		case MULTIPLICATION: return MULTIPLICATION_NODE;
+		case SUBTRACTION: return SUBTRACTION_NODE;
+		default:
+			LOG_ERROR(_logger, "The specified expression type cannot be converted into a flat node type: %d", type);
+			return CONSTANT_NODE;
+	}
+}
+
+/**
+ * Writes the flat table of a pointer tree, walking it with an explicit stack.
+ * Returns NULL if the table would be too large (e.g., a program that imports
+ * the same file an exponential amount of times).
+ */
+static FlatSyntaxTree * _flattenExpression(Expression * expression) {
+	FlatSyntaxTree * flatSyntaxTree = createFlatSyntaxTree(_flattenedInitialCapacity);
+	size_t capacity = 64;
+	size_t count = 0;
+	FlatteningStep * steps = calloc(capacity, sizeof(FlatteningStep));
+	steps[count++] = (FlatteningStep) { .expression = expression, .appendNode = false };
+	while (0 < count) {
+		if (flatSyntaxTree->count == MAXIMUM_FLAT_NODE_COUNT) {
+			destroyFlatSyntaxTree(flatSyntaxTree);
+			flatSyntaxTree = NULL;
+			break;
+		}
+		const FlatteningStep step = steps[--count];
+		Expression * current = step.expression;
+		if (step.appendNode) {
+			_appendPostOrderNode(flatSyntaxTree, (FlatNode) { .type = step.type });
+			continue;
+		}
+		if (capacity < count + 3) {
+			capacity *= 2;
+			steps = realloc(steps, capacity * sizeof(FlatteningStep));
+		}
+		if (current->type == FACTOR && current->factor->type == CONSTANT) {
+			_appendPostOrderNode(flatSyntaxTree, (FlatNode) { .type = CONSTANT_NODE, .value = current->factor->constant->value });
+		}
+		else if (current->type == FACTOR) {
+			steps[count++] = (FlatteningStep) { .expression = current, .type = PARENTHESIS_NODE, .appendNode = true };
+			steps[count++] = (FlatteningStep) { .expression = innerExpression(current->factor), .appendNode = false };
+		}
+		else {
+			steps[count++] = (FlatteningStep) { .expression = current, .type = _expressionTypeToFlatNodeType(current->type), .appendNode = true };
+			steps[count++] = (FlatteningStep) { .expression = current->rightExpression, .appendNode = false };
+			steps[count++] = (FlatteningStep) { .expression = current->leftExpression, .appendNode = false };
+		}
+	}
+	free(steps);
+	if (flatSyntaxTree != NULL) {
+		flatSyntaxTree->root = flatSyntaxTree->count - 1;
+	}
+	return flatSyntaxTree;
+}
+
+/**
+ * Checks that a mapped table is safe to traverse: it's in post-order (the
+ * right child, or the only child, of every node is the previous one), every
+ * index points backwards, and every size matches the children. So, the table
+ * is a single tree, whose root is the last node.
+ */
+static bool _verifyFlatNodes(const FlatNode * nodes, const NodeIndex count) {
+	for (NodeIndex k = 0; k < count; ++k) {
+		const FlatNode * node = &nodes[k];
+		switch (node->type) {
+			case CONSTANT_NODE:
+				if (node->size != 1) {
+					return false;
+				}
+				break;
+			case PARENTHESIS_NODE:
+				if (k == 0 || node->expression != k - 1 || node->size != 1 + nodes[k - 1].size) {
+					return false;
+				}
+				break;
+			case ADDITION_NODE:
+			case DIVISION_NODE:
+			case MULTIPLICATION_NODE:
+			case SUBTRACTION_NODE:
+				if (k < 2
+					|| node->rightExpression != k - 1
+					|| k <= nodes[k - 1].size
+					|| node->leftExpression != k - 1 - nodes[k - 1].size
+					|| node->size != 1 + nodes[node->leftExpression].size + nodes[k - 1].size) {
+					return false;
+				}
+				break;
+			default:
+				return false;
+		}
+	}
+	return nodes[count - 1].size == count;
+}
+
+/**
+ * Writes the image of the subtree of a flat table rooted at its root node,
+ * whose nodes are contiguous (see "FlatSyntaxTree.h"). If it doesn't start at
+ * the first node, the indices are shifted, so the image always starts at 0.
+ */
+static bool _writeImage(const FlatSyntaxTree * flatSyntaxTree, const char * path) {
+	FILE * file = fopen(path, "wb");
+	if (file == NULL) {
+		LOG_ERROR(_logger, "Cannot create the syntax tree image: \"%s\".", path);
+		return false;
+	}
+	const NodeIndex root = flatSyntaxTree->root;
+	const NodeIndex count = flatSyntaxTree->nodes[root].size;
+	const NodeIndex first = 1 + root - count;
+	SyntaxTreeImageHeader header = {
+		.version = _version,
+		.count = count,
+		.root = count - 1
+	};
+	memcpy(header.magic, _magic, sizeof(_magic));
+	bool succeeded = fwrite(&header, sizeof(SyntaxTreeImageHeader), 1, file) == 1;
+	if (first == 0) {
+		succeeded = succeeded && fwrite(flatSyntaxTree->nodes, sizeof(FlatNode), count, file) == count;
+	}
+	else {
+		for (NodeIndex k = first; succeeded && k <= root; ++k) {
+			FlatNode node = flatSyntaxTree->nodes[k];
+			if (node.type == PARENTHESIS_NODE) {
+				node.expression -= first;
+			}
+			else if (node.type != CONSTANT_NODE) {
+				node.leftExpression -= first;
+				node.rightExpression -= first;
+			}
+			succeeded = fwrite(&node, sizeof(FlatNode), 1, file) == 1;
+		}
+	}
+	if (fclose(file) != 0 || !succeeded) {
+		LOG_ERROR(_logger, "Cannot write the syntax tree image: \"%s\".", path);
+		return false;
+	}
+	LOG_DEBUGGING(_logger, "The syntax tree image is stored in \"%s\" (nodes=%u).", path, count);
+	return true;
+}
+
+/* PUBLIC FUNCTIONS */
+
+FlatSyntaxTree * mapSyntaxTreeImage(const char * path) {
+	const int fileDescriptor = open(path, O_RDONLY);
+	if (fileDescriptor < 0) {
+		LOG_ERROR(_logger, "Cannot open the syntax tree image: \"%s\".", path);
+		return NULL;
+	}
+	struct stat status;
+	void * mapping = MAP_FAILED;
+	size_t mappingSize = 0;
+	if (fstat(fileDescriptor, &status) == 0 && sizeof(SyntaxTreeImageHeader) <= (size_t) status.st_size) {
+		mappingSize = status.st_size;
+		mapping = mmap(NULL, mappingSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fileDescriptor, 0);
+	}
+	close(fileDescriptor);
+	if (mapping == MAP_FAILED) {
+		LOG_ERROR(_logger, "The file is not a valid syntax tree image for this compiler: \"%s\".", path);
+		return NULL;
+	}
+	const SyntaxTreeImageHeader * header = mapping;
+	FlatNode * nodes = (FlatNode *) (header + 1);
+	if (memcmp(header->magic, _magic, sizeof(_magic)) != 0
+		|| header->version != _version
+		|| header->count == 0
+		|| MAXIMUM_FLAT_NODE_COUNT < header->count
+		|| header->root != header->count - 1
+		|| mappingSize != sizeof(SyntaxTreeImageHeader) + (size_t) header->count * sizeof(FlatNode)
+		|| !_verifyFlatNodes(nodes, header->count)) {
+		munmap(mapping, mappingSize);
+		LOG_ERROR(_logger, "The file is not a valid syntax tree image for this compiler: \"%s\".", path);
+		return NULL;
+	}
+	madvise(mapping, mappingSize, MADV_SEQUENTIAL);
+	FlatSyntaxTree * flatSyntaxTree = calloc(1, sizeof(FlatSyntaxTree));
+	flatSyntaxTree->nodes = nodes;
+	flatSyntaxTree->capacity = header->count;
+	flatSyntaxTree->count = header->count;
+	flatSyntaxTree->root = header->root;
+	flatSyntaxTree->mapping = mapping;
+	flatSyntaxTree->mappingSize = mappingSize;
+	LOG_DEBUGGING(_logger, "The syntax tree image \"%s\" is mapped (nodes=%u).", path, flatSyntaxTree->count);
+	return flatSyntaxTree;
+}
+
+bool saveSyntaxTreeImage(const CompilerState * compilerState, const char * path) {
+	const FlatSyntaxTree * flatSyntaxTree = compilerState->flatSyntaxTree;
+	if (flatSyntaxTree != NULL) {
+		return _writeImage(flatSyntaxTree, path);
+	}
+	const Program * program = compilerState->abstractSyntaxtTree;
+	if (program == NULL) {
+		LOG_ERROR(_logger, "There is no syntax tree to store in \"%s\".", path);
+		return false;
+	}
+	LOG_DEBUGGING(_logger, "Flattening the AST...");
+	FlatSyntaxTree * flattenedSyntaxTree = _flattenExpression(program->expression);
+	if (flattenedSyntaxTree == NULL) {
+		LOG_ERROR(_logger, "The syntax tree is too large to store in \"%s\".", path);
+		return false;
+	}
+	const bool succeeded = _writeImage(flattenedSyntaxTree, path);
+	destroyFlatSyntaxTree(flattenedSyntaxTree);
+	return succeeded;
+}
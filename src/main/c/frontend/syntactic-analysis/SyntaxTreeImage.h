@@ -0,0 +1,48 @@
+#ifndef SYNTAX_TREE_IMAGE_HEADER
+#define SYNTAX_TREE_IMAGE_HEADER
+
+#include "../../support/logging/Logger.h"
+#include "../../support/type/CompilerState.h"
+#include "../../support/type/ModuleDestructor.h"
+#include "AbstractSyntaxTree.h"
+#include "FlatSyntaxTree.h"
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/** Initialize module's internal state. */
+ModuleDestructor initializeSyntaxTreeImageModule();
+
+/**
+ * A parsed program stored on disk, so it can be computed and generated again
+ * without the frontend. The image is a small header followed by the table of
+ * the flat layout (see "FlatSyntaxTree.h"), whose nodes reference each other
+ * by index, so the file is position-independent: it's mapped in memory as is,
+ * and the backend runs on the mapped table directly, with no allocation per
+ * node. The nodes are stored with the endianness of the host that parsed
+ * them (a host with another endianness rejects the version).
+ */
+
+/**
+ * Maps an image previously stored with "saveSyntaxTreeImage", as a flat table
+ * that must be destroyed with "destroyFlatSyntaxTree". The mapping is private,
+ * so the table can be rewritten in memory (e.g., by the rebalancer) without
+ * changing the file. Returns NULL if the file cannot be mapped, or if it's not
+ * a valid image for this version of the compiler.
+ */
+FlatSyntaxTree * mapSyntaxTreeImage(const char * path);
+
+/**
+ * Stores the AST of the compiler state in a file, in either layout. A pointer
+ * tree is flattened first, so every import that shares a subtree stores a
+ * copy of it (as the flat layout does). Returns true if it succeeds.
+ */
+bool saveSyntaxTreeImage(const CompilerState * compilerState, const char * path);
+
+#endif
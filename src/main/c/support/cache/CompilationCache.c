@@ -0,0 +1,364 @@
+#include "CompilationCache.h"
+
+/* MODULE INTERNAL STATE */
+
+/**
+ * The header of an entry, followed by the output. The version changes with
+ * the layout (or with anything else that changes the output of a program),
+ * so entries written by another version are just misses.
+ */
+typedef struct {
+	char magic[4];
+	uint32_t version;
+	uint64_t keyHigh;
+	uint64_t keyLow;
+	uint64_t outputLength;
+	int32_t value;
+	uint32_t succeeded;
+} CompilationEntryHeader;
+
+/**
+ * The amount of hexadecimal digits of a key, in the name of its entry.
+ */
+#define KEY_DIGITS 32
+
+static const char _entryMagic[4] = { 'F', 'B', 'C', 'C' };
+static const uint32_t _entryVersion = 1;
+static const uint64_t _lowSeed = 0x9E3779B97F4A7C15ULL;
+
+/**
+ * The primes of XXH64.
+ */
+static const uint64_t _prime1 = 11400714785074694791ULL;
+static const uint64_t _prime2 = 14029467366897019727ULL;
+static const uint64_t _prime3 = 1609587929392839161ULL;
+static const uint64_t _prime4 = 9650029242287828579ULL;
+static const uint64_t _prime5 = 2870177450012600261ULL;
+
+/**
+ * Distinguishes the temporary files of the threads of the same process.
+ */
+static atomic_uint_fast64_t _temporarySequence = 0;
+
+/**
+ * The paths found while computing a key, still to be hashed.
+ */
+typedef struct {
+	char ** paths;
+	size_t capacity;
+	size_t count;
+	StringSet * seenPaths;
+} ImportQueue;
+
+/* PRIVATE FUNCTIONS */
+
+static void _absorb(CompilationKey * compilationKey, const char * bytes, const size_t length);
+static void _enqueueImport(void * argument, const char * path);
+static char * _entryPath(const CompilationCache * compilationCache, const CompilationKey * compilationKey, const char * prefix, const char * suffix);
+static uint64_t _hash(const char * bytes, const size_t length, const uint64_t seed);
+static uint64_t _mergeRound(uint64_t accumulator, const uint64_t value);
+static char * _readFile(const char * path, size_t * length);
+static uint64_t _read32(const char * bytes);
+static uint64_t _read64(const char * bytes);
+static uint64_t _rotate(const uint64_t value, const unsigned int bits);
+static uint64_t _round(uint64_t accumulator, const uint64_t input);
+static bool _writeAll(const int fileDescriptor, const void * bytes, const size_t length);
+
+/**
+ * Adds a piece of input to a key. Each piece is hashed with the previous key
+ * as seed, so the key depends on the order and the boundaries of the pieces.
+ */
+static void _absorb(CompilationKey * compilationKey, const char * bytes, const size_t length) {
+	compilationKey->high = _hash(bytes, length, compilationKey->high);
+	compilationKey->low = _hash(bytes, length, compilationKey->low ^ _lowSeed);
+}
+
+/**
+ * Queues an import path found by the scanner, unless it was already found.
+ */
+static void _enqueueImport(void * argument, const char * path) {
+	ImportQueue * importQueue = argument;
+	if (!addToStringSet(importQueue->seenPaths, path)) {
+		return;
+	}
+	if (importQueue->count == importQueue->capacity) {
+		importQueue->capacity = importQueue->capacity == 0 ? 16 : 2 * importQueue->capacity;
+		importQueue->paths = realloc(importQueue->paths, importQueue->capacity * sizeof(char *));
+	}
+	importQueue->paths[importQueue->count++] = strdup(path);
+}
+
+/**
+ * The path of the entry of a key, with a prefix and a suffix around its name
+ * (for the temporary files). It uses heap-memory.
+ */
+static char * _entryPath(const CompilationCache * compilationCache, const CompilationKey * compilationKey, const char * prefix, const char * suffix) {
+	const size_t length = strlen(compilationCache->directory) + strlen(prefix) + KEY_DIGITS + strlen(suffix) + 2;
+	char * path = malloc(length);
+	snprintf(path, length, "%s/%s%016llx%016llx%s",
+		compilationCache->directory,
+		prefix,
+		(unsigned long long) compilationKey->high,
+		(unsigned long long) compilationKey->low,
+		suffix);
+	return path;
+}
+
+/**
+ * Hashes a sequence of bytes (see "XXH64"), 32 bytes per round.
+ *
+ * @see https://github.com/Cyan4973/xxHash/blob/dev/doc/xxhash_spec.md
+ */
+static uint64_t _hash(const char * bytes, const size_t length, const uint64_t seed) {
+	const char * end = bytes + length;
+	uint64_t hash;
+	if (32 <= length) {
+		uint64_t accumulators[4] = { seed + _prime1 + _prime2, seed + _prime2, seed, seed - _prime1 };
+		for (; bytes + 32 <= end; bytes += 32) {
+			for (unsigned int k = 0; k < 4; ++k) {
+				accumulators[k] = _round(accumulators[k], _read64(bytes + 8 * k));
+			}
+		}
+		hash = _rotate(accumulators[0], 1) + _rotate(accumulators[1], 7) + _rotate(accumulators[2], 12) + _rotate(accumulators[3], 18);
+		for (unsigned int k = 0; k < 4; ++k) {
+			hash = _mergeRound(hash, accumulators[k]);
+		}
+	}
+	else {
+		hash = seed + _prime5;
+	}
+	hash += length;
+	for (; bytes + 8 <= end; bytes += 8) {
+		hash ^= _round(0, _read64(bytes));
+		hash = _rotate(hash, 27) * _prime1 + _prime4;
+	}
+	if (bytes + 4 <= end) {
+		hash ^= _read32(bytes) * _prime1;
+		hash = _rotate(hash, 23) * _prime2 + _prime3;
+		bytes += 4;
+	}
+	for (; bytes < end; ++bytes) {
+		hash ^= (unsigned char) *bytes * _prime5;
+		hash = _rotate(hash, 11) * _prime1;
+	}
+	hash ^= hash >> 33;
+	hash *= _prime2;
+	hash ^= hash >> 29;
+	hash *= _prime3;
+	hash ^= hash >> 32;
+	return hash;
+}
+
+/**
+ * Merges an accumulator of "_hash" into the hash.
+ */
+static uint64_t _mergeRound(uint64_t accumulator, const uint64_t value) {
+	accumulator ^= _round(0, value);
+	return accumulator * _prime1 + _prime4;
+}
+
+/**
+ * Reads an entire file into heap-memory. Returns NULL if it cannot be read.
+ */
+static char * _readFile(const char * path, size_t * length) {
+	FILE * file = fopen(path, "rb");
+	if (file == NULL) {
+		return NULL;
+	}
+	size_t capacity = 4096;
+	char * content = malloc(capacity);
+	*length = 0;
+	size_t read = 0;
+	while (0 < (read = fread(content + *length, 1, capacity - *length, file))) {
+		*length += read;
+		if (*length == capacity) {
+			capacity *= 2;
+			content = realloc(content, capacity);
+		}
+	}
+	const bool failed = ferror(file);
+	fclose(file);
+	if (failed) {
+		free(content);
+		return NULL;
+	}
+	return content;
+}
+
+/**
+ * Reads 32 bits in the byte order of the host.
+ */
+static uint64_t _read32(const char * bytes) {
+	uint32_t value;
+	memcpy(&value, bytes, sizeof(uint32_t));
+	return value;
+}
+
+/**
+ * Reads 64 bits in the byte order of the host.
+ */
+static uint64_t _read64(const char * bytes) {
+	uint64_t value;
+	memcpy(&value, bytes, sizeof(uint64_t));
+	return value;
+}
+
+/**
+ * Rotates the bits of a value to the left.
+ */
+static uint64_t _rotate(const uint64_t value, const unsigned int bits) {
+	return (value << bits) | (value >> (64 - bits));
+}
+
+/**
+ * Mixes 64 bits of input into an accumulator of "_hash".
+ */
+static uint64_t _round(uint64_t accumulator, const uint64_t input) {
+	accumulator += input * _prime2;
+	accumulator = _rotate(accumulator, 31);
+	return accumulator * _prime1;
+}
+
+/**
+ * Writes every byte, even if the system writes them in many steps.
+ */
+static bool _writeAll(const int fileDescriptor, const void * bytes, const size_t length) {
+	const char * next = bytes;
+	size_t remaining = length;
+	while (0 < remaining) {
+		const ssize_t written = write(fileDescriptor, next, remaining);
+		if (written < 0 && errno == EINTR) {
+			continue;
+		}
+		if (written <= 0) {
+			return false;
+		}
+		next += written;
+		remaining -= written;
+	}
+	return true;
+}
+
+/* PUBLIC FUNCTIONS */
+
+CompilationKey computeCompilationKey(const char * configuration, const char * program, const size_t length) {
+	CompilationKey compilationKey = {
+		.high = 0,
+		.low = 0
+	};
+	_absorb(&compilationKey, configuration, strlen(configuration));
+	_absorb(&compilationKey, program, length);
+	ImportQueue importQueue = {
+		.paths = NULL,
+		.capacity = 0,
+		.count = 0,
+		.seenPaths = createStringSet()
+	};
+	ImportScanner importScanner = { 0 };
+	scanImports(&importScanner, program, length, _enqueueImport, &importQueue);
+	for (size_t k = 0; k < importQueue.count; ++k) {
+		char * path = importQueue.paths[k];
+		size_t contentLength = 0;
+		char * content = _readFile(path, &contentLength);
+		_absorb(&compilationKey, path, strlen(path) + 1);
+		if (content == NULL) {
+			// The compilation fails, so it's never stored:
+			_absorb(&compilationKey, "", 1);
+		}
+		else {
+			_absorb(&compilationKey, content, contentLength);
+			memset(&importScanner, 0, sizeof(ImportScanner));
+			scanImports(&importScanner, content, contentLength, _enqueueImport, &importQueue);
+			free(content);
+		}
+	}
+	for (size_t k = 0; k < importQueue.count; ++k) {
+		free(importQueue.paths[k]);
+	}
+	free(importQueue.paths);
+	destroyStringSet(importQueue.seenPaths);
+	return compilationKey;
+}
+
+CompilationCache * createCompilationCache(const char * directory) {
+	if (mkdir(directory, 0777) != 0 && errno != EEXIST) {
+		return NULL;
+	}
+	CompilationCache * compilationCache = calloc(1, sizeof(CompilationCache));
+	compilationCache->directory = strdup(directory);
+	return compilationCache;
+}
+
+void destroyCompilationCache(CompilationCache * compilationCache) {
+	if (compilationCache != NULL) {
+		free(compilationCache->directory);
+		free(compilationCache);
+	}
+}
+
+bool loadCompilation(const CompilationCache * compilationCache, const CompilationKey * compilationKey, ComputationResult * computationResult, char ** output, size_t * outputLength) {
+	char * path = _entryPath(compilationCache, compilationKey, "", "");
+	FILE * file = fopen(path, "rb");
+	free(path);
+	if (file == NULL) {
+		return false;
+	}
+	CompilationEntryHeader header;
+	bool loaded = fread(&header, sizeof(CompilationEntryHeader), 1, file) == 1
+		&& memcmp(header.magic, _entryMagic, sizeof(_entryMagic)) == 0
+		&& header.version == _entryVersion
+		&& header.keyHigh == compilationKey->high
+		&& header.keyLow == compilationKey->low;
+	char * content = NULL;
+	if (loaded) {
+		content = malloc(header.outputLength == 0 ? 1 : header.outputLength);
+		loaded = content != NULL
+			&& fread(content, 1, header.outputLength, file) == header.outputLength
+			&& fgetc(file) == EOF;
+	}
+	fclose(file);
+	if (!loaded) {
+		free(content);
+		return false;
+	}
+	computationResult->succeeded = header.succeeded != 0;
+	computationResult->value = header.value;
+	*output = content;
+	*outputLength = header.outputLength;
+	return true;
+}
+
+bool storeCompilation(const CompilationCache * compilationCache, const CompilationKey * compilationKey, const ComputationResult computationResult, const char * output, const size_t outputLength) {
+	char suffix[64];
+	snprintf(suffix, sizeof(suffix), ".%ld.%llu.tmp",
+		(long) getpid(),
+		(unsigned long long) atomic_fetch_add(&_temporarySequence, 1));
+	char * temporaryPath = _entryPath(compilationCache, compilationKey, ".", suffix);
+	const int fileDescriptor = open(temporaryPath, O_WRONLY | O_CREAT | O_EXCL, 0666);
+	if (fileDescriptor < 0) {
+		free(temporaryPath);
+		return false;
+	}
+	CompilationEntryHeader header;
+	memset(&header, 0, sizeof(CompilationEntryHeader));
+	memcpy(header.magic, _entryMagic, sizeof(_entryMagic));
+	header.version = _entryVersion;
+	header.keyHigh = compilationKey->high;
+	header.keyLow = compilationKey->low;
+	header.outputLength = outputLength;
+	header.value = computationResult.value;
+	header.succeeded = computationResult.succeeded;
+	bool stored = _writeAll(fileDescriptor, &header, sizeof(CompilationEntryHeader))
+		&& _writeAll(fileDescriptor, output, outputLength);
+	stored = close(fileDescriptor) == 0 && stored;
+	if (stored) {
+		char * path = _entryPath(compilationCache, compilationKey, "", "");
+		stored = rename(temporaryPath, path) == 0;
+		free(path);
+	}
+	if (!stored) {
+		unlink(temporaryPath);
+	}
+	free(temporaryPath);
+	return stored;
+}
@@ -0,0 +1,72 @@
+#ifndef COMPILATION_CACHE_HEADER
+#define COMPILATION_CACHE_HEADER
+
+#include "../../backend/domain-specific/Calculator.h"
+#include "../../frontend/lexical-analysis/ImportScanner.h"
+#include "../language/StringSet.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * A directory of compiled programs, shared by every compiler process that
+ * uses it. Each entry is a file named after the key of its compilation,
+ * which holds the computation result and the generated output. An entry is
+ * written to a temporary file first, and then renamed, so a reader finds
+ * either a complete entry or none at all, and concurrent writers of the same
+ * entry don't interfere (the last rename wins, with the same content).
+ */
+typedef struct {
+	char * directory;
+} CompilationCache;
+
+/**
+ * The 128-bit hash of everything that determines the output of a
+ * compilation: the configuration of the compiler, the program, and the path
+ * and content of every file that it imports (transitively).
+ */
+typedef struct {
+	uint64_t high;
+	uint64_t low;
+} CompilationKey;
+
+/**
+ * Computes the key of a program. Its imports are found and read in the same
+ * way as the lexical-analyzer does (relative to the working directory), and
+ * each one is hashed once, in the order they're found.
+ */
+CompilationKey computeCompilationKey(const char * configuration, const char * program, const size_t length);
+
+/**
+ * Opens the cache in a directory, creating it if needed. Returns NULL if the
+ * directory cannot be created.
+ */
+CompilationCache * createCompilationCache(const char * directory);
+
+/**
+ * Destroys a cache (its entries are kept in the directory).
+ */
+void destroyCompilationCache(CompilationCache * compilationCache);
+
+/**
+ * Loads the entry of a key. Returns false on a miss, or if the entry is
+ * incomplete or damaged. On a hit, the output is stored in heap-memory, and
+ * must be freed.
+ */
+bool loadCompilation(const CompilationCache * compilationCache, const CompilationKey * compilationKey, ComputationResult * computationResult, char ** output, size_t * outputLength);
+
+/**
+ * Stores the entry of a key atomically, replacing the previous one (if any).
+ * Returns false if it cannot be written.
+ */
+bool storeCompilation(const CompilationCache * compilationCache, const CompilationKey * compilationKey, const ComputationResult computationResult, const char * output, const size_t outputLength);
+
+#endif
@@ -0,0 +1,107 @@
+#include "ThreadPool.h"
+
+/* PRIVATE FUNCTIONS */
+
+static void * _work(void * argument);
+
+/**
+ * The loop of every thread: takes the next task from the queue and executes
+ * it, until the pool shuts down and the queue is empty.
+ */
+static void * _work(void * argument) {
+	ThreadPool * threadPool = argument;
+	pthread_mutex_lock(&threadPool->mutex);
+	while (true) {
+		while (threadPool->queueLength == 0 && !threadPool->shuttingDown) {
+			pthread_cond_wait(&threadPool->available, &threadPool->mutex);
+		}
+		if (threadPool->queueLength == 0) {
+			break;
+		}
+		TaskEntry entry = threadPool->queue[threadPool->queueHead];
+		threadPool->queueHead = (threadPool->queueHead + 1) % threadPool->queueCapacity;
+		--threadPool->queueLength;
+		++threadPool->runningTasks;
+		pthread_mutex_unlock(&threadPool->mutex);
+		entry.task(entry.argument);
+		pthread_mutex_lock(&threadPool->mutex);
+		--threadPool->runningTasks;
+		if (threadPool->queueLength == 0 && threadPool->runningTasks == 0) {
+			pthread_cond_broadcast(&threadPool->done);
+		}
+	}
+	pthread_mutex_unlock(&threadPool->mutex);
+	return NULL;
+}
+
+/* PUBLIC FUNCTIONS */
+
+ThreadPool * createThreadPool(const unsigned int threadCount) {
+	ThreadPool * threadPool = calloc(1, sizeof(ThreadPool));
+	pthread_cond_init(&threadPool->available, NULL);
+	pthread_cond_init(&threadPool->done, NULL);
+	pthread_mutex_init(&threadPool->mutex, NULL);
+	threadPool->queueCapacity = 16;
+	threadPool->queue = calloc(threadPool->queueCapacity, sizeof(TaskEntry));
+	threadPool->queueHead = 0;
+	threadPool->queueLength = 0;
+	threadPool->runningTasks = 0;
+	threadPool->shuttingDown = false;
+	threadPool->threadCount = threadCount;
+	if (threadPool->threadCount == 0) {
+		const long processors = sysconf(_SC_NPROCESSORS_ONLN);
+		threadPool->threadCount = processors < 1 ? 1 : processors;
+	}
+	threadPool->threads = calloc(threadPool->threadCount, sizeof(pthread_t));
+	for (unsigned int k = 0; k < threadPool->threadCount; ++k) {
+		pthread_create(&threadPool->threads[k], NULL, _work, threadPool);
+	}
+	return threadPool;
+}
+
+void destroyThreadPool(ThreadPool * threadPool) {
+	if (threadPool != NULL) {
+		pthread_mutex_lock(&threadPool->mutex);
+		threadPool->shuttingDown = true;
+		pthread_cond_broadcast(&threadPool->available);
+		pthread_mutex_unlock(&threadPool->mutex);
+		for (unsigned int k = 0; k < threadPool->threadCount; ++k) {
+			pthread_join(threadPool->threads[k], NULL);
+		}
+		pthread_cond_destroy(&threadPool->available);
+		pthread_cond_destroy(&threadPool->done);
+		pthread_mutex_destroy(&threadPool->mutex);
+		free(threadPool->queue);
+		free(threadPool->threads);
+		free(threadPool);
+	}
+}
+
+void submitToThreadPool(ThreadPool * threadPool, Task task, void * argument) {
+	pthread_mutex_lock(&threadPool->mutex);
+	if (threadPool->queueLength == threadPool->queueCapacity) {
+		const unsigned int capacity = 2 * threadPool->queueCapacity;
+		TaskEntry * queue = calloc(capacity, sizeof(TaskEntry));
+		for (unsigned int k = 0; k < threadPool->queueLength; ++k) {
+			queue[k] = threadPool->queue[(threadPool->queueHead + k) % threadPool->queueCapacity];
+		}
+		free(threadPool->queue);
+		threadPool->queue = queue;
+		threadPool->queueCapacity = capacity;
+		threadPool->queueHead = 0;
+	}
+	const unsigned int tail = (threadPool->queueHead + threadPool->queueLength) % threadPool->queueCapacity;
+	threadPool->queue[tail].task = task;
+	threadPool->queue[tail].argument = argument;
+	++threadPool->queueLength;
+	pthread_cond_signal(&threadPool->available);
+	pthread_mutex_unlock(&threadPool->mutex);
+}
+
+void waitForThreadPool(ThreadPool * threadPool) {
+	pthread_mutex_lock(&threadPool->mutex);
+	while (0 < threadPool->queueLength || 0 < threadPool->runningTasks) {
+		pthread_cond_wait(&threadPool->done, &threadPool->mutex);
+	}
+	pthread_mutex_unlock(&threadPool->mutex);
+}
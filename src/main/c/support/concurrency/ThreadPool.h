@@ -0,0 +1,62 @@
+#ifndef THREAD_POOL_HEADER
+#define THREAD_POOL_HEADER
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/**
+ * A fixed set of worker threads that execute the tasks submitted to a shared
+ * queue, in order of arrival.
+ *
+ * @see https://en.wikipedia.org/wiki/Thread_pool
+ */
+
+/**
+ * A unit of work. It receives the argument specified on submission.
+ */
+typedef void (* Task)(void * argument);
+
+typedef struct {
+	Task task;
+	void * argument;
+} TaskEntry;
+
+typedef struct {
+	pthread_cond_t available;
+	pthread_cond_t done;
+	pthread_mutex_t mutex;
+	TaskEntry * queue;
+	unsigned int queueCapacity;
+	unsigned int queueHead;
+	unsigned int queueLength;
+	unsigned int runningTasks;
+	bool shuttingDown;
+	pthread_t * threads;
+	unsigned int threadCount;
+} ThreadPool;
+
+/**
+ * Creates a new pool and starts its threads. If the amount of threads is
+ * zero, the pool uses one thread per online processor.
+ */
+ThreadPool * createThreadPool(const unsigned int threadCount);
+
+/**
+ * Waits for every submitted task to finish, stops the threads, and destroys
+ * the pool.
+ */
+void destroyThreadPool(ThreadPool * threadPool);
+
+/**
+ * Queues a new task. It returns immediately.
+ */
+void submitToThreadPool(ThreadPool * threadPool, Task task, void * argument);
+
+/**
+ * Blocks until every submitted task is finished.
+ */
+void waitForThreadPool(ThreadPool * threadPool);
+
+#endif
@@ -0,0 +1,302 @@
+#include "WorkStealingPool.h"
+
+/* MODULE INTERNAL STATE */
+
+/**
+ * The capacity of the deque of every worker (must be a power of 2). A worker
+ * only holds the tasks forked along its current path of nested forks, so it
+ * rarely needs more than a few.
+ */
+static const int64_t _dequeCapacity = 1 << 12;
+
+/**
+ * The amount of failed attempts to find a task before an idle worker goes to
+ * sleep, until a new task arrives.
+ */
+static const unsigned int _idleAttempts = 64;
+
+/**
+ * The worker executed by the current thread, if any.
+ */
+static __thread Worker * _currentWorker = NULL;
+
+/* PRIVATE FUNCTIONS */
+
+static void _execute(ForkJoinTask * forkJoinTask);
+static bool _hasForkedTasks(WorkStealingPool * workStealingPool);
+static ForkJoinTask * _popTask(WorkStealingDeque * deque);
+static bool _pushTask(WorkStealingDeque * deque, ForkJoinTask * forkJoinTask);
+static void _sleep(WorkStealingPool * workStealingPool);
+static ForkJoinTask * _stealTask(Worker * thief);
+static ForkJoinTask * _takeInjectedTask(WorkStealingPool * workStealingPool);
+static void * _work(void * argument);
+
+/**
+ * Executes a forked task, and publishes its completion (and its results) to
+ * the thread that joins it.
+ */
+static void _execute(ForkJoinTask * forkJoinTask) {
+	forkJoinTask->task(forkJoinTask->argument);
+	__atomic_store_n(&forkJoinTask->completed, true, __ATOMIC_RELEASE);
+}
+
+/**
+ * Whether the deque of any worker holds a task that can be stolen.
+ */
+static bool _hasForkedTasks(WorkStealingPool * workStealingPool) {
+	for (unsigned int k = 0; k < workStealingPool->workerCount; ++k) {
+		WorkStealingDeque * deque = &workStealingPool->workers[k].deque;
+		const int64_t top = __atomic_load_n(&deque->top, __ATOMIC_SEQ_CST);
+		if (top < __atomic_load_n(&deque->bottom, __ATOMIC_SEQ_CST)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * Takes the last task pushed to the bottom of the deque, racing against the
+ * thieves only when a single task remains. Only the owner can call it.
+ */
+static ForkJoinTask * _popTask(WorkStealingDeque * deque) {
+	const int64_t bottom = __atomic_load_n(&deque->bottom, __ATOMIC_RELAXED) - 1;
+	__atomic_store_n(&deque->bottom, bottom, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	int64_t top = __atomic_load_n(&deque->top, __ATOMIC_RELAXED);
+	ForkJoinTask * forkJoinTask = NULL;
+	if (top <= bottom) {
+		forkJoinTask = __atomic_load_n(&deque->tasks[bottom & (_dequeCapacity - 1)], __ATOMIC_RELAXED);
+		if (top == bottom) {
+			if (!__atomic_compare_exchange_n(&deque->top, &top, top + 1, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+				forkJoinTask = NULL;
+			}
+			__atomic_store_n(&deque->bottom, bottom + 1, __ATOMIC_RELAXED);
+		}
+	}
+	else {
+		__atomic_store_n(&deque->bottom, bottom + 1, __ATOMIC_RELAXED);
+	}
+	return forkJoinTask;
+}
+
+/**
+ * Pushes a task to the bottom of the deque, unless it's full. Only the owner
+ * can call it.
+ */
+static bool _pushTask(WorkStealingDeque * deque, ForkJoinTask * forkJoinTask) {
+	const int64_t bottom = __atomic_load_n(&deque->bottom, __ATOMIC_RELAXED);
+	const int64_t top = __atomic_load_n(&deque->top, __ATOMIC_ACQUIRE);
+	if (_dequeCapacity <= bottom - top) {
+		return false;
+	}
+	__atomic_store_n(&deque->tasks[bottom & (_dequeCapacity - 1)], forkJoinTask, __ATOMIC_RELAXED);
+	__atomic_store_n(&deque->bottom, bottom + 1, __ATOMIC_RELEASE);
+	return true;
+}
+
+/**
+ * Puts an idle worker to sleep, until a task is forked or invoked, or the pool
+ * shuts down. The worker announces itself before it looks at the deques for
+ * the last time, and a fork publishes its task before it looks for sleeping
+ * workers, so at least one of them sees the other (and the signal, sent under
+ * the lock, can't be missed).
+ */
+static void _sleep(WorkStealingPool * workStealingPool) {
+	pthread_mutex_lock(&workStealingPool->mutex);
+	__atomic_add_fetch(&workStealingPool->sleepingWorkers, 1, __ATOMIC_SEQ_CST);
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	if (workStealingPool->injectedCount == 0 && !workStealingPool->shuttingDown && !_hasForkedTasks(workStealingPool)) {
+		pthread_cond_wait(&workStealingPool->available, &workStealingPool->mutex);
+	}
+	__atomic_sub_fetch(&workStealingPool->sleepingWorkers, 1, __ATOMIC_SEQ_CST);
+	pthread_mutex_unlock(&workStealingPool->mutex);
+}
+
+/**
+ * Steals the first task at the top of the deque of another worker, starting
+ * with a random victim.
+ */
+static ForkJoinTask * _stealTask(Worker * thief) {
+	WorkStealingPool * workStealingPool = thief->pool;
+	const unsigned int start = rand_r(&thief->seed) % workStealingPool->workerCount;
+	for (unsigned int k = 0; k < workStealingPool->workerCount; ++k) {
+		Worker * victim = &workStealingPool->workers[(start + k) % workStealingPool->workerCount];
+		if (victim == thief) {
+			continue;
+		}
+		WorkStealingDeque * deque = &victim->deque;
+		int64_t top = __atomic_load_n(&deque->top, __ATOMIC_ACQUIRE);
+		__atomic_thread_fence(__ATOMIC_SEQ_CST);
+		const int64_t bottom = __atomic_load_n(&deque->bottom, __ATOMIC_ACQUIRE);
+		if (top < bottom) {
+			ForkJoinTask * forkJoinTask = __atomic_load_n(&deque->tasks[top & (_dequeCapacity - 1)], __ATOMIC_RELAXED);
+			if (__atomic_compare_exchange_n(&deque->top, &top, top + 1, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+				return forkJoinTask;
+			}
+		}
+	}
+	return NULL;
+}
+
+/**
+ * Takes the oldest task invoked from outside the pool, if any.
+ */
+static ForkJoinTask * _takeInjectedTask(WorkStealingPool * workStealingPool) {
+	if (__atomic_load_n(&workStealingPool->injectedCount, __ATOMIC_RELAXED) == 0) {
+		return NULL;
+	}
+	ForkJoinTask * forkJoinTask = NULL;
+	pthread_mutex_lock(&workStealingPool->mutex);
+	if (0 < workStealingPool->injectedCount) {
+		forkJoinTask = workStealingPool->injected[0];
+		__atomic_store_n(&workStealingPool->injectedCount, workStealingPool->injectedCount - 1, __ATOMIC_RELAXED);
+		memmove(workStealingPool->injected, workStealingPool->injected + 1, workStealingPool->injectedCount * sizeof(ForkJoinTask *));
+	}
+	pthread_mutex_unlock(&workStealingPool->mutex);
+	return forkJoinTask;
+}
+
+/**
+ * The loop of every worker: executes its own tasks first, then the stolen
+ * ones, and then the invoked ones, until the pool shuts down.
+ */
+static void * _work(void * argument) {
+	Worker * worker = argument;
+	WorkStealingPool * workStealingPool = worker->pool;
+	_currentWorker = worker;
+	unsigned int failedAttempts = 0;
+	while (!__atomic_load_n(&workStealingPool->shuttingDown, __ATOMIC_ACQUIRE)) {
+		ForkJoinTask * forkJoinTask = _popTask(&worker->deque);
+		if (forkJoinTask == NULL) {
+			forkJoinTask = _stealTask(worker);
+		}
+		if (forkJoinTask != NULL) {
+			_execute(forkJoinTask);
+			failedAttempts = 0;
+			continue;
+		}
+		forkJoinTask = _takeInjectedTask(workStealingPool);
+		if (forkJoinTask != NULL) {
+			forkJoinTask->task(forkJoinTask->argument);
+			pthread_mutex_lock(&workStealingPool->mutex);
+			forkJoinTask->completed = true;
+			pthread_cond_broadcast(&workStealingPool->completed);
+			pthread_mutex_unlock(&workStealingPool->mutex);
+			failedAttempts = 0;
+		}
+		else if (++failedAttempts < _idleAttempts) {
+			sched_yield();
+		}
+		else {
+			_sleep(workStealingPool);
+			failedAttempts = 0;
+		}
+	}
+	_currentWorker = NULL;
+	return NULL;
+}
+
+/* PUBLIC FUNCTIONS */
+
+WorkStealingPool * createWorkStealingPool(const unsigned int threadCount) {
+	WorkStealingPool * workStealingPool = calloc(1, sizeof(WorkStealingPool));
+	pthread_cond_init(&workStealingPool->available, NULL);
+	pthread_cond_init(&workStealingPool->completed, NULL);
+	pthread_mutex_init(&workStealingPool->mutex, NULL);
+	workStealingPool->injectedCapacity = 16;
+	workStealingPool->injected = calloc(workStealingPool->injectedCapacity, sizeof(ForkJoinTask *));
+	workStealingPool->injectedCount = 0;
+	workStealingPool->shuttingDown = false;
+	workStealingPool->sleepingWorkers = 0;
+	workStealingPool->workerCount = threadCount;
+	if (workStealingPool->workerCount == 0) {
+		const long processors = sysconf(_SC_NPROCESSORS_ONLN);
+		workStealingPool->workerCount = processors < 1 ? 1 : processors;
+	}
+	workStealingPool->workers = calloc(workStealingPool->workerCount, sizeof(Worker));
+	for (unsigned int k = 0; k < workStealingPool->workerCount; ++k) {
+		Worker * worker = &workStealingPool->workers[k];
+		worker->deque.tasks = calloc(_dequeCapacity, sizeof(ForkJoinTask *));
+		worker->pool = workStealingPool;
+		worker->seed = 1 + k;
+	}
+	for (unsigned int k = 0; k < workStealingPool->workerCount; ++k) {
+		pthread_create(&workStealingPool->workers[k].thread, NULL, _work, &workStealingPool->workers[k]);
+	}
+	return workStealingPool;
+}
+
+void destroyWorkStealingPool(WorkStealingPool * workStealingPool) {
+	if (workStealingPool != NULL) {
+		pthread_mutex_lock(&workStealingPool->mutex);
+		__atomic_store_n(&workStealingPool->shuttingDown, true, __ATOMIC_RELEASE);
+		pthread_cond_broadcast(&workStealingPool->available);
+		pthread_mutex_unlock(&workStealingPool->mutex);
+		for (unsigned int k = 0; k < workStealingPool->workerCount; ++k) {
+			pthread_join(workStealingPool->workers[k].thread, NULL);
+			free(workStealingPool->workers[k].deque.tasks);
+		}
+		pthread_cond_destroy(&workStealingPool->available);
+		pthread_cond_destroy(&workStealingPool->completed);
+		pthread_mutex_destroy(&workStealingPool->mutex);
+		free(workStealingPool->injected);
+		free(workStealingPool->workers);
+		free(workStealingPool);
+	}
+}
+
+void forkInWorkStealingPool(WorkStealingPool * workStealingPool, ForkJoinTask * forkJoinTask) {
+	forkJoinTask->completed = false;
+	Worker * worker = _currentWorker;
+	if (worker == NULL || worker->pool != workStealingPool || !_pushTask(&worker->deque, forkJoinTask)) {
+		_execute(forkJoinTask);
+	}
+	else {
+		__atomic_thread_fence(__ATOMIC_SEQ_CST);
+		if (0 < __atomic_load_n(&workStealingPool->sleepingWorkers, __ATOMIC_SEQ_CST)) {
+			pthread_mutex_lock(&workStealingPool->mutex);
+			pthread_cond_signal(&workStealingPool->available);
+			pthread_mutex_unlock(&workStealingPool->mutex);
+		}
+	}
+}
+
+void invokeInWorkStealingPool(WorkStealingPool * workStealingPool, ForkJoinTask * forkJoinTask) {
+	forkJoinTask->completed = false;
+	if (_currentWorker != NULL && _currentWorker->pool == workStealingPool) {
+		_execute(forkJoinTask);
+		return;
+	}
+	pthread_mutex_lock(&workStealingPool->mutex);
+	if (workStealingPool->injectedCount == workStealingPool->injectedCapacity) {
+		workStealingPool->injectedCapacity *= 2;
+		workStealingPool->injected = realloc(workStealingPool->injected, workStealingPool->injectedCapacity * sizeof(ForkJoinTask *));
+	}
+	workStealingPool->injected[workStealingPool->injectedCount] = forkJoinTask;
+	__atomic_store_n(&workStealingPool->injectedCount, workStealingPool->injectedCount + 1, __ATOMIC_RELAXED);
+	pthread_cond_signal(&workStealingPool->available);
+	while (!forkJoinTask->completed) {
+		pthread_cond_wait(&workStealingPool->completed, &workStealingPool->mutex);
+	}
+	pthread_mutex_unlock(&workStealingPool->mutex);
+}
+
+void joinInWorkStealingPool(WorkStealingPool * workStealingPool, ForkJoinTask * forkJoinTask) {
+	Worker * worker = _currentWorker;
+	if (worker == NULL || worker->pool != workStealingPool) {
+		// Outside a worker of the pool, the fork already executed the task:
+		return;
+	}
+	while (!__atomic_load_n(&forkJoinTask->completed, __ATOMIC_ACQUIRE)) {
+		ForkJoinTask * otherTask = _popTask(&worker->deque);
+		if (otherTask == NULL) {
+			otherTask = _stealTask(worker);
+		}
+		if (otherTask != NULL) {
+			_execute(otherTask);
+		}
+		else {
+			sched_yield();
+		}
+	}
+}
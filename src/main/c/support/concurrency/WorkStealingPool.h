@@ -0,0 +1,99 @@
+#ifndef WORK_STEALING_POOL_HEADER
+#define WORK_STEALING_POOL_HEADER
+
+#include "ThreadPool.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/**
+ * A fixed set of worker threads for fork/join parallelism. Every worker owns
+ * a double-ended queue: it pushes and pops its own forked tasks at the bottom
+ * (in LIFO order, so the most recent and smallest subproblem runs first),
+ * while the idle workers steal the oldest (and largest) ones from the top.
+ *
+ * A worker that joins a task which isn't finished yet doesn't block: it keeps
+ * executing its own tasks, or stealing others, until the task is done.
+ *
+ * @see https://en.wikipedia.org/wiki/Work_stealing
+ * @see https://doi.org/10.1145/1073970.1073974 (Chase & Lev, 2005)
+ * @see https://doi.org/10.1145/2442516.2442524 (Lê et al., 2013)
+ */
+
+/**
+ * A task that can be forked and later joined. Its argument usually holds both
+ * the input and the output of the task.
+ */
+typedef struct {
+	Task task;
+	void * argument;
+	bool completed;
+} ForkJoinTask;
+
+/**
+ * The bounded deque of a worker (see "Chase-Lev deque"). The owner accesses
+ * the bottom, and the thieves the top.
+ */
+typedef struct {
+	int64_t bottom;
+	ForkJoinTask ** tasks;
+	int64_t top;
+} WorkStealingDeque;
+
+typedef struct WorkStealingPool WorkStealingPool;
+
+typedef struct {
+	WorkStealingDeque deque;
+	WorkStealingPool * pool;
+	unsigned int seed;
+	pthread_t thread;
+} Worker;
+
+struct WorkStealingPool {
+	pthread_cond_t available;
+	pthread_cond_t completed;
+	ForkJoinTask ** injected;
+	unsigned int injectedCapacity;
+	unsigned int injectedCount;
+	pthread_mutex_t mutex;
+	bool shuttingDown;
+	unsigned int sleepingWorkers;
+	unsigned int workerCount;
+	Worker * workers;
+};
+
+/**
+ * Creates a new pool and starts its workers. If the amount of threads is
+ * zero, the pool uses one thread per online processor.
+ */
+WorkStealingPool * createWorkStealingPool(const unsigned int threadCount);
+
+/**
+ * Stops the workers, and destroys the pool. There must be no pending tasks.
+ */
+void destroyWorkStealingPool(WorkStealingPool * workStealingPool);
+
+/**
+ * Schedules a task to run in parallel with the caller, which must join it
+ * later. Outside a worker of the pool, or if the deque of the worker is full,
+ * the task is executed immediately instead.
+ */
+void forkInWorkStealingPool(WorkStealingPool * workStealingPool, ForkJoinTask * forkJoinTask);
+
+/**
+ * Executes a task in the pool, and blocks until it's finished (including the
+ * tasks it forks). Many threads outside the pool can invoke tasks at the same
+ * time; a worker of the pool executes it immediately.
+ */
+void invokeInWorkStealingPool(WorkStealingPool * workStealingPool, ForkJoinTask * forkJoinTask);
+
+/**
+ * Waits for a forked task to finish, executing other tasks meanwhile.
+ */
+void joinInWorkStealingPool(WorkStealingPool * workStealingPool, ForkJoinTask * forkJoinTask);
+
+#endif
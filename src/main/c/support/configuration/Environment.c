@@ -15,6 +15,31 @@ const bool getBooleanOrDefault(const char * name, const bool defaultValue) {
 	}
 }
 
+const long getIntegerOrDefault(const char * name, const long defaultValue) {
+	const char * value = getStringOrDefault(name, NULL);
+	if (value == NULL || value[0] == '\0') {
+		return defaultValue;
+	}
+	char * end = NULL;
+	const long integer = strtol(value, &end, 10);
+	if (*end != '\0') {
+		return defaultValue;
+	}
+	else {
+		return integer;
+	}
+}
+
+const char * getNonEmptyStringOrDefault(const char * name, const char * defaultValue) {
+	const char * value = getStringOrDefault(name, NULL);
+	if (value == NULL || value[0] == '\0') {
+		return defaultValue;
+	}
+	else {
+		return value;
+	}
+}
+
 const char * getStringOrDefault(const char * name, const char * defaultValue) {
 	const char * value = getenv(name);
 	if (value == NULL) {
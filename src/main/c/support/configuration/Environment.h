@@ -12,6 +12,20 @@
  */
 const bool getBooleanOrDefault(const char * name, const bool defaultValue);
 
+/**
+ * Analog to "getStringOrDefault", but parsing the string as a decimal integer.
+ * The default value is used when the variable is undefined, or when it's not
+ * a valid integer.
+ */
+const long getIntegerOrDefault(const char * name, const long defaultValue);
+
+/**
+ * Analog to "getStringOrDefault", but the default value is also used when the
+ * variable is defined as an empty string (e.g., an unset variable forwarded by
+ * Docker Compose).
+ */
+const char * getNonEmptyStringOrDefault(const char * name, const char * defaultValue);
+
 /**
  * Gets the value of an environment variable by name, or returns a default
  * value if the variable is undefined.
@@ -80,14 +80,13 @@ char * escape(const char * string) {
 		}
 	}
 	char * escapedString = calloc(length, sizeof(char));
-	char charToString[2] = { 0, 0 };
+	char * end = escapedString;
 	for (unsigned int k = 0; 0 < string[k]; ++k) {
 		if (iscntrl(string[k])) {
-			strcat(escapedString, _controlCharacterToEscapedString(string[k]));
+			end = stpcpy(end, _controlCharacterToEscapedString(string[k]));
 		}
 		else {
-			charToString[0] = string[k];
-			strcat(escapedString, charToString);
+			*end++ = string[k];
 		}
 	}
 	return escapedString;
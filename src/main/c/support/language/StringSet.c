@@ -0,0 +1,77 @@
+#include "StringSet.h"
+
+/* MODULE INTERNAL STATE */
+
+static const size_t _initialCapacity = 64;
+
+/* PRIVATE FUNCTIONS */
+
+static size_t _hashString(const char * string);
+
+/**
+ * Hashes a string (see "FNV-1a").
+ *
+ * @see https://en.wikipedia.org/wiki/Fowler%E2%80%93Noll%E2%80%93Vo_hash_function
+ */
+static size_t _hashString(const char * string) {
+	uint64_t hash = 14695981039346656037ULL;
+	for (const char * character = string; *character != '\0'; ++character) {
+		hash = (hash ^ (unsigned char) *character) * 1099511628211ULL;
+	}
+	return hash;
+}
+
+/* PUBLIC FUNCTIONS */
+
+bool addToStringSet(StringSet * stringSet, const char * string) {
+	if (2 * (stringSet->count + 1) > stringSet->capacity) {
+		const size_t capacity = 2 * stringSet->capacity;
+		char ** strings = calloc(capacity, sizeof(char *));
+		for (size_t k = 0; k < stringSet->capacity; ++k) {
+			if (stringSet->strings[k] != NULL) {
+				size_t slot = _hashString(stringSet->strings[k]) % capacity;
+				while (strings[slot] != NULL) {
+					slot = (slot + 1) % capacity;
+				}
+				strings[slot] = stringSet->strings[k];
+			}
+		}
+		free(stringSet->strings);
+		stringSet->strings = strings;
+		stringSet->capacity = capacity;
+	}
+	size_t slot = _hashString(string) % stringSet->capacity;
+	while (stringSet->strings[slot] != NULL) {
+		if (strcmp(stringSet->strings[slot], string) == 0) {
+			return false;
+		}
+		slot = (slot + 1) % stringSet->capacity;
+	}
+	stringSet->strings[slot] = strdup(string);
+	++stringSet->count;
+	return true;
+}
+
+void clearStringSet(StringSet * stringSet) {
+	for (size_t k = 0; k < stringSet->capacity; ++k) {
+		free(stringSet->strings[k]);
+		stringSet->strings[k] = NULL;
+	}
+	stringSet->count = 0;
+}
+
+StringSet * createStringSet() {
+	StringSet * stringSet = calloc(1, sizeof(StringSet));
+	stringSet->capacity = _initialCapacity;
+	stringSet->count = 0;
+	stringSet->strings = calloc(stringSet->capacity, sizeof(char *));
+	return stringSet;
+}
+
+void destroyStringSet(StringSet * stringSet) {
+	if (stringSet != NULL) {
+		clearStringSet(stringSet);
+		free(stringSet->strings);
+		free(stringSet);
+	}
+}
@@ -0,0 +1,43 @@
+#ifndef STRING_SET_HEADER
+#define STRING_SET_HEADER
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * A set of strings (copied in heap-memory), in a hash table with open
+ * addressing and linear probing. It's not thread-safe.
+ *
+ * @see https://en.wikipedia.org/wiki/Linear_probing
+ */
+typedef struct {
+	char ** strings;
+	size_t capacity;
+	size_t count;
+} StringSet;
+
+/**
+ * Adds a copy of a string to the set, doubling its capacity when it gets half
+ * full. Returns false if the string was already there.
+ */
+bool addToStringSet(StringSet * stringSet, const char * string);
+
+/**
+ * Removes every string of the set, but keeps its capacity.
+ */
+void clearStringSet(StringSet * stringSet);
+
+/**
+ * Creates a new empty set.
+ */
+StringSet * createStringSet();
+
+/**
+ * Destroys a set, and its strings.
+ */
+void destroyStringSet(StringSet * stringSet);
+
+#endif
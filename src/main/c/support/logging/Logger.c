@@ -1,17 +1,194 @@
 #include "Logger.h"
 
+/* MODULE INTERNAL STATE */
+
+/**
+ * The maximum length of a formatted record in asynchronous mode, including
+ * its context and the new-line. Longer messages are truncated.
+ */
+#define LOG_RECORD_LENGTH 512
+
+/**
+ * The default and the maximum amount of records of the ring, in asynchronous
+ * mode (every record takes LOG_RECORD_LENGTH bytes, and a bit more).
+ */
+#define LOG_DEFAULT_CAPACITY 4096
+#define LOG_MAXIMUM_CAPACITY (1 << 16)
+
+/**
+ * A slot of the ring buffer of the asynchronous mode. The sequence number
+ * tells whether the slot is free for a producer at some position, or if it
+ * holds a record ready for the drainer.
+ *
+ * @see https://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+ */
+typedef struct {
+	size_t sequence;
+	bool error;
+	unsigned short length;
+	char text[LOG_RECORD_LENGTH];
+} LogRecord;
+
+/**
+ * The asynchronous backend. Producers claim slots of the ring without locks,
+ * and a single background thread drains them to the streams. The backend
+ * starts with the first logger, and stops (after draining every record) with
+ * the last one.
+ */
+static bool _asynchronous = false;
+static size_t _capacity = 0;
+static size_t _dequeuePosition = 0;
+static size_t _droppedRecords = 0;
+static pthread_t _drainer;
+static pthread_cond_t _drainerCondition = PTHREAD_COND_INITIALIZER;
+static bool _drainerRunning = false;
+static size_t _enqueuePosition = 0;
+static size_t _flushedPosition = 0;
+static pthread_cond_t _flushedCondition = PTHREAD_COND_INITIALIZER;
+static bool _flushRequested = false;
+static unsigned int _loggers = 0;
+static pthread_mutex_t _mutex = PTHREAD_MUTEX_INITIALIZER;
+static LogRecord * _records = NULL;
+
 /* PRIVATE FUNCTIONS */
 
+static void * _drain(void * argument);
+static bool _drainRecords();
+static void _enqueueRecord(const Logger * logger, const LoggingLevel loggingLevel, const char * const format, va_list arguments);
+static void _flushRecords();
 static void _log(const Logger * logger, const LoggingLevel loggingLevel, const char * const format, va_list arguments);
 static LoggingLevel _loggingLevelFromString(const char * loggingLevel);
 static void _logInStream(FILE * const stream, const char * const format, va_list arguments);
+static void _startDrainer();
+static void _stopDrainer();
 static const char * _toContextString(const LoggingLevel loggingLevel);
 
+/**
+ * The background thread of the asynchronous mode. It drains the ring until
+ * the backend stops, and sleeps while there is nothing to drain, unless a
+ * producer requests a flush.
+ */
+static void * _drain(void * argument) {
+	bool running = true;
+	while (running) {
+		const bool drained = _drainRecords();
+		pthread_mutex_lock(&_mutex);
+		if (_flushRequested) {
+			_flushRequested = false;
+			__atomic_store_n(&_flushedPosition, __atomic_load_n(&_dequeuePosition, __ATOMIC_ACQUIRE), __ATOMIC_RELAXED);
+			pthread_cond_broadcast(&_flushedCondition);
+		}
+		else if (!drained && _drainerRunning) {
+			struct timespec deadline;
+			clock_gettime(CLOCK_REALTIME, &deadline);
+			deadline.tv_nsec += 1000000;
+			if (1000000000 <= deadline.tv_nsec) {
+				deadline.tv_sec += 1;
+				deadline.tv_nsec -= 1000000000;
+			}
+			pthread_cond_timedwait(&_drainerCondition, &_mutex, &deadline);
+		}
+		running = _drainerRunning;
+		pthread_mutex_unlock(&_mutex);
+	}
+	_drainRecords();
+	return NULL;
+}
+
+/**
+ * Writes every record published so far, and reports the records dropped
+ * because the ring was full. Returns true if it wrote anything.
+ */
+static bool _drainRecords() {
+	const size_t mask = _capacity - 1;
+	size_t position = __atomic_load_n(&_dequeuePosition, __ATOMIC_RELAXED);
+	bool drained = false;
+	while (true) {
+		LogRecord * record = &_records[position & mask];
+		if (__atomic_load_n(&record->sequence, __ATOMIC_ACQUIRE) != position + 1) {
+			break;
+		}
+		fwrite(record->text, sizeof(char), record->length, record->error ? stderr : stdout);
+		__atomic_store_n(&record->sequence, position + _capacity, __ATOMIC_RELEASE);
+		__atomic_store_n(&_dequeuePosition, ++position, __ATOMIC_RELEASE);
+		drained = true;
+	}
+	const size_t droppedRecords = __atomic_exchange_n(&_droppedRecords, 0, __ATOMIC_RELAXED);
+	if (0 < droppedRecords) {
+		fprintf(stderr, "%s[Logger] %zu records were dropped, because the log buffer was full.\n", _toContextString(WARNING), droppedRecords);
+		drained = true;
+	}
+	if (drained) {
+		fflush(stdout);
+		fflush(stderr);
+	}
+	return drained;
+}
+
+/**
+ * Formats a record into a free slot of the ring, without locks. If the ring
+ * is full, records below ERROR level are dropped (and counted); the others
+ * wait for the drainer to make room.
+ */
+static void _enqueueRecord(const Logger * logger, const LoggingLevel loggingLevel, const char * const format, va_list arguments) {
+	const size_t mask = _capacity - 1;
+	size_t position = __atomic_load_n(&_enqueuePosition, __ATOMIC_RELAXED);
+	LogRecord * record = NULL;
+	while (record == NULL) {
+		LogRecord * slot = &_records[position & mask];
+		const size_t sequence = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+		const ptrdiff_t difference = (ptrdiff_t) sequence - (ptrdiff_t) position;
+		if (difference == 0) {
+			if (__atomic_compare_exchange_n(&_enqueuePosition, &position, position + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+				record = slot;
+			}
+		}
+		else if (difference < 0 && loggingLevel < ERROR) {
+			__atomic_add_fetch(&_droppedRecords, 1, __ATOMIC_RELAXED);
+			return;
+		}
+		else {
+			if (difference < 0) {
+				sched_yield();
+			}
+			position = __atomic_load_n(&_enqueuePosition, __ATOMIC_RELAXED);
+		}
+	}
+	const int available = LOG_RECORD_LENGTH - 1;
+	int length = snprintf(record->text, available, "%s[%s] ", _toContextString(loggingLevel), logger->name);
+	if (0 <= length && length < available) {
+		const int messageLength = vsnprintf(record->text + length, available - length, format, arguments);
+		length = messageLength < 0 ? length : length + messageLength;
+	}
+	length = length < 0 ? 0 : (available <= length ? available - 1 : length);
+	record->text[length++] = '\n';
+	record->error = ERROR <= loggingLevel;
+	record->length = length;
+	__atomic_store_n(&record->sequence, position + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * Waits until every record published so far is written and flushed.
+ */
+static void _flushRecords() {
+	const size_t target = __atomic_load_n(&_enqueuePosition, __ATOMIC_ACQUIRE);
+	pthread_mutex_lock(&_mutex);
+	while (_drainerRunning && _flushedPosition < target) {
+		_flushRequested = true;
+		pthread_cond_signal(&_drainerCondition);
+		pthread_cond_wait(&_flushedCondition, &_mutex);
+	}
+	pthread_mutex_unlock(&_mutex);
+}
+
 /**
  * Logs a new message at the specified level, using a format string.
  */
 static void _log(const Logger * logger, const LoggingLevel loggingLevel, const char * const format, va_list arguments) {
-	if (logger->loggingLevel <= loggingLevel) {
+	if (logger->loggingLevel <= loggingLevel && _asynchronous) {
+		_enqueueRecord(logger, loggingLevel, format, arguments);
+	}
+	else if (logger->loggingLevel <= loggingLevel) {
 		const char * context = _toContextString(loggingLevel);
 		char * effectiveFormat = concatenate(6, context, "[", logger->name, "] ", format, "\n");
 		if (ERROR <= loggingLevel) {
@@ -46,6 +223,63 @@ static void _logInStream(FILE * const stream, const char * const format, va_list
 	vfprintf(stream, format, arguments);
 }
 
+/**
+ * Creates the ring and starts the drainer, if the asynchronous mode is
+ * active. Requires the lock.
+ */
+static void _startDrainer() {
+	_asynchronous = strcmp(getStringOrDefault("LOGGING_MODE", "SYNCHRONOUS"), "ASYNCHRONOUS") == 0;
+	if (!_asynchronous) {
+		return;
+	}
+	long requestedCapacity = getIntegerOrDefault("LOGGING_BUFFER_CAPACITY", LOG_DEFAULT_CAPACITY);
+	if (requestedCapacity < 0) {
+		requestedCapacity = LOG_DEFAULT_CAPACITY;
+	}
+	else if (LOG_MAXIMUM_CAPACITY < requestedCapacity) {
+		requestedCapacity = LOG_MAXIMUM_CAPACITY;
+	}
+	_capacity = 2;
+	while (_capacity < (size_t) requestedCapacity) {
+		_capacity *= 2;
+	}
+	_records = calloc(_capacity, sizeof(LogRecord));
+	if (_records == NULL) {
+		// Without a ring, every logger writes synchronously:
+		_asynchronous = false;
+		return;
+	}
+	for (size_t k = 0; k < _capacity; ++k) {
+		_records[k].sequence = k;
+	}
+	_dequeuePosition = 0;
+	_droppedRecords = 0;
+	_enqueuePosition = 0;
+	_flushedPosition = 0;
+	_flushRequested = false;
+	_drainerRunning = true;
+	pthread_create(&_drainer, NULL, _drain, NULL);
+}
+
+/**
+ * Stops the drainer after it writes every pending record, and destroys the
+ * ring. Requires the lock, and releases it while joining the drainer.
+ */
+static void _stopDrainer() {
+	if (!_asynchronous) {
+		return;
+	}
+	_drainerRunning = false;
+	pthread_cond_signal(&_drainerCondition);
+	pthread_cond_broadcast(&_flushedCondition);
+	pthread_mutex_unlock(&_mutex);
+	pthread_join(_drainer, NULL);
+	pthread_mutex_lock(&_mutex);
+	free(_records);
+	_records = NULL;
+	_asynchronous = false;
+}
+
 /**
  * Get the context string of the specified logging level.
  */
@@ -73,11 +307,24 @@ Logger * createLogger(char * name) {
 	logger->loggingLevel = _loggingLevelFromString(getStringOrDefault("LOGGING_LEVEL", "INFORMATION"));
 	logger->name = calloc(1 + strlen(name), sizeof(char));
 	strcpy(logger->name, name);
+	pthread_mutex_lock(&_mutex);
+	if (_loggers++ == 0) {
+		_startDrainer();
+	}
+	pthread_mutex_unlock(&_mutex);
 	return logger;
 }
 
 void destroyLogger(Logger * logger) {
 	if (logger != NULL) {
+		if (_asynchronous && __atomic_load_n(&_flushedPosition, __ATOMIC_RELAXED) < __atomic_load_n(&_enqueuePosition, __ATOMIC_RELAXED)) {
+			_flushRecords();
+		}
+		pthread_mutex_lock(&_mutex);
+		if (--_loggers == 0) {
+			_stopDrainer();
+		}
+		pthread_mutex_unlock(&_mutex);
 		if (logger->name != NULL) {
 			free(logger->name);
 		}
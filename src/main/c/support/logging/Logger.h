@@ -3,9 +3,14 @@
 
 #include "../configuration/Environment.h"
 #include "../language/String.h"
+#include <pthread.h>
+#include <sched.h>
 #include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <time.h>
 
 /**
  * Platform dependent macros.
@@ -78,11 +83,16 @@ typedef struct {
 /**
  * Creates a new logger with the specified name. That name will be visible in
  * every line you log with this object.
+ *
+ * With "LOGGING_MODE=ASYNCHRONOUS", the logs are formatted by the caller, but
+ * written by a background thread that starts with the first logger.
  */
 Logger * createLogger(char * name);
 
 /**
- * Destroy a logger and its resources.
+ * Destroy a logger and its resources. In asynchronous mode, it first waits
+ * until every pending log is written, so the module destructors never lose
+ * their last logs.
  */
 void destroyLogger(Logger * logger);
 
@@ -101,4 +111,36 @@ void logInformation(const Logger * logger, const char * const format, ...);
 /** Logs at WARNING level. */
 void logWarning(const Logger * logger, const char * const format, ...);
 
+/**
+ * The lowest level kept in the binary, fixed at build time (see the
+ * "MINIMUM_LOGGING_LEVEL" option in CMake). The logs below it are compiled
+ * out, together with their arguments.
+ */
+#ifndef MINIMUM_LOGGING_LEVEL
+#define MINIMUM_LOGGING_LEVEL ALL
+#endif
+
+/**
+ * Whether a logger shows the logs of the specified level. It's false at build
+ * time for the levels below the minimum. Use it to guard the work needed only
+ * by a visible log (e.g., escaping a lexeme).
+ */
+#define IS_LOGGING_ENABLED(logger, level) \
+	(MINIMUM_LOGGING_LEVEL <= (level) && (logger)->loggingLevel <= (level))
+
+/**
+ * Log at the specified level, but only if it's enabled. Unlike the functions
+ * above, the arguments are not evaluated at all if the log is not visible.
+ */
+#define LOG_CRITICAL(logger, ...) \
+	do { if (IS_LOGGING_ENABLED(logger, CRITICAL)) logCritical(logger, __VA_ARGS__); } while (0)
+#define LOG_DEBUGGING(logger, ...) \
+	do { if (IS_LOGGING_ENABLED(logger, DEBUGGING)) logDebugging(logger, __VA_ARGS__); } while (0)
+#define LOG_ERROR(logger, ...) \
+	do { if (IS_LOGGING_ENABLED(logger, ERROR)) logError(logger, __VA_ARGS__); } while (0)
+#define LOG_INFORMATION(logger, ...) \
+	do { if (IS_LOGGING_ENABLED(logger, INFORMATION)) logInformation(logger, __VA_ARGS__); } while (0)
+#define LOG_WARNING(logger, ...) \
+	do { if (IS_LOGGING_ENABLED(logger, WARNING)) logWarning(logger, __VA_ARGS__); } while (0)
+
 #endif
@@ -0,0 +1,82 @@
+#include "Arena.h"
+
+/* PRIVATE FUNCTIONS */
+
+static ArenaChunk * _createChunk(ArenaChunk * previous, const size_t capacityInBytes);
+static size_t _roundToAlignment(const size_t sizeInBytes);
+
+/**
+ * Requests a new chunk to the system, and links it to the previous one.
+ */
+static ArenaChunk * _createChunk(ArenaChunk * previous, const size_t capacityInBytes) {
+	ArenaChunk * chunk = malloc(sizeof(ArenaChunk) + capacityInBytes);
+	chunk->previous = previous;
+	chunk->capacityInBytes = capacityInBytes;
+	chunk->usedBytes = 0;
+	return chunk;
+}
+
+/**
+ * Rounds a size up, so every block returned by the arena is properly aligned
+ * for any type.
+ */
+static size_t _roundToAlignment(const size_t sizeInBytes) {
+	const size_t alignment = sizeof(long double);
+	return (sizeInBytes + alignment - 1) & ~(alignment - 1);
+}
+
+/* PUBLIC FUNCTIONS */
+
+void * allocateInArena(Arena * arena, const size_t sizeInBytes) {
+	const size_t effectiveSizeInBytes = _roundToAlignment(sizeInBytes);
+	ArenaChunk * chunk = arena->chunk;
+	if (chunk == NULL || chunk->capacityInBytes - chunk->usedBytes < effectiveSizeInBytes) {
+		const size_t capacityInBytes = arena->chunkSizeInBytes < effectiveSizeInBytes
+			? effectiveSizeInBytes
+			: arena->chunkSizeInBytes;
+		chunk = _createChunk(chunk, capacityInBytes);
+		arena->chunk = chunk;
+	}
+	void * block = ((char *) chunk->memory) + chunk->usedBytes;
+	chunk->usedBytes += effectiveSizeInBytes;
+	arena->allocatedBytes += effectiveSizeInBytes;
+	return memset(block, 0, effectiveSizeInBytes);
+}
+
+Arena * createArena(const size_t chunkSizeInBytes) {
+	Arena * arena = calloc(1, sizeof(Arena));
+	arena->allocatedBytes = 0;
+	arena->chunk = NULL;
+	arena->chunkSizeInBytes = _roundToAlignment(chunkSizeInBytes);
+	return arena;
+}
+
+void destroyArena(Arena * arena) {
+	if (arena != NULL) {
+		ArenaMark empty = {
+			.chunk = NULL,
+			.usedBytes = 0
+		};
+		rollbackArena(arena, empty);
+		free(arena);
+	}
+}
+
+ArenaMark markArena(const Arena * arena) {
+	ArenaMark mark = {
+		.chunk = arena->chunk,
+		.usedBytes = arena->chunk == NULL ? 0 : arena->chunk->usedBytes
+	};
+	return mark;
+}
+
+void rollbackArena(Arena * arena, const ArenaMark mark) {
+	while (arena->chunk != NULL && arena->chunk != mark.chunk) {
+		ArenaChunk * previous = arena->chunk->previous;
+		free(arena->chunk);
+		arena->chunk = previous;
+	}
+	if (arena->chunk != NULL) {
+		arena->chunk->usedBytes = mark.usedBytes;
+	}
+}
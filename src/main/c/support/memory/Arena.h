@@ -0,0 +1,70 @@
+#ifndef ARENA_HEADER
+#define ARENA_HEADER
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * A region-based (a.k.a. bump) allocator. It hands out memory from large
+ * chunks, so every allocation is a pointer increment, and releases all of its
+ * memory at once when destroyed, without walking the structures built on it.
+ *
+ * @see https://en.wikipedia.org/wiki/Region-based_memory_management
+ */
+
+typedef struct ArenaChunk ArenaChunk;
+
+struct ArenaChunk {
+	ArenaChunk * previous;
+	size_t capacityInBytes;
+	size_t usedBytes;
+	long double memory[];
+};
+
+typedef struct {
+	/**
+	 * The amount of bytes handed out so far (rollbacks don't subtract).
+	 */
+	size_t allocatedBytes;
+	ArenaChunk * chunk;
+	size_t chunkSizeInBytes;
+} Arena;
+
+/**
+ * A position inside an arena. Rolling back to a mark releases everything that
+ * was allocated after it.
+ */
+typedef struct {
+	ArenaChunk * chunk;
+	size_t usedBytes;
+} ArenaMark;
+
+/**
+ * Allocates a zero-initialized block of memory inside the arena. The block
+ * cannot be released individually.
+ */
+void * allocateInArena(Arena * arena, const size_t sizeInBytes);
+
+/**
+ * Creates a new arena that requests memory from the system in chunks of, at
+ * least, the specified size.
+ */
+Arena * createArena(const size_t chunkSizeInBytes);
+
+/**
+ * Destroys an arena and every block allocated inside it.
+ */
+void destroyArena(Arena * arena);
+
+/**
+ * Returns the current position of the arena.
+ */
+ArenaMark markArena(const Arena * arena);
+
+/**
+ * Releases every block allocated after the specified mark.
+ */
+void rollbackArena(Arena * arena, const ArenaMark mark);
+
+#endif
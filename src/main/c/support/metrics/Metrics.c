@@ -0,0 +1,108 @@
+#include "Metrics.h"
+
+/* PRIVATE FUNCTIONS */
+
+static int _formatPhase(char * buffer, const size_t capacity, const char * name, const PhaseMetrics * phaseMetrics);
+static int _formatString(char * buffer, const size_t capacity, const char * string);
+static double _secondsBetween(const struct timespec start, const struct timespec end);
+
+/**
+ * Formats the times of a phase as a JSON property.
+ */
+static int _formatPhase(char * buffer, const size_t capacity, const char * name, const PhaseMetrics * phaseMetrics) {
+	return snprintf(buffer, capacity, "\"%s\":{\"cpuTimeInSeconds\":%.9f,\"peakResidentSetSizeInKilobytes\":%ld,\"wallTimeInSeconds\":%.9f}",
+		name,
+		phaseMetrics->cpuTimeInSeconds,
+		phaseMetrics->peakResidentSetSizeInKilobytes,
+		phaseMetrics->wallTimeInSeconds);
+}
+
+/**
+ * Formats a string as a JSON value (or null), escaping what JSON requires.
+ */
+static int _formatString(char * buffer, const size_t capacity, const char * string) {
+	if (string == NULL) {
+		return snprintf(buffer, capacity, "null");
+	}
+	size_t length = 0;
+	buffer[length++] = '"';
+	for (const char * character = string; *character != '\0' && length + 8 < capacity; ++character) {
+		if (*character == '"' || *character == '\\') {
+			buffer[length++] = '\\';
+			buffer[length++] = *character;
+		}
+		else if ((unsigned char) *character < 0x20) {
+			length += snprintf(buffer + length, capacity - length, "\\u%04x", *character);
+		}
+		else {
+			buffer[length++] = *character;
+		}
+	}
+	buffer[length++] = '"';
+	buffer[length] = '\0';
+	return length;
+}
+
+/**
+ * The amount of seconds between two instants.
+ */
+static double _secondsBetween(const struct timespec start, const struct timespec end) {
+	return (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+/* PUBLIC FUNCTIONS */
+
+void startPhase(Metrics * metrics, const CompilationPhase phase) {
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &metrics->phases[phase].cpuStart);
+	clock_gettime(CLOCK_MONOTONIC, &metrics->phases[phase].wallStart);
+}
+
+void stopPhase(Metrics * metrics, const CompilationPhase phase) {
+	PhaseMetrics * phaseMetrics = &metrics->phases[phase];
+	struct timespec cpuEnd;
+	struct timespec wallEnd;
+	clock_gettime(CLOCK_MONOTONIC, &wallEnd);
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpuEnd);
+	phaseMetrics->cpuTimeInSeconds += _secondsBetween(phaseMetrics->cpuStart, cpuEnd);
+	phaseMetrics->wallTimeInSeconds += _secondsBetween(phaseMetrics->wallStart, wallEnd);
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) == 0) {
+		phaseMetrics->peakResidentSetSizeInKilobytes = usage.ru_maxrss;
+	}
+}
+
+bool writeMetrics(const Metrics * metrics, const char * program, const bool succeeded, const char * destination) {
+	char line[8192];
+	const size_t capacity = sizeof(line);
+	size_t length = snprintf(line, capacity, "{\"program\":");
+	length += _formatString(line + length, capacity / 2, program);
+	length += snprintf(line + length, capacity - length,
+		",\"succeeded\":%s,\"tokens\":%zu,\"nodes\":%zu,\"allocatedBytes\":%zu,\"maximumDepth\":%zu,\"rebalancedDepth\":%zu,\"outputBytes\":%zu,\"phases\":{",
+		succeeded ? "true" : "false",
+		metrics->tokens,
+		metrics->nodes,
+		metrics->allocatedBytes,
+		metrics->maximumDepth,
+		metrics->rebalancedDepth,
+		metrics->outputBytes);
+	length += _formatPhase(line + length, capacity - length, "syntacticAnalysis", &metrics->phases[SYNTACTIC_ANALYSIS_PHASE]);
+	line[length++] = ',';
+	length += _formatPhase(line + length, capacity - length, "rebalancing", &metrics->phases[REBALANCING_PHASE]);
+	line[length++] = ',';
+	length += _formatPhase(line + length, capacity - length, "computation", &metrics->phases[COMPUTATION_PHASE]);
+	line[length++] = ',';
+	length += _formatPhase(line + length, capacity - length, "generation", &metrics->phases[GENERATION_PHASE]);
+	line[length++] = ',';
+	length += _formatPhase(line + length, capacity - length, "teardown", &metrics->phases[TEARDOWN_PHASE]);
+	length += snprintf(line + length, capacity - length, "}}\n");
+	if (strcmp(destination, "stderr") == 0) {
+		return fwrite(line, sizeof(char), length, stderr) == length;
+	}
+	const int file = open(destination, O_WRONLY | O_APPEND | O_CREAT, 0644);
+	if (file < 0) {
+		return false;
+	}
+	const bool written = write(file, line, length) == (ssize_t) length;
+	close(file);
+	return written;
+}
@@ -0,0 +1,84 @@
+#ifndef METRICS_HEADER
+#define METRICS_HEADER
+
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+/**
+ * The measurements of a single compilation: the time spent in each phase, and
+ * a few counters filled by the modules while they work. They're reported as
+ * one JSON line per compilation, for capacity planning and regression alerts.
+ */
+
+typedef enum {
+	SYNTACTIC_ANALYSIS_PHASE,
+	REBALANCING_PHASE,
+	COMPUTATION_PHASE,
+	GENERATION_PHASE,
+	TEARDOWN_PHASE,
+	COMPILATION_PHASES
+} CompilationPhase;
+
+typedef struct {
+	/**
+	 * The CPU time of the compiling thread, and the monotonic wall time.
+	 */
+	double cpuTimeInSeconds;
+	double wallTimeInSeconds;
+
+	/**
+	 * The peak resident memory of the process when the phase ended (shared by
+	 * every compilation of the process, as in batch mode).
+	 */
+	long peakResidentSetSizeInKilobytes;
+	struct timespec cpuStart;
+	struct timespec wallStart;
+} PhaseMetrics;
+
+typedef struct {
+	size_t allocatedBytes;
+	size_t maximumDepth;
+
+	/**
+	 * The logical nodes of the AST, counted as in the flat layout (see
+	 * "BisonActions.c"), so the layouts are comparable. The memory they take
+	 * is in the allocated bytes.
+	 */
+	size_t nodes;
+	size_t outputBytes;
+	PhaseMetrics phases[COMPILATION_PHASES];
+
+	/**
+	 * The depth of the AST after the rebalancing pass, if it runs.
+	 */
+	size_t rebalancedDepth;
+	size_t tokens;
+} Metrics;
+
+/**
+ * Starts measuring the time of a phase.
+ */
+void startPhase(Metrics * metrics, const CompilationPhase phase);
+
+/**
+ * Stops measuring the time of a phase. A phase can be measured many times,
+ * and its times accumulate.
+ */
+void stopPhase(Metrics * metrics, const CompilationPhase phase);
+
+/**
+ * Writes the metrics as a single JSON line to the standard error (if the
+ * destination is "stderr"), or appends it to the file in that path. Each
+ * line is written at once, so many compilations can share the same file.
+ * The program is its path, or NULL for the standard input.
+ */
+bool writeMetrics(const Metrics * metrics, const char * program, const bool succeeded, const char * destination);
+
+#endif
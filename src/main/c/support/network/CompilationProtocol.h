@@ -0,0 +1,29 @@
+#ifndef COMPILATION_PROTOCOL_HEADER
+#define COMPILATION_PROTOCOL_HEADER
+
+/**
+ * The protocol of the compile server. A client sends one request for each
+ * connection, with a header line that is either:
+ *
+ *	FILE <path>\n			to compile the program stored in that path, or
+ *	TEXT <length>\n			followed by <length> bytes of program text.
+ *
+ * The server replies with a header line, "<status> <length>\n", where the
+ * status is SUCCEEDED or FAILED, followed by <length> bytes of output (the
+ * generated document, or the value in evaluate-only mode), and then closes
+ * the connection. A request that is malformed (e.g., a TEXT request with a
+ * negative length, or one longer than MAXIMUM_TEXT_LENGTH) is replied with
+ * FAILED and an empty output. So is a request that stalls: the server waits
+ * at most TRANSFER_TIMEOUT milliseconds for each part of a request (or of a
+ * response), so an idle client cannot hold a thread of the server.
+ */
+
+#define FAILED_RESPONSE "FAILED"
+#define FILE_REQUEST "FILE"
+#define MAXIMUM_HEADER_LENGTH 4096
+#define MAXIMUM_TEXT_LENGTH (1 << 28)
+#define SUCCEEDED_RESPONSE "SUCCEEDED"
+#define TEXT_REQUEST "TEXT"
+#define TRANSFER_TIMEOUT 10000
+
+#endif
@@ -0,0 +1,105 @@
+#include "Socket.h"
+
+/* PRIVATE FUNCTIONS */
+
+static bool _setAddress(struct sockaddr_un * address, const char * path);
+
+/**
+ * Fills the address of a socket in the file-system. Returns false if the path
+ * is too long.
+ */
+static bool _setAddress(struct sockaddr_un * address, const char * path) {
+	memset(address, 0, sizeof(struct sockaddr_un));
+	address->sun_family = AF_UNIX;
+	if (sizeof(address->sun_path) <= strlen(path)) {
+		return false;
+	}
+	strcpy(address->sun_path, path);
+	return true;
+}
+
+/* PUBLIC FUNCTIONS */
+
+int connectToUnixSocket(const char * path) {
+	struct sockaddr_un address;
+	if (!_setAddress(&address, path)) {
+		return -1;
+	}
+	const int socketDescriptor = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (socketDescriptor < 0) {
+		return -1;
+	}
+	if (connect(socketDescriptor, (struct sockaddr *) &address, sizeof(address)) != 0) {
+		close(socketDescriptor);
+		return -1;
+	}
+	return socketDescriptor;
+}
+
+int listenOnUnixSocket(const char * path, const int backlog) {
+	struct sockaddr_un address;
+	if (!_setAddress(&address, path)) {
+		return -1;
+	}
+	const int socketDescriptor = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (socketDescriptor < 0) {
+		return -1;
+	}
+	unlink(path);
+	if (bind(socketDescriptor, (struct sockaddr *) &address, sizeof(address)) != 0
+		|| listen(socketDescriptor, backlog) != 0) {
+		close(socketDescriptor);
+		return -1;
+	}
+	return socketDescriptor;
+}
+
+bool readFromSocket(const int socket, void * buffer, const size_t length) {
+	size_t offset = 0;
+	while (offset < length) {
+		const ssize_t received = recv(socket, ((char *) buffer) + offset, length - offset, 0);
+		if (0 < received) {
+			offset += received;
+		}
+		else if (received == 0 || errno != EINTR) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool readLineFromSocket(const int socket, char * buffer, const size_t capacity) {
+	for (size_t length = 0; length < capacity; ++length) {
+		if (!readFromSocket(socket, buffer + length, 1)) {
+			return false;
+		}
+		if (buffer[length] == '\n') {
+			buffer[length] = '\0';
+			return true;
+		}
+	}
+	return false;
+}
+
+bool setSocketTimeout(const int socket, const long timeoutInMilliseconds) {
+	const struct timeval timeout = {
+		.tv_sec = timeoutInMilliseconds / 1000,
+		.tv_usec = 1000 * (timeoutInMilliseconds % 1000)
+	};
+	return setsockopt(socket, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) == 0
+		&& setsockopt(socket, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout)) == 0;
+}
+
+bool writeToSocket(const int socket, const void * data, const size_t length) {
+	size_t offset = 0;
+	while (offset < length) {
+		const ssize_t sent = send(socket, ((const char *) data) + offset, length - offset, MSG_NOSIGNAL);
+		if (0 <= sent) {
+			offset += sent;
+		}
+		else if (errno != EINTR) {
+			return false;
+		}
+	}
+	return true;
+}
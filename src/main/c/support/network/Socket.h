@@ -0,0 +1,60 @@
+#ifndef SOCKET_HEADER
+#define SOCKET_HEADER
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+/**
+ * Thin helpers over local (Unix domain) stream sockets. Every transfer is
+ * complete: partial reads, partial writes and interruptions are retried.
+ *
+ * @see https://man7.org/linux/man-pages/man7/unix.7.html
+ */
+
+/**
+ * Connects to a server listening on the specified path. Returns the socket,
+ * or -1 if the connection fails.
+ */
+int connectToUnixSocket(const char * path);
+
+/**
+ * Creates a socket that listens on the specified path. A stale file in that
+ * path (e.g., left by a previous server that crashed) is removed. Returns the
+ * socket, or -1 if it cannot listen.
+ */
+int listenOnUnixSocket(const char * path, const int backlog);
+
+/**
+ * Reads exactly the specified amount of bytes. Returns false if the peer
+ * closes the connection before, or if the read fails.
+ */
+bool readFromSocket(const int socket, void * buffer, const size_t length);
+
+/**
+ * Reads a line, up to (and excluding) its new-line character, and stores it
+ * null-terminated. Returns false if the line doesn't fit in the buffer, or if
+ * the read fails.
+ */
+bool readLineFromSocket(const int socket, char * buffer, const size_t capacity);
+
+/**
+ * Limits the time that every read or write of a socket can wait for the
+ * peer. Once it expires, the transfer fails (with "errno" set to EAGAIN or
+ * EWOULDBLOCK). Returns false if the limit cannot be set.
+ */
+bool setSocketTimeout(const int socket, const long timeoutInMilliseconds);
+
+/**
+ * Writes exactly the specified amount of bytes. Returns false if the write
+ * fails (e.g., if the peer is gone).
+ */
+bool writeToSocket(const int socket, const void * data, const size_t length);
+
+#endif
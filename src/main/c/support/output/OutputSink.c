@@ -0,0 +1,106 @@
+#include "OutputSink.h"
+
+/* PRIVATE FUNCTIONS */
+
+static void _ensureCapacity(OutputSink * outputSink, const size_t additionalLength);
+static void _flushIfNeeded(OutputSink * outputSink);
+
+/**
+ * Grows the buffer, if needed, to fit the specified amount of extra bytes
+ * (plus a null-terminator, required by "vsnprintf").
+ */
+static void _ensureCapacity(OutputSink * outputSink, const size_t additionalLength) {
+	const size_t requiredCapacity = outputSink->length + additionalLength + 1;
+	if (outputSink->capacity < requiredCapacity) {
+		size_t capacity = outputSink->capacity == 0 ? 4096 : outputSink->capacity;
+		while (capacity < requiredCapacity) {
+			capacity *= 2;
+		}
+		outputSink->buffer = realloc(outputSink->buffer, capacity);
+		outputSink->capacity = capacity;
+	}
+}
+
+/**
+ * Flushes the sink if the pending bytes reached the threshold, or on every
+ * write if the sink was requested to.
+ */
+static void _flushIfNeeded(OutputSink * outputSink) {
+	if (outputSink->flushEveryLine || outputSink->flushThreshold <= outputSink->length) {
+		flushOutputSink(outputSink);
+	}
+}
+
+/* PUBLIC FUNCTIONS */
+
+OutputSink * createOutputSink(FILE * stream, const size_t flushThreshold, const bool flushEveryLine) {
+	OutputSink * outputSink = calloc(1, sizeof(OutputSink));
+	outputSink->buffer = NULL;
+	outputSink->capacity = 0;
+	outputSink->length = 0;
+	outputSink->flushThreshold = flushThreshold;
+	outputSink->flushEveryLine = flushEveryLine;
+	outputSink->stream = stream;
+	outputSink->writtenBytes = 0;
+	return outputSink;
+}
+
+void destroyOutputSink(OutputSink * outputSink) {
+	if (outputSink != NULL) {
+		flushOutputSink(outputSink);
+		if (outputSink->buffer != NULL) {
+			free(outputSink->buffer);
+			outputSink->buffer = NULL;
+		}
+		free(outputSink);
+	}
+}
+
+void flushOutputSink(OutputSink * outputSink) {
+	// Anything written to the stream through "stdio" goes first, to keep the order.
+	fflush(outputSink->stream);
+	const int fileDescriptor = fileno(outputSink->stream);
+	if (fileDescriptor < 0) {
+		// A stream without a file (e.g., a memory stream):
+		fwrite(outputSink->buffer, sizeof(char), outputSink->length, outputSink->stream);
+		outputSink->length = 0;
+		return;
+	}
+	size_t offset = 0;
+	while (offset < outputSink->length) {
+		const ssize_t written = write(fileDescriptor, outputSink->buffer + offset, outputSink->length - offset);
+		if (0 <= written) {
+			offset += written;
+		}
+		else if (errno != EINTR) {
+			break;
+		}
+	}
+	outputSink->length = 0;
+}
+
+void formatToOutputSink(OutputSink * outputSink, const char * const format, va_list arguments) {
+	va_list copy;
+	va_copy(copy, arguments);
+	const size_t available = outputSink->capacity - outputSink->length;
+	const int length = vsnprintf(outputSink->buffer + outputSink->length, available, format, copy);
+	va_end(copy);
+	if (length < 0) {
+		return;
+	}
+	if (available <= (size_t) length) {
+		_ensureCapacity(outputSink, length);
+		vsnprintf(outputSink->buffer + outputSink->length, length + 1, format, arguments);
+	}
+	outputSink->length += length;
+	outputSink->writtenBytes += length;
+	_flushIfNeeded(outputSink);
+}
+
+void writeToOutputSink(OutputSink * outputSink, const char * data, const size_t length) {
+	_ensureCapacity(outputSink, length);
+	memcpy(outputSink->buffer + outputSink->length, data, length);
+	outputSink->length += length;
+	outputSink->writtenBytes += length;
+	_flushIfNeeded(outputSink);
+}
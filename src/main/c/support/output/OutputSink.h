@@ -0,0 +1,57 @@
+#ifndef OUTPUT_SINK_HEADER
+#define OUTPUT_SINK_HEADER
+
+#include <errno.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/**
+ * A buffered destination for the generated output. The text is accumulated in
+ * a growable buffer, and handed to the underlying file with a single "write"
+ * system call once the buffer reaches the flush threshold, or when the sink
+ * is flushed or destroyed.
+ */
+typedef struct {
+	char * buffer;
+	size_t capacity;
+	size_t length;
+	size_t flushThreshold;
+	bool flushEveryLine;
+	FILE * stream;
+	size_t writtenBytes;
+} OutputSink;
+
+/**
+ * Creates a new sink over a stream. If "flushEveryLine" is true, every line is
+ * written as soon as it's complete, so the output is visible even close to a
+ * failure (useful while debugging, but much slower).
+ */
+OutputSink * createOutputSink(FILE * stream, const size_t flushThreshold, const bool flushEveryLine);
+
+/**
+ * Flushes and destroys a sink. The underlying stream is not closed.
+ */
+void destroyOutputSink(OutputSink * outputSink);
+
+/**
+ * Writes every pending byte of the sink to the underlying stream.
+ */
+void flushOutputSink(OutputSink * outputSink);
+
+/**
+ * Appends a formatted string to the sink.
+ *
+ * @see https://cplusplus.com/reference/cstdio/vsnprintf/
+ */
+void formatToOutputSink(OutputSink * outputSink, const char * const format, va_list arguments);
+
+/**
+ * Appends a block of bytes to the sink.
+ */
+void writeToOutputSink(OutputSink * outputSink, const char * data, const size_t length);
+
+#endif
@@ -1,16 +1,64 @@
 #ifndef COMPILER_STATE_HEADER
 #define COMPILER_STATE_HEADER
 
+#include "../memory/Arena.h"
+#include "../metrics/Metrics.h"
+#include <stdio.h>
+
 /**
  * The global state of the compiler. Should transport every data structure
  * needed across the different phases of a compilation.
  */
 typedef struct {
+	/**
+	 * The arena that owns every node of the AST. Releasing it drops the entire
+	 * tree at once.
+	 */
+	Arena * arena;
+
 	/**
 	 * The root node of the AST.
 	 */
 	void * abstractSyntaxtTree;
 
+	/**
+	 * The constant folder of the evaluate-only mode (see "Calculator.h"). When
+	 * present, the parser computes the value of the program in it, and builds
+	 * no AST at all.
+	 */
+	void * constantFolder;
+
+	/**
+	 * The flat table of the AST (see "FlatSyntaxTree.h"). When present, the
+	 * parser fills this table instead of building the root node above.
+	 */
+	void * flatSyntaxTree;
+
+	/**
+	 * The files imported so far (see "ImportCache.h"), so every file is lexed
+	 * once per compilation, however many times it's imported. It's NULL if
+	 * the cache is disabled (see "IMPORT_CACHE").
+	 */
+	void * importCache;
+
+	/**
+	 * The nodes built so far (see "NodeInterner.h"), so every structurally
+	 * equal node of the AST is built once, and shared. It's NULL if the
+	 * hash-consing is disabled (see "HASH_CONSING").
+	 */
+	void * nodeInterner;
+
+	/**
+	 * The measurements of this compilation, filled by every phase.
+	 */
+	Metrics metrics;
+
+	/**
+	 * The stream where the output of this compilation is written (e.g., the
+	 * standard output, or a file in batch mode).
+	 */
+	FILE * output;
+
 	/**
 	 * The computed value of the entire program (only for the calculator). You
 	 * should change or remove this field, or a random child will die, and it
@@ -3,16 +3,28 @@
 
 #include "../logging/Logger.h"
 #include "LexicalAnalyzer.h"
+#include <stdbool.h>
+#include <stddef.h>
 #include <stdio.h>
 
 /**
- * A lexical-analyzer input buffer.
+ * A lexical-analyzer input buffer. It either reads a file through "stdio" (in
+ * blocks of "bufferSizeInBytes"), or scans the file mapped in memory. In the
+ * latter case, "memory" is the mapping (with the two null sentinels required
+ * by Flex after the content), and "file" is NULL. Once pushed, the Flex
+ * buffer belongs to the scanner, which deletes it when it's popped. The end
+ * of the text already scanned for imports to prefetch is kept, so every block
+ * is scanned once (see "prefetchNextImports").
  */
 typedef struct {
 	FILE * file;
 	LexicalAnalyzer * lexicalAnalyzer;
 	unsigned int bufferSizeInBytes;
 	void * buffer;
+	char * memory;
+	size_t memorySizeInBytes;
+	const char * prefetchedEnd;
+	bool pushed;
 } InputBuffer;
 
 #endif
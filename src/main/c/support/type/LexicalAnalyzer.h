@@ -2,15 +2,40 @@
 #define LEXICAL_ANALYZER_HEADER
 
 #include "../logging/Logger.h"
+#include "CompilationStatus.h"
+#include "CompilerState.h"
+#include "SemanticValue.h"
+#include "Token.h"
+#include <stddef.h>
 
 /**
- * A lexical-analyzer and its internal state.
+ * A lexical-analyzer and its internal state. The token (and its semantic
+ * value) is a slot reused for every lexeme, because the parser copies the
+ * semantic value when the token is pushed. Flex carries the lexical-analyzer
+ * as its extra data ("yyextra"), so every action reaches the state of its own
+ * compilation, and the pending input buffer of an import (or the pending
+ * import, if its file was already lexed). The input buffers of the imports
+ * being scanned are stacked in the order they were pushed, on top of the
+ * input of the program, and the lexical-analyzer releases each one when its
+ * file ends. The end of the text of the program already scanned for imports
+ * to prefetch is kept as well (as in every imported input buffer).
  */
 typedef struct {
+	CompilerState * compilerState;
+	void ** importedInputBuffers;
+	size_t importedInputBufferCapacity;
+	size_t importedInputBufferCount;
+	void * importPrefetcher;
+	void * inputBuffer;
 	Logger * logger;
 	void * location;
 	void * parser;
+	CompilationStatus parserStatus;
+	Import * pendingImport;
+	const char * prefetchedEnd;
 	void * scanner;
+	SemanticValue semanticValue;
+	Token token;
 } LexicalAnalyzer;
 
 #endif
@@ -7,10 +7,11 @@
 
 /**
  * The unit of information to transfer between a lexical-analyzer and a
- * syntactic-analyzer.
+ * syntactic-analyzer. The lexeme is not a copy: it points to the text matched
+ * by Flex, so it's only valid until the next match.
  */
 typedef struct {
-	char * lexeme;
+	const char * lexeme;
 	FlexContext context;
 	SemanticValue * semanticValue;
 	TokenLabel label;